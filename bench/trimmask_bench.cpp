@@ -0,0 +1,238 @@
+// headless check and benchmark of trim_mask::flood_fill, compares the scanline
+// fill against a breadth-first reference on random masks for every wrapping
+// combination, traces a loop across the seam of a wrapped domain and times a
+// fill over a large mask
+//
+//     make trimmask_bench && ./bin/trimmask_bench
+#include <cmath>
+#include <queue>
+#include <random>
+#include <chrono>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+#include "trimmask.hpp"
+
+namespace {
+	using mini::trim_mask;
+
+	std::size_t reference_fill(trim_mask & mask, uint32_t x, uint32_t y, uint8_t value, bool wrap_x, bool wrap_y) {
+		const uint8_t target = mask.get(x, y);
+		if (target == value) {
+			return 0;
+		}
+
+		const uint32_t width = mask.get_width();
+		const uint32_t height = mask.get_height();
+
+		std::queue<std::pair<uint32_t, uint32_t>> queue;
+		std::size_t filled = 0;
+
+		mask.set(x, y, value);
+		queue.push({ x, y });
+
+		const auto visit = [&](int64_t nx, int64_t ny) {
+			if (nx < 0 || nx >= width) {
+				if (!wrap_x) {
+					return;
+				}
+
+				nx = (nx + width) % width;
+			}
+
+			if (ny < 0 || ny >= height) {
+				if (!wrap_y) {
+					return;
+				}
+
+				ny = (ny + height) % height;
+			}
+
+			if (mask.get(nx, ny) == target) {
+				mask.set(nx, ny, value);
+				queue.push({ static_cast<uint32_t>(nx), static_cast<uint32_t>(ny) });
+			}
+		};
+
+		while (!queue.empty()) {
+			const auto [cx, cy] = queue.front();
+			queue.pop();
+			filled++;
+
+			visit(int64_t(cx) - 1, cy);
+			visit(int64_t(cx) + 1, cy);
+			visit(cx, int64_t(cy) - 1);
+			visit(cx, int64_t(cy) + 1);
+		}
+
+		return filled;
+	}
+
+	void randomize(trim_mask & mask, std::mt19937 & random, float density) {
+		std::bernoulli_distribution wall(density);
+
+		for (uint32_t y = 0; y < mask.get_height(); ++y) {
+			for (uint32_t x = 0; x < mask.get_width(); ++x) {
+				mask.set(x, y, wall(random) ? 255 : 0);
+			}
+		}
+	}
+
+	bool same(const trim_mask & a, const trim_mask & b) {
+		for (uint32_t y = 0; y < a.get_height(); ++y) {
+			for (uint32_t x = 0; x < a.get_width(); ++x) {
+				if (a.get(x, y) != b.get(x, y)) {
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	int check(std::mt19937 & random) {
+		constexpr int masks_per_case = 200;
+		int failures = 0;
+
+		std::uniform_int_distribution<uint32_t> size(1, 150);
+		std::uniform_real_distribution<float> density(0.2f, 0.6f);
+
+		for (int wrap = 0; wrap < 4; ++wrap) {
+			const bool wrap_x = (wrap & 1) != 0;
+			const bool wrap_y = (wrap & 2) != 0;
+
+			for (int i = 0; i < masks_per_case; ++i) {
+				const uint32_t width = size(random);
+				const uint32_t height = size(random);
+
+				trim_mask scanline(width, height, 0);
+				randomize(scanline, random, density(random));
+
+				trim_mask reference(width, height, 0);
+				for (uint32_t y = 0; y < height; ++y) {
+					for (uint32_t x = 0; x < width; ++x) {
+						reference.set(x, y, scanline.get(x, y));
+					}
+				}
+
+				const uint32_t x = std::uniform_int_distribution<uint32_t>(0, width - 1)(random);
+				const uint32_t y = std::uniform_int_distribution<uint32_t>(0, height - 1)(random);
+
+				const auto filled = scanline.flood_fill(x, y, 127, wrap_x, wrap_y);
+				const auto expected = reference_fill(reference, x, y, 127, wrap_x, wrap_y);
+
+				if (filled != expected || !same(scanline, reference)) {
+					std::cerr << "mismatch: " << width << "x" << height << " seed (" << x << ", " << y
+						<< ") wrap " << wrap_x << wrap_y << ", filled " << filled << " expected " << expected << std::endl;
+					failures++;
+				}
+			}
+		}
+
+		return failures;
+	}
+
+	// a circle around the seam at u = 0 traced by steps like trim_directions,
+	// the parameters leave [0, 1] on the left, filling its inside must reach
+	// both sides of the seam and leave the rest of the domain alone
+	int check_seam() {
+		constexpr uint32_t width = 256, height = 128;
+		constexpr int steps = 720;
+		constexpr float radius = 0.2f;
+
+		trim_mask mask(width, height, 255);
+		int failures = 0;
+
+		float u = radius, v = 0.5f;
+		for (int i = 1; i <= steps; ++i) {
+			const float angle = 2.0f * 3.14159265f * static_cast<float>(i) / steps;
+			const float next_u = radius * std::cos(angle);
+			const float next_v = 0.5f + 0.5f * radius * std::sin(angle);
+
+			mask.draw_uv_line(u, v, next_u, next_v, 128, true, false);
+			u = next_u;
+			v = next_v;
+		}
+
+		// the curve must not have been pushed onto the border column
+		std::size_t border = 0;
+		for (uint32_t y = 0; y < height; ++y) {
+			border += (mask.get(0, y) == 128) ? 1 : 0;
+		}
+
+		if (border > 4) {
+			std::cerr << "seam: " << border << " curve texels on the border column" << std::endl;
+			failures++;
+		}
+
+		const auto filled = mask.flood_fill(4, height / 2, 0, true, false);
+
+		if (mask.get(width - 4, height / 2) != 0) {
+			std::cerr << "seam: inside of the loop is not connected across the seam" << std::endl;
+			failures++;
+		}
+
+		if (mask.get(width / 2, height / 2) != 255 || filled > width * height / 4) {
+			std::cerr << "seam: fill leaked out of the loop, " << filled << " texels" << std::endl;
+			failures++;
+		}
+
+		// a jump across the seam is drawn the short way
+		trim_mask jump(width, height, 255);
+		jump.draw_uv_line(0.99f, 0.5f, 0.01f, 0.5f, 128, true, false);
+
+		std::size_t drawn = 0;
+		for (uint32_t x = 0; x < width; ++x) {
+			drawn += (jump.get(x, height / 2) == 128) ? 1 : 0;
+		}
+
+		if (drawn > 8) {
+			std::cerr << "seam: jump across the seam drew " << drawn << " texels" << std::endl;
+			failures++;
+		}
+
+		return failures;
+	}
+
+	void benchmark(std::mt19937 & random) {
+		constexpr uint32_t size = 2048;
+		constexpr int runs = 5;
+
+		double best = 0.0;
+		std::size_t filled = 0;
+
+		for (int run = 0; run < runs; ++run) {
+			trim_mask mask(size, size, 0);
+
+			// sparse walls so that the region is large and ragged
+			randomize(mask, random, 0.1f);
+			mask.set(size / 2, size / 2, 0);
+
+			const auto start = std::chrono::steady_clock::now();
+			filled = mask.flood_fill(size / 2, size / 2, 127, true, true);
+			const auto end = std::chrono::steady_clock::now();
+
+			const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+			best = (run == 0) ? ms : std::min(best, ms);
+		}
+
+		std::cout << "fill " << size << "x" << size << ": " << filled << " texels, best of "
+			<< runs << ": " << best << " ms" << std::endl;
+	}
+}
+
+int main() {
+	std::mt19937 random(1234);
+
+	const int reference_failures = check(random);
+	std::cout << "reference check: " << (reference_failures == 0 ? "ok" : "FAILED") << std::endl;
+
+	const int seam_failures = check_seam();
+	std::cout << "seam check: " << (seam_failures == 0 ? "ok" : "FAILED") << std::endl;
+
+	const int failures = reference_failures + seam_failures;
+
+	benchmark(random);
+	return failures == 0 ? 0 : 1;
+}
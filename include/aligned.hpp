@@ -0,0 +1,42 @@
+#pragma once
+#include <new>
+#include <vector>
+#include <cstddef>
+
+namespace mini {
+	// allocator for containers whose storage has to start on a given boundary,
+	// e.g. a cache line so that vector loads never straddle two lines
+	template<typename T, std::size_t Alignment> class aligned_allocator {
+		static_assert(Alignment >= alignof(T), "alignment is weaker than the type requires");
+
+		public:
+			using value_type = T;
+
+			template<typename U> struct rebind {
+				using other = aligned_allocator<U, Alignment>;
+			};
+
+			aligned_allocator() noexcept = default;
+			template<typename U> aligned_allocator(const aligned_allocator<U, Alignment> &) noexcept { }
+
+			T * allocate(std::size_t count) {
+				return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+			}
+
+			void deallocate(T * ptr, std::size_t) noexcept {
+				::operator delete(ptr, std::align_val_t(Alignment));
+			}
+	};
+
+	template<typename T, typename U, std::size_t Alignment>
+	bool operator==(const aligned_allocator<T, Alignment> &, const aligned_allocator<U, Alignment> &) {
+		return true;
+	}
+
+	template<typename T, typename U, std::size_t Alignment>
+	bool operator!=(const aligned_allocator<T, Alignment> &, const aligned_allocator<U, Alignment> &) {
+		return false;
+	}
+
+	template<typename T, std::size_t Alignment = 64> using aligned_vector = std::vector<T, aligned_allocator<T, Alignment>>;
+}
\ No newline at end of file
@@ -8,12 +8,17 @@
 #include "grid.hpp"
 #include "object.hpp"
 #include "billboard.hpp"
+#include "pointcloud.hpp"
 #include "tool.hpp"
 #include "factory.hpp"
 #include "store.hpp"
 #include "anaglyph.hpp"
 #include "sprite.hpp"
 #include "gizmo.hpp"
+#include "objstore.hpp"
+#include "pickindex.hpp"
+#include "saver.hpp"
+#include "journal.hpp"
 
 namespace mini {
 	class application : public app_window, public scene_controller_base {
@@ -23,6 +28,8 @@ namespace mini {
 				std::string name, tmp_name;
 				bool selected;
 				bool destroy;
+				bool indexed;
+				object_handle_t handle;
 
 				object_wrapper_t (std::shared_ptr<scene_obj_t> o, const std::string & name);
 			};
@@ -96,8 +103,21 @@ namespace mini {
 			std::shared_ptr<resource_store> m_store;
 			std::shared_ptr<object_factory> m_factory;
 
-			std::vector<std::shared_ptr<object_wrapper_t>> m_objects;
-			std::unordered_map<uint64_t, std::weak_ptr<object_wrapper_t>> m_id_cache;
+			// all points are drawn at once, declared before the objects so it outlives them
+			std::shared_ptr<point_cloud> m_point_cloud;
+
+			// scene objects together with their id and name indexes
+			object_store<std::shared_ptr<object_wrapper_t>> m_objects;
+
+			// pick points of the objects that can be selected in the viewport
+			pick_index m_pick_index;
+
+			// writes saves in the background, joined before the scene goes away
+			scene_saver m_saver;
+
+			// autosave of the edits since the last flush, recovered after a crash
+			scene_journal m_journal;
+			float m_autosave_time;
 
 			// gizmos etc
 			std::shared_ptr<billboard_object> m_cursor_object, m_origin_object;
@@ -123,6 +143,7 @@ namespace mini {
 
 			// object creation tool
 			bool m_show_creator;
+			bool m_show_profiler;
 
 			int m_last_vp_width, m_last_vp_height;
 			bool m_viewport_focus, m_mouse_in_viewport;
@@ -144,10 +165,6 @@ namespace mini {
 			// gizmos
 			std::shared_ptr<gizmo> m_gizmo;
 
-			// name cache
-			std::unordered_map<uint64_t, std::string> m_name_cache;
-			std::unordered_set<std::string> m_taken_names;
-
 		public:
 			// api for tools
 			float get_cam_yaw () const;
@@ -192,6 +209,7 @@ namespace mini {
 			virtual const video_mode_t & get_video_mode () const override;
 
 			virtual bool get_show_points () const override;
+			virtual std::shared_ptr<point_cloud> get_point_cloud () const override;
 
 			app_context & get_context ();
 			std::shared_ptr<scene_obj_t> get_selection ();
@@ -217,6 +235,8 @@ namespace mini {
 			virtual void t_on_key_event (int key, int scancode, int action, int mods) override;
 			virtual void t_on_scroll (double offset_x, double offset_y) override;
 			virtual void t_on_resize (int width, int height) override;
+			virtual void t_on_object_moved (scene_obj_t & object) override;
+			virtual void t_on_object_changed (scene_obj_t & object) override;
 
 		private:
 			bool m_handle_gizmo_action ();
@@ -235,6 +255,7 @@ namespace mini {
 			void m_draw_object_options ();
 			void m_draw_group_options ();
 			void m_draw_object_creator ();
+			void m_draw_profiler ();
 			void m_draw_viewport ();
 
 			// object management
@@ -246,11 +267,14 @@ namespace mini {
 			void m_fillin_selection ();
 			void m_find_intersection();
 			void m_find_intersection_cursor();
+			void m_find_intersection_all();
 			void m_debug_surfaces();
 
 			// selection methods
 			void m_begin_box_select ();
 			void m_end_box_select ();
+			pick_index::query_t m_get_pick_query () const;
+			gizmo & m_get_gizmo ();
 			void m_mark_object (std::shared_ptr<object_wrapper_t> object_wrapper);
 			void m_select_object (std::shared_ptr<object_wrapper_t> object_wrapper);
 			void m_group_select_add (std::shared_ptr<object_wrapper_t> object_wrapper);
@@ -259,12 +283,15 @@ namespace mini {
 			void m_alt_select (std::shared_ptr<object_wrapper_t> object_wrapper);
 
 			// serialize/deserialize
-			bool m_serialize_scene (std::string & serialized) const;
+			std::shared_ptr<const scene_snapshot> m_take_snapshot () const;
+			scene_journal::object_list_t m_get_scene_objects () const;
+			void m_add_loaded_objects (scene_deserializer & deserializer);
 			bool m_deserialize_scene (const std::string & data);
 
 			void m_new_project ();
 			void m_save_scene_as ();
 			void m_save_scene ();
 			void m_load_scene ();
+			void m_recover_scene ();
 	};
 }
\ No newline at end of file
@@ -153,6 +153,7 @@ namespace mini {
 
 			virtual void t_on_object_created (std::shared_ptr<scene_obj_t> object) override;
 			virtual void t_on_object_deleted (std::shared_ptr<scene_obj_t> object) override;
+			virtual void t_on_objects_deleted (const scene_controller_base::object_batch_t & objects) override;
 
 			virtual void t_rebuild_curve () = 0;
 	};
@@ -30,5 +30,6 @@ namespace mini {
 			billboard_object & operator= (const billboard_object &) = delete;
 
 			virtual void render (app_context & context, const glm::mat4x4 & world_matrix) const override;
+			virtual render_key_t get_render_key () const override;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,181 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+#include <glm/glm.hpp>
+
+namespace mini {
+	constexpr uint32_t binary_scene_magic = 0x4253474d; // "MGSB"
+	constexpr uint32_t binary_scene_version = 1;
+
+	// index of a missing entry in the string table
+	constexpr uint32_t binary_no_string = 0xffffffffu;
+
+	// binary scene container, every table is a flat array of fixed size little
+	// endian records so a mapped file is used in place without parsing, names and
+	// every member the tables do not cover are kept in the string table (the latter
+	// as cbor) so the format converts to and from the json scene without loss
+	struct binary_section_t {
+		uint64_t offset;
+		uint64_t count;
+	};
+
+	enum binary_scene_flags_t : uint32_t {
+		binary_scene_has_points = 1 << 0,
+		binary_scene_has_geometry = 1 << 1
+	};
+
+	struct binary_scene_header_t {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t flags;
+		uint32_t extra;
+
+		binary_section_t points;
+		binary_section_t objects;
+		binary_section_t surfaces;
+		binary_section_t patches;
+		binary_section_t string_offsets;
+		binary_section_t string_data;
+	};
+
+	struct binary_point_t {
+		int32_t id;
+		float position[3];
+		uint32_t name;
+		uint32_t extra;
+	};
+
+	enum binary_object_kind_t : uint32_t {
+		binary_object_generic = 0,
+		binary_object_surface = 1
+	};
+
+	// geometry in file order, generic objects are stored whole as cbor
+	struct binary_object_t {
+		uint32_t kind;
+		uint32_t index;
+	};
+
+	enum binary_surface_flags_t : uint32_t {
+		binary_surface_has_wrapping = 1 << 0,
+		binary_surface_u_wrapped = 1 << 1,
+		binary_surface_v_wrapped = 1 << 2
+	};
+
+	struct binary_surface_t {
+		int32_t id;
+		uint32_t type;
+		uint32_t name;
+		uint32_t extra;
+		uint32_t patches_x;
+		uint32_t patches_y;
+		uint32_t flags;
+		uint32_t first_patch;
+		uint32_t num_patches;
+	};
+
+	struct binary_patch_t {
+		int32_t id;
+		uint32_t type;
+		uint32_t name;
+		uint32_t extra;
+		int32_t points[16];
+	};
+
+	class binary_scene_writer {
+		private:
+			std::vector<binary_point_t> m_points;
+			std::vector<binary_object_t> m_objects;
+			std::vector<binary_surface_t> m_surfaces;
+			std::vector<binary_patch_t> m_patches;
+
+			std::vector<uint64_t> m_string_offsets;
+			std::string m_string_data;
+			std::unordered_map<std::string, uint32_t> m_string_index;
+
+			uint32_t m_flags;
+			uint32_t m_extra;
+
+		public:
+			binary_scene_writer();
+
+			binary_scene_writer(const binary_scene_writer &) = delete;
+			binary_scene_writer & operator=(const binary_scene_writer &) = delete;
+
+			// converts a whole json scene, throws when a point cannot be stored
+			static std::string from_json(const nlohmann::json & scene);
+
+			void reserve_points(std::size_t count);
+
+			void add_point(int32_t id, const glm::vec3 & position, const std::string & name);
+			void add_point(const nlohmann::json & point);
+
+			// surfaces go to the patch tables, everything else is kept as it is
+			void add_object(const nlohmann::json & object);
+
+			std::string get_data() const;
+
+		private:
+			uint32_t m_add_string(const std::string & value);
+			uint32_t m_add_extra(const nlohmann::json & members);
+			bool m_add_surface(const nlohmann::json & object);
+	};
+
+	class binary_scene_reader {
+		private:
+			struct mapping_t;
+
+			std::unique_ptr<mapping_t> m_mapping;
+			const uint8_t * m_data;
+			std::size_t m_size;
+
+			const binary_scene_header_t * m_header;
+			const binary_point_t * m_points;
+			const binary_object_t * m_objects;
+			const binary_surface_t * m_surfaces;
+			const binary_patch_t * m_patches;
+			const uint64_t * m_string_offsets;
+			const char * m_string_data;
+
+		public:
+			binary_scene_reader();
+			~binary_scene_reader();
+
+			binary_scene_reader(const binary_scene_reader &) = delete;
+			binary_scene_reader & operator=(const binary_scene_reader &) = delete;
+
+			static bool is_binary_scene(const std::string & path);
+
+			// maps the file and validates all tables, throws on a malformed file
+			void open(const std::string & path);
+			void close();
+
+			std::size_t get_num_points() const;
+			std::size_t get_num_objects() const;
+
+			const binary_point_t & get_point(std::size_t index) const;
+			const binary_object_t & get_object(std::size_t index) const;
+			const binary_surface_t & get_surface(uint32_t index) const;
+			const binary_patch_t & get_patch(uint32_t index) const;
+
+			bool has_string(uint32_t index) const;
+			std::string_view get_string(uint32_t index) const;
+
+			// decoded members of a cbor entry, an empty object for binary_no_string
+			nlohmann::json get_extra(uint32_t index) const;
+
+			nlohmann::json get_point_json(std::size_t index) const;
+			nlohmann::json get_object_json(std::size_t index) const;
+			nlohmann::json to_json() const;
+
+		private:
+			void m_validate();
+			nlohmann::json m_get_surface_json(const binary_surface_t & surface) const;
+	};
+}
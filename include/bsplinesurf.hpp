@@ -66,11 +66,15 @@ namespace mini {
 			virtual glm::vec3 ddu(float u, float v) const override;
 			virtual glm::vec3 ddv(float u, float v) const override;
 
+			// batched evaluation
+			virtual void evaluate(const float * u, const float * v, std::size_t count, surface_samples & out) const override;
+
 			virtual bool is_u_wrapped() const;
 			virtual bool is_v_wrapped() const;
 
 			virtual bool is_trimmable() const override;
 			virtual trimmable_surface_domain& get_trimmable_domain() override;
+			virtual const patch_bvh* get_bvh() const override;
 
 		protected:
 			virtual void t_calc_idx_buffer (std::vector<GLuint> & indices, std::vector<GLuint> & grid_indices) override;
@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+#include <utility>
+
+#include "algebra.hpp"
+
+namespace mini {
+	struct aabb_t {
+		glm::vec3 min = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 max = { 0.0f, 0.0f, 0.0f };
+
+		void extend(const glm::vec3 & point);
+		void extend(const aabb_t & box);
+		void inflate(float margin);
+
+		glm::vec3 center() const;
+		bool overlaps(const aabb_t & other) const;
+
+		// distance from a point to the box, zero if the point is inside
+		float distance(const glm::vec3 & point) const;
+	};
+
+	// bounding volume hierarchy over the patches of a parametric surface
+	// every leaf stores the world space bounds of one patch and the
+	// parameter rectangle the patch covers, the tree layout is fixed
+	// after build so moving control points only requires a refit
+	class patch_bvh {
+		public:
+			struct leaf_t {
+				aabb_t bounds;
+				glm::vec2 min_param = { 0.0f, 0.0f };
+				glm::vec2 max_param = { 0.0f, 0.0f };
+			};
+
+		private:
+			struct node_t {
+				aabb_t bounds;
+				int parent = -1;
+
+				// children for inner nodes, leaf index for leaves
+				int left = -1;
+				int right = -1;
+				int leaf = -1;
+			};
+
+			std::vector<node_t> m_nodes;
+			std::vector<leaf_t> m_leaves;
+			std::vector<int> m_leaf_nodes;
+
+		public:
+			void build(const std::vector<leaf_t> & leaves);
+			void clear();
+
+			// updates bounds of a single leaf and all of its ancestors
+			void refit(int leaf, const aabb_t & bounds);
+
+			bool empty() const;
+			int get_num_leaves() const;
+
+			const leaf_t & get_leaf(int leaf) const;
+			const aabb_t & get_bounds() const;
+
+			// pairs of leaves (this, other) with overlapping bounds
+			void find_overlaps(const patch_bvh & other, std::vector<std::pair<int, int>> & pairs) const;
+
+			// leaf with bounds closest to the point, ties are resolved by
+			// the distance to the box center, returns -1 for an empty tree
+			int find_closest(const glm::vec3 & point) const;
+
+		private:
+			int m_build_node(std::vector<int> & leaves, int begin, int end, int parent);
+	};
+}
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 #include <glad/glad.h>
 #include <memory>
+#include <string>
+#include <vector>
 #include <functional>
+#include <unordered_map>
 
 #include "algebra.hpp"
 #include "shader.hpp"
@@ -13,6 +16,11 @@ namespace mini {
 	constexpr uint32_t back = 0;
 	constexpr uint32_t front = 1;
 
+	// values of the pick attachment, objects that write their own ids per
+	// instance report pick_id_per_instance and nothing is written for zero
+	constexpr uint32_t pick_id_none = 0;
+	constexpr uint32_t pick_id_per_instance = 0xffffffffu;
+
 	const static std::array<float, 12> quad_vertices = {
 		1.0f, 1.0f, 0.0f,
 		1.0f, -1.0f, 0.0f,
@@ -32,6 +40,29 @@ namespace mini {
 		1, 2, 3
 	};
 
+	/// <summary>
+	/// Layers are drawn in order, within a layer draws are sorted by their render key.
+	/// </summary>
+	enum class render_layer_t : uint32_t {
+		scene		= 0,
+		transparent	= 1,
+		overlay		= 2,
+		screen		= 3
+	};
+
+	/// <summary>
+	/// Gl state an object binds first when rendered, zero means unknown.
+	/// </summary>
+	struct render_key_t {
+		GLuint shader = 0;
+		GLuint vao = 0;
+		GLuint texture = 0;
+
+		bool operator== (const render_key_t & other) const;
+		bool operator!= (const render_key_t & other) const;
+		bool operator< (const render_key_t & other) const;
+	};
+
 	/// <summary>
 	/// This interface represents a visible object on the scene.
 	/// </summary>
@@ -39,9 +70,18 @@ namespace mini {
 		public:
 			virtual ~graphics_obj_t () { }
 			virtual void render (app_context & context, const glm::mat4x4 & world_matrix) const = 0;
-	};
+			virtual render_key_t get_render_key () const { return {}; }
+			virtual uint32_t get_pick_id () const { return pick_id_none; }
 
-	constexpr const uint64_t RENDER_QUEUE_SIZE = 1024;
+			// names the object in the profiler
+			virtual const std::string & get_debug_name () const {
+				static const std::string no_name;
+				return no_name;
+			}
+
+			// render only queues the object into a batch drawn and profiled elsewhere
+			virtual bool is_batched () const { return false; }
+	};
 
 	/// <summary>
 	/// This class represents the graphics context. Because the application is
@@ -52,13 +92,48 @@ namespace mini {
 			using render_hook_t = std::function<void (app_context &)>;
 
 		private:
-			struct enqueued_renderable_t {
+			struct render_entry_t {
 				std::weak_ptr<graphics_obj_t> object;
 				glm::mat4x4 world_matrix;
+				render_layer_t layer;
+				render_key_t key;
+				uint64_t sequence;
+				uint64_t frame;
+				bool retained;
 			};
 
-			std::array<enqueued_renderable_t, RENDER_QUEUE_SIZE> m_queue;
-			uint64_t m_last_queue_index;
+			// retained entries stay until they are removed, the others are
+			// dropped at the end of the first frame in which they were not drawn
+			std::vector<render_entry_t> m_render_list;
+			std::unordered_map<const graphics_obj_t *, std::size_t> m_render_index;
+
+			// the list is only swept when some entry went stale
+			std::size_t m_num_transient, m_num_drawn;
+
+			// std140 layout of the camera uniform block
+			struct camera_block_t {
+				glm::mat4x4 view;
+				glm::mat4x4 projection;
+				glm::vec2 resolution;
+				glm::vec2 padding;
+			};
+
+			GLuint m_camera_ubo;
+
+			// id picking, object ids are rendered into a second attachment of the
+			// back buffer and resolved into a single sampled buffer for reading
+			struct pick_block_t {
+				uint32_t object_id;
+				uint32_t padding[3];
+			};
+
+			GLuint m_pick_ubo;
+			GLuint m_idbuffer, m_pick_framebuffer, m_pick_renderbuffer;
+			uint32_t m_pick_id;
+			bool m_pick_enabled, m_pick_writes;
+
+			uint64_t m_frame, m_sequence;
+			bool m_sort_needed, m_rendering;
 
 			// opengl framebuffer objects
 			GLuint m_framebuffer[2], m_colorbuffer[2];
@@ -104,7 +179,24 @@ namespace mini {
 			const glm::mat4x4 & get_view_matrix () const;
 			const glm::mat4x4 & get_projection_matrix () const;
 
-			void draw (std::weak_ptr<graphics_obj_t> object, glm::mat4x4 world_matrix);
+			bool is_pick_enabled () const;
+			void set_pick_enabled (bool enabled);
+
+			// read back ids from the last rendered frame, pixel coordinates
+			// are in the buffer, zero is returned when nothing is under the cursor
+			uint32_t read_pick_id (int32_t x, int32_t y, int32_t radius);
+			void read_pick_ids (int32_t x0, int32_t y0, int32_t x1, int32_t y1, std::vector<uint32_t> & ids);
+
+			// objects drawn while the scene is being rendered are rendered immediately
+			void draw (std::weak_ptr<graphics_obj_t> object, const glm::mat4x4 & world_matrix, render_layer_t layer = render_layer_t::scene);
+
+			// retained objects are rendered every frame until removed without being
+			// drawn again, their matrix and render key only change through update
+			void add_retained (std::weak_ptr<graphics_obj_t> object, const glm::mat4x4 & world_matrix, render_layer_t layer = render_layer_t::scene);
+			void update_retained (const graphics_obj_t & object, const glm::mat4x4 & world_matrix);
+			void remove_retained (const graphics_obj_t & object);
+			void clear_retained ();
+
 			void render (bool clear);
 			void display (bool present, bool clear);
 			void display_scene (bool clear);
@@ -112,10 +204,22 @@ namespace mini {
 		private:
 			void m_try_switch_mode ();
 
+			void m_submit (std::weak_ptr<graphics_obj_t> object, const glm::mat4x4 & world_matrix, render_layer_t layer, bool retained);
+			void m_sort_render_list ();
+			void m_sweep_render_list ();
+			void m_index_render_list ();
+
 			void m_init_frame_buffer ();
 			void m_init_screen_quad ();
+			void m_init_camera_block ();
+			void m_update_camera_block ();
+			void m_init_pick_block ();
+			void m_set_pick_id (uint32_t pick_id);
+			bool m_read_pick_region (int32_t & x, int32_t & y, int32_t & width, int32_t & height, std::vector<uint32_t> & ids);
 
 			void m_destroy_frame_buffer ();
 			void m_destroy_screen_quad ();
+			void m_destroy_camera_block ();
+			void m_destroy_pick_block ();
 	};
 }
\ No newline at end of file
@@ -18,6 +18,7 @@ namespace mini {
 			cube_object & operator= (const cube_object &) = delete;
 
 			virtual void render (app_context & context, const glm::mat4x4 & world_matrix) const override;
+			virtual render_key_t get_render_key () const override;
 			virtual void configure () override;
 			virtual const object_serializer_base & get_serializer () const;
 	};
@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+#include "algebra.hpp"
+
+namespace mini {
+	class trimmable_surface_domain;
+	class patch_bvh;
+
+	// result of a batched surface evaluation in structure of arrays layout
+	// so that vectorized kernels can store whole registers at once
+	struct surface_samples {
+		std::vector<float> x, y, z;
+		std::vector<float> du_x, du_y, du_z;
+		std::vector<float> dv_x, dv_y, dv_z;
+		std::vector<float> n_x, n_y, n_z;
+
+		void resize(std::size_t count);
+		std::size_t size() const;
+
+		void set(std::size_t i, const glm::vec3 & position, const glm::vec3 & du, const glm::vec3 & dv, const glm::vec3 & normal);
+
+		glm::vec3 position(std::size_t i) const;
+		glm::vec3 ddu(std::size_t i) const;
+		glm::vec3 ddv(std::size_t i) const;
+		glm::vec3 normal(std::size_t i) const;
+	};
+
+	// parametric surface interface used by the numerical algorithms
+	// this header does not depend on gl or the scene so it can be used headless
+	class differentiable_surface_base {
+		public:
+			// domain information
+			virtual float get_min_u() const = 0;
+			virtual float get_max_u() const = 0;
+			virtual float get_min_v() const = 0;
+			virtual float get_max_v() const = 0;
+
+			// surface point
+			virtual glm::vec3 sample(float u, float v) const = 0;
+
+			// normal
+			virtual glm::vec3 normal(float u, float v) const = 0;
+
+			// first derivatives
+			virtual glm::vec3 ddu(float u, float v) const = 0;
+			virtual glm::vec3 ddv(float u, float v) const = 0;
+
+			// evaluates positions, first derivatives and normals for count
+			// parameter pairs at once, the default calls the functions above
+			virtual void evaluate(const float * u, const float * v, std::size_t count, surface_samples & out) const;
+
+			virtual ~differentiable_surface_base() {}
+
+			virtual bool is_u_wrapped() const = 0;
+			virtual bool is_v_wrapped() const = 0;
+
+			virtual bool is_trimmable() const;
+			virtual trimmable_surface_domain& get_trimmable_domain();
+
+			// optional hierarchy of patch bounds used to cull surface queries
+			// returns null when the surface does not keep one up to date
+			virtual const patch_bvh* get_bvh() const;
+	};
+}
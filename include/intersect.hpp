@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+
+#include "diffsurf.hpp"
+
+namespace mini {
+	enum class intersection_seeding {
+		// try a handful of fixed seeds and stop at the first hit
+		fixed,
+
+		// seed a grid of cells on both surfaces and descend from every
+		// pair of cells with overlapping bounds in parallel
+		grid
+	};
+
+	enum class intersection_solver {
+		// fixed step gradient descent on the squared distance
+		gradient,
+
+		// damped gauss-newton (levenberg-marquardt) on the distance residual
+		newton
+	};
+
+	struct intersection_options {
+		intersection_seeding seeding = intersection_seeding::fixed;
+
+		// solver used for seeding and for projecting the hint point
+		intersection_solver solver = intersection_solver::newton;
+
+		// grid seeding resolution per surface
+		int grid_u = 16;
+		int grid_v = 16;
+
+		// worker threads for grid seeding, zero means hardware concurrency
+		unsigned int num_threads = 0;
+
+		// when set, the search starts from parameters closest to the hint point
+		bool use_hint = false;
+		glm::vec3 hint = { 0.0f, 0.0f, 0.0f };
+
+		// maximum distance between surfaces for a point to count as an intersection
+		float tolerance = 0.01f;
+
+		// tracing parameters, the step adapts between min_step and max_step
+		// depending on curvature and on how quickly newton converges
+		float step = 0.01f;
+		float min_step = 0.0005f;
+		float max_step = 0.08f;
+		int max_steps = 1000;
+	};
+
+	struct intersection_curve {
+		// parameters of consecutive points on both surfaces
+		std::vector<glm::vec2> params1;
+		std::vector<glm::vec2> params2;
+
+		// parameter increments before wrapping, used for trimming
+		std::vector<glm::vec2> directions1;
+		std::vector<glm::vec2> directions2;
+
+		// world positions sampled on the first surface
+		std::vector<glm::vec3> points;
+	};
+
+	struct intersection_start {
+		glm::vec2 params1 = { 0.0f, 0.0f };
+		glm::vec2 params2 = { 0.0f, 0.0f };
+
+		glm::vec3 point1 = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 point2 = { 0.0f, 0.0f, 0.0f };
+	};
+
+	struct intersection_component {
+		intersection_start start;
+
+		// set when the forward curve returned to the start point,
+		// the backward curve is empty in that case
+		bool closed = false;
+
+		// curve traced along the tangent and against it
+		intersection_curve forward;
+		intersection_curve backward;
+	};
+
+	struct intersection_result {
+		bool found = false;
+
+		// all distinct converged starting points
+		std::vector<intersection_start> starts;
+
+		// one traced curve per start point that did not lie on a previous curve
+		std::vector<intersection_component> components;
+	};
+
+	// finds and traces the intersection curve of two surfaces
+	// the function has no side effects, it only reads both surfaces
+	intersection_result intersect(
+		const differentiable_surface_base & surface1,
+		const differentiable_surface_base & surface2,
+		const intersection_options & options = intersection_options());
+
+	void wrap_coordinates(const differentiable_surface_base & surface, float & u, float & v);
+}
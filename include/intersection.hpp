@@ -1,6 +1,7 @@
 #pragma once
 #include "object.hpp"
 #include "surface.hpp"
+#include "intersect.hpp"
 
 namespace mini {
 	class intersection_controller final {
@@ -14,12 +15,14 @@ namespace mini {
 			std::shared_ptr<resource_store> m_store;
 
 			bool m_from_cursor;
+			intersection_seeding m_seeding;
 
 		public:
 			intersection_controller(
 				scene_controller_base & scene, 
 				std::shared_ptr<resource_store> store, 
-				bool from_cursor);
+				bool from_cursor,
+				intersection_seeding seeding = intersection_seeding::fixed);
 
 			~intersection_controller();
 
@@ -27,11 +30,8 @@ namespace mini {
 			intersection_controller& operator= (const intersection_controller &) = delete;
 
 		private:
-			inline void m_wrap_coordinates(const generic_surface_ptr& surface, float& u, float& v) const;
-
-			void m_start_by_cursor(glm::vec2 & s1, glm::vec2 & s2) const;
-			glm::vec2 m_get_cursor_projection(const generic_surface_ptr& surface, const glm::vec2& s) const;
-			bool m_find_starting_points(glm::vec2 & p1, glm::vec2 & p2, const glm::vec2 & s1, const glm::vec2 & s2) const;
-			void m_trace_intersection(const glm::vec2 & s1, const glm::vec2 & s2) const;
+			void m_add_debug_points(const intersection_component & component) const;
+			void m_trim_surfaces(const intersection_result & result) const;
+			void m_add_curves(const intersection_component & component) const;
 	};
 }
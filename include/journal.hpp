@@ -0,0 +1,85 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_set>
+
+#include <nlohmann/json.hpp>
+
+#include "serializer.hpp"
+#include "saver.hpp"
+
+namespace mini {
+	// autosave as a binary base snapshot and an append only journal of the objects
+	// changed since, a flush writes only what was touched so autosaving a large
+	// scene costs kilobytes, the journal is folded into a new base in the background
+	// once it grows too long, the journal names the generation of its base and both
+	// are replaced in an order that always leaves a matching pair on disk
+	class scene_journal {
+		public:
+			using object_list_t = std::vector<std::shared_ptr<scene_obj_t>>;
+
+		private:
+			std::string m_directory;
+			bool m_enabled;
+
+			// generation of the base the journal applies to, zero before the first one,
+			// and of the newest base requested which may still be written
+			uint64_t m_generation;
+			uint64_t m_pending_generation;
+
+			// scene ids to file ids of the base and of everything journaled since
+			cache_object_id_t m_cache;
+			std::unordered_set<uint64_t> m_dirty;
+			std::vector<int> m_deleted;
+
+			std::size_t m_num_records;
+			std::size_t m_num_base_objects;
+
+			bool m_compacting;
+			std::string m_compact_error;
+			scene_saver m_saver;
+
+		public:
+			scene_journal(const std::string & directory);
+			~scene_journal();
+
+			scene_journal(const scene_journal &) = delete;
+			scene_journal & operator=(const scene_journal &) = delete;
+
+			bool is_enabled() const;
+			bool is_compacting() const;
+			bool needs_compaction() const;
+
+			void object_changed(const scene_obj_t & object);
+			void object_deleted(const scene_obj_t & object);
+
+			// appends every pending change to the journal, skipped while compacting
+			void flush(scene_controller_base & scene);
+
+			// starts a new base from the whole scene, pending changes are part of it,
+			// a base requested while another one is written replaces it
+			void compact(const object_list_t & objects);
+
+			// call once per frame, finishes a completed compaction
+			void poll();
+
+			// the autosave of a session that did not exit cleanly
+			bool has_recovery() const;
+			nlohmann::json recover() const;
+			void discard_recovery();
+
+		private:
+			std::string m_get_journal_path() const;
+			std::string m_get_recovery_path() const;
+			std::string m_get_base_path(uint64_t generation) const;
+
+			// generation named by the header of a journal, zero when unreadable
+			uint64_t m_read_generation(const std::string & path) const;
+
+			bool m_append(const std::string & records);
+			void m_finish_compaction();
+			void m_remove_stale_bases() const;
+	};
+}
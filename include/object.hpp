@@ -3,6 +3,9 @@
 #include <array>
 #include <set>
 #include <list>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <glm/gtx/quaternion.hpp>
 
@@ -35,15 +38,64 @@ namespace mini {
 	};
 
 	class scene_obj_t;
+	class point_cloud;
+
+	// scene level events, delivered only to objects that subscribed to them
+	enum class scene_event_t {
+		created		= 0,
+		deleted		= 1,
+		MAX
+	};
 
 	class scene_controller_base {
+		public:
+			using object_batch_t = std::vector<std::shared_ptr<scene_obj_t>>;
+
 		private:
+			using subscriber_map_t = std::unordered_map<const scene_obj_t *, std::weak_ptr<scene_obj_t>>;
+
 			uint64_t m_next_id;
 
+			// subscription registry and the batch of the open transaction
+			std::array<subscriber_map_t, static_cast<int> (scene_event_t::MAX)> m_subscribers;
+			object_batch_t m_created_batch, m_deleted_batch;
+			std::unordered_set<const scene_obj_t *> m_created_pending;
+			int m_transaction_depth;
+
+			// signals emitted since the last dispatch, one entry per emitter
+			// with a mask of its signals so repeated emits collapse into one
+			struct queued_signals_t {
+				std::weak_ptr<scene_obj_t> emitter;
+				uint32_t signals;
+			};
+
+			std::vector<queued_signals_t> m_signal_queue;
+			std::unordered_map<const scene_obj_t *, std::size_t> m_signal_index;
+
+		private:
+			object_batch_t m_lock_subscribers (scene_event_t event);
+			void m_flush_transaction ();
+			void m_queue_signal (scene_obj_t & emitter, int signal);
+
 		protected:
 			uint64_t t_parent_object (scene_obj_t & object);
 			uint64_t t_unparent_object (scene_obj_t & object);
 
+			// queue an event, it is delivered right away outside of a transaction
+			void t_object_created (std::shared_ptr<scene_obj_t> object);
+			void t_object_deleted (std::shared_ptr<scene_obj_t> object);
+			void t_clear_subscriptions ();
+
+			// called for every moved object, before the signal is queued
+			virtual void t_on_object_moved (scene_obj_t & object) { }
+
+			// called for every signal that changes what an object saves to
+			virtual void t_on_object_changed (scene_obj_t & object) { }
+
+			// delivers queued signals to their listeners, signals emitted by the
+			// handlers are delivered in the same call up to a fixed number of rounds
+			void t_dispatch_signals ();
+
 		public:
 			class selected_object_collection {
 				public:
@@ -78,6 +130,9 @@ namespace mini {
 
 			virtual bool get_show_points () const = 0;
 
+			// shared renderer for points, scenes without one render points separately
+			virtual std::shared_ptr<point_cloud> get_point_cloud () const { return nullptr; }
+
 			virtual void select_by_id (uint64_t id) = 0;
 			virtual void clear_selection () = 0;
 
@@ -92,6 +147,14 @@ namespace mini {
 			virtual const video_mode_t & get_video_mode () const = 0;
 
 			virtual selected_object_iter_ptr get_selected_objects () = 0;
+
+			void subscribe (scene_event_t event, std::shared_ptr<scene_obj_t> subscriber);
+			void unsubscribe (scene_event_t event, const scene_obj_t & subscriber);
+
+			// created and deleted objects are collected until the outermost commit
+			// and then delivered to every subscriber as one batch
+			void begin_transaction ();
+			void commit_transaction ();
 			
 			template<typename T> std::shared_ptr<T> get_object (uint64_t id) {
 				auto object = get_object (id);
@@ -102,6 +165,8 @@ namespace mini {
 				auto object_cast = std::dynamic_pointer_cast<T> (object);
 				return object_cast;
 			}
+
+		friend class scene_obj_t;
 	};
 
 	class scene_obj_t : 
@@ -140,11 +205,12 @@ namespace mini {
 
 			int64_t m_id;
 
-			std::array<std::list<std::weak_ptr<scene_obj_t>>, static_cast<int> (signal_event_t::MAX)> m_listeners;
+			std::array<std::vector<std::weak_ptr<scene_obj_t>>, static_cast<int> (signal_event_t::MAX)> m_listeners;
 			std::array<signal_handler_t, static_cast<int> (signal_event_t::MAX) + 1> m_handlers;
 
 		private:
 			void m_notify (signal_event_t sig);
+			void m_deliver (signal_event_t sig);
 			void m_receive (signal_event_t sig, scene_obj_t & emitter);
 			void m_listen (signal_event_t sig, std::shared_ptr<scene_obj_t> listener);
 			void m_ignore (signal_event_t sig, std::shared_ptr<scene_obj_t> listener);
@@ -203,6 +269,8 @@ namespace mini {
 			void notify_object_created (std::shared_ptr<scene_obj_t> object);
 			void notify_object_selected (std::shared_ptr<scene_obj_t> object);
 			void notify_object_deleted (std::shared_ptr<scene_obj_t> object);
+			void notify_objects_created (const scene_controller_base::object_batch_t & objects);
+			void notify_objects_deleted (const scene_controller_base::object_batch_t & objects);
 
 			// virtual methods
 			virtual void integrate (float delta_time);
@@ -210,17 +278,30 @@ namespace mini {
 			virtual bool hit_test (const hit_test_data_t & data, glm::vec3 & hit_pos) const;
 			virtual bool box_test (const box_test_data_t & data) const;
 			virtual glm::vec3 get_transform_origin () const;
+
+			// objects hit through a single point are picked by the scene's spatial index
+			// instead of hit_test and box_test, returns false for all other objects
+			virtual bool get_pick_point (glm::vec3 & point) const;
+
+			// objects are written to the id buffer with their own id
+			virtual uint32_t get_pick_id () const override;
+			virtual const std::string & get_debug_name () const override;
 			
 			// object serialization
 			virtual const object_serializer_base & get_serializer () const;
 
 		protected:
 			virtual void t_on_selection (bool select) { }
+			virtual void t_on_translation (const glm::vec3 & translation) { }
 			virtual void t_on_alt_select () { }
 			virtual void t_on_object_created (std::shared_ptr<scene_obj_t> object) { }
 			virtual void t_on_object_selected (std::shared_ptr<scene_obj_t> object) {}
 			virtual void t_on_object_deleted (std::shared_ptr<scene_obj_t> object) { }
 
+			// batched variants, by default forward every object to the single handlers
+			virtual void t_on_objects_created (const scene_controller_base::object_batch_t & objects);
+			virtual void t_on_objects_deleted (const scene_controller_base::object_batch_t & objects);
+
 		friend class scene_controller_base;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,222 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+
+namespace mini {
+	// handle to an element of an object_store, a handle whose element was removed
+	// is detected by its generation so it can never reach a newer element in the slot
+	struct object_handle_t {
+		uint32_t index = 0;
+		uint32_t generation = 0;
+
+		bool operator==(const object_handle_t & other) const {
+			return index == other.index && generation == other.generation;
+		}
+
+		bool operator!=(const object_handle_t & other) const {
+			return !(*this == other);
+		}
+	};
+
+	// slot map of scene objects, values are kept densely packed for iteration and
+	// removed by swapping the last one into the hole, the store also owns the
+	// id and name indexes so that lookups by either are constant time
+	template<typename T> class object_store {
+		private:
+			struct slot_t {
+				uint32_t generation;
+				uint32_t dense;
+				bool alive;
+			};
+
+			std::vector<slot_t> m_slots;
+			std::vector<uint32_t> m_free_slots;
+
+			// dense arrays, all indexed the same way
+			std::vector<T> m_values;
+			std::vector<uint32_t> m_dense_slots;
+			std::vector<uint64_t> m_ids;
+			std::vector<std::string> m_names;
+
+			std::unordered_map<uint64_t, object_handle_t> m_id_index;
+			std::unordered_map<std::string, object_handle_t> m_name_index;
+
+		public:
+			using iterator = typename std::vector<T>::iterator;
+			using const_iterator = typename std::vector<T>::const_iterator;
+
+			object_store() = default;
+
+			object_store(const object_store &) = delete;
+			object_store & operator=(const object_store &) = delete;
+
+			std::size_t size() const {
+				return m_values.size();
+			}
+
+			bool empty() const {
+				return m_values.empty();
+			}
+
+			// dense order, changes when elements are removed
+			T & operator[](std::size_t index) {
+				return m_values[index];
+			}
+
+			const T & operator[](std::size_t index) const {
+				return m_values[index];
+			}
+
+			iterator begin() {
+				return m_values.begin();
+			}
+
+			iterator end() {
+				return m_values.end();
+			}
+
+			const_iterator begin() const {
+				return m_values.begin();
+			}
+
+			const_iterator end() const {
+				return m_values.end();
+			}
+
+			object_handle_t insert(uint64_t id, const std::string & name, T value) {
+				uint32_t index;
+
+				if (m_free_slots.empty()) {
+					index = static_cast<uint32_t>(m_slots.size());
+					m_slots.push_back({ 1, 0, false });
+				} else {
+					index = m_free_slots.back();
+					m_free_slots.pop_back();
+				}
+
+				auto & slot = m_slots[index];
+				slot.dense = static_cast<uint32_t>(m_values.size());
+				slot.alive = true;
+
+				const object_handle_t handle = { index, slot.generation };
+
+				m_values.push_back(std::move(value));
+				m_dense_slots.push_back(index);
+				m_ids.push_back(id);
+				m_names.push_back(name);
+
+				m_id_index[id] = handle;
+				m_name_index[name] = handle;
+
+				return handle;
+			}
+
+			bool contains(object_handle_t handle) const {
+				return handle.index < m_slots.size() &&
+					m_slots[handle.index].alive &&
+					m_slots[handle.index].generation == handle.generation;
+			}
+
+			T * get(object_handle_t handle) {
+				return contains(handle) ? &m_values[m_slots[handle.index].dense] : nullptr;
+			}
+
+			const T * get(object_handle_t handle) const {
+				return contains(handle) ? &m_values[m_slots[handle.index].dense] : nullptr;
+			}
+
+			T * find(uint64_t id) {
+				auto iter = m_id_index.find(id);
+				return (iter != m_id_index.end()) ? get(iter->second) : nullptr;
+			}
+
+			const T * find(uint64_t id) const {
+				auto iter = m_id_index.find(id);
+				return (iter != m_id_index.end()) ? get(iter->second) : nullptr;
+			}
+
+			bool is_name_taken(const std::string & name) const {
+				return m_name_index.find(name) != m_name_index.end();
+			}
+
+			void rename(object_handle_t handle, const std::string & name) {
+				if (!contains(handle)) {
+					return;
+				}
+
+				auto & old_name = m_names[m_slots[handle.index].dense];
+				m_erase_name(old_name, handle);
+
+				old_name = name;
+				m_name_index[name] = handle;
+			}
+
+			bool remove(object_handle_t handle) {
+				if (!contains(handle)) {
+					return false;
+				}
+
+				auto & slot = m_slots[handle.index];
+				const uint32_t dense = slot.dense;
+				const uint32_t last = static_cast<uint32_t>(m_values.size() - 1);
+
+				m_erase_name(m_names[dense], handle);
+
+				auto id_iter = m_id_index.find(m_ids[dense]);
+				if (id_iter != m_id_index.end() && id_iter->second == handle) {
+					m_id_index.erase(id_iter);
+				}
+
+				// move the last element into the hole
+				if (dense != last) {
+					m_values[dense] = std::move(m_values[last]);
+					m_dense_slots[dense] = m_dense_slots[last];
+					m_ids[dense] = m_ids[last];
+					m_names[dense] = std::move(m_names[last]);
+
+					m_slots[m_dense_slots[dense]].dense = dense;
+				}
+
+				m_values.pop_back();
+				m_dense_slots.pop_back();
+				m_ids.pop_back();
+				m_names.pop_back();
+
+				slot.alive = false;
+				slot.generation++;
+				m_free_slots.push_back(handle.index);
+
+				return true;
+			}
+
+			void clear() {
+				for (uint32_t index = 0; index < m_slots.size(); ++index) {
+					if (m_slots[index].alive) {
+						m_slots[index].alive = false;
+						m_slots[index].generation++;
+						m_free_slots.push_back(index);
+					}
+				}
+
+				m_values.clear();
+				m_dense_slots.clear();
+				m_ids.clear();
+				m_names.clear();
+
+				m_id_index.clear();
+				m_name_index.clear();
+			}
+
+		private:
+			void m_erase_name(const std::string & name, object_handle_t handle) {
+				// another element may have taken the name over in the meantime
+				auto iter = m_name_index.find(name);
+				if (iter != m_name_index.end() && iter->second == handle) {
+					m_name_index.erase(iter);
+				}
+			}
+	};
+}
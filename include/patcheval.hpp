@@ -0,0 +1,24 @@
+#pragma once
+#include "diffsurf.hpp"
+
+namespace mini {
+	enum class bicubic_basis {
+		bezier,
+		bspline
+	};
+
+	// evaluates a grid of bicubic patches for a batch of parameters
+	// the control net is patch-major, 16 points per patch, point (x, y)
+	// of a patch is stored at 4 * y + x where x follows u and y follows v
+	// parameters are clamped to [0, 1] and the derivatives are taken
+	// with respect to the global parameters like in the scalar functions
+	void evaluate_bicubic_patches(
+		bicubic_basis basis,
+		unsigned int patches_x,
+		unsigned int patches_y,
+		const glm::vec3 * net,
+		const float * u,
+		const float * v,
+		std::size_t count,
+		surface_samples & out);
+}
\ No newline at end of file
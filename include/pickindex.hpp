@@ -0,0 +1,99 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "bvh.hpp"
+
+namespace mini {
+	// points closer to the mouse than this are hit
+	constexpr float pick_radius_pixels = 25.0f;
+
+	// the id buffer is exact so only a few pixels of slack are needed
+	constexpr int32_t gpu_pick_radius_pixels = 4;
+
+	// uniform hash grid over the pick points of scene objects, only occupied
+	// cells are stored so the grid is unbounded, moving a point is constant
+	// time and queries only project points from cells that touch the region
+	// of interest, all with a single precomputed view projection matrix, the
+	// cell size follows the extent and number of points and is derived anew
+	// whenever the number of points doubles, queries slice the sub frustum
+	// along one axis and only look up the cells each slice covers
+	class pick_index {
+		public:
+			struct query_t {
+				glm::mat4x4 view_projection;
+				glm::vec2 screen_res;
+			};
+
+		private:
+			struct entry_t {
+				uint64_t id;
+				glm::vec3 position;
+				uint64_t cell;
+				uint32_t cell_slot;
+			};
+
+			struct cell_range_t {
+				glm::ivec3 min;
+				glm::ivec3 max;
+			};
+
+			float m_cell_size;
+			std::size_t m_rebuild_size;
+
+			std::vector<entry_t> m_entries;
+			std::unordered_map<uint64_t, uint32_t> m_entry_index;
+			std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+
+			// cells that were ever occupied since the last rebuild lie inside
+			glm::ivec3 m_cell_min, m_cell_max;
+
+			// reused between queries
+			mutable std::vector<uint32_t> m_candidates;
+			mutable std::vector<cell_range_t> m_ranges;
+
+		public:
+			pick_index(float cell_size = 1.0f);
+
+			pick_index(const pick_index &) = delete;
+			pick_index & operator=(const pick_index &) = delete;
+
+			std::size_t size() const;
+			bool contains(uint64_t id) const;
+
+			void insert(uint64_t id, const glm::vec3 & position);
+			void update(uint64_t id, const glm::vec3 & position);
+			void remove(uint64_t id);
+			void clear();
+
+			// point within radius pixels of the mouse that is closest to the
+			// camera, returns 0 when nothing was hit
+			uint64_t pick(const query_t & query, const glm::vec2 & mouse_screen, float radius,
+				const glm::vec3 & camera_pos, float & distance) const;
+
+			// all points projected inside the screen space rectangle
+			void select_box(const query_t & query, const glm::vec2 & top_left_screen,
+				const glm::vec2 & bottom_right_screen, std::vector<uint64_t> & ids) const;
+
+		private:
+			glm::ivec3 m_get_cell_coords(const glm::vec3 & position) const;
+			uint64_t m_get_cell(const glm::vec3 & position) const;
+			aabb_t m_get_cell_bounds(uint64_t cell) const;
+
+			// picks the cell size for the current points and sorts them again
+			void m_rebuild();
+
+			void m_add_to_cell(uint32_t entry);
+			void m_remove_from_cell(uint32_t entry);
+
+			// cells covered by the sub frustum, false when there are more of
+			// them than occupied cells and walking those is cheaper
+			bool m_get_cell_ranges(const std::array<glm::vec3, 8> & corners) const;
+
+			// collects entries from all cells inside the sub frustum that
+			// covers the given pixel rectangle
+			void m_query_rect(const query_t & query, const glm::vec2 & min_screen, const glm::vec2 & max_screen) const;
+	};
+}
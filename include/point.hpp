@@ -3,6 +3,7 @@
 
 #include "object.hpp"
 #include "billboard.hpp"
+#include "pointcloud.hpp"
 
 namespace mini {
 	class point_object;
@@ -42,7 +43,12 @@ namespace mini {
 			static constexpr glm::vec4 s_select_default = { 0.960f, 0.646f, 0.0192f, 1.0f };
 
 		private:
-			billboard_object m_billboard;
+			// points are drawn by the scene point cloud when there is one
+			// and fall back to their own billboard otherwise
+			std::weak_ptr<point_cloud> m_cloud;
+			point_cloud::slot_t m_slot;
+			std::unique_ptr<billboard_object> m_billboard;
+
 			glm::vec4 m_color, m_selected_color;
 			bool m_mergeable;
 
@@ -57,12 +63,15 @@ namespace mini {
 			void set_select_color (const glm::vec4 & color);
 
 			point_object (scene_controller_base & scene, std::shared_ptr<shader_t> shader, std::shared_ptr<texture_t> texture);
-			~point_object () = default;
+			~point_object ();
 
 			virtual void render (app_context & context, const glm::mat4x4 & world_matrix) const override;
 			virtual void configure () override;
 			virtual bool hit_test (const hit_test_data_t & data, glm::vec3 & hit_pos) const override;
 			virtual bool box_test (const box_test_data_t & data) const override;
+			virtual bool get_pick_point (glm::vec3 & point) const override;
+			virtual uint32_t get_pick_id () const override;
+			virtual bool is_batched () const override;
 
 			void add_parent (std::shared_ptr<point_family_base> family);
 			void clear_parent (const point_family_base & family);
@@ -70,9 +79,11 @@ namespace mini {
 
 		protected:
 			virtual void t_on_selection (bool selected) override;
+			virtual void t_on_translation (const glm::vec3 & translation) override;
 			virtual void t_on_alt_select () override;
 
 		private:
 			void m_check_deletable ();
+			void m_update_color ();
 	};
 }
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <glad/glad.h>
+
+#include "context.hpp"
+#include "texture.hpp"
+
+namespace mini {
+	// renders all points of a scene as screen space billboards in a single
+	// instanced draw call, point positions and colors live in one persistent
+	// buffer that is only updated when a point moves or changes its color
+	// every frame points enqueue their slots and only the enqueued ones are drawn
+	class point_cloud : public graphics_obj_t {
+		public:
+			using slot_t = uint32_t;
+
+		private:
+			// layout of a single point in the buffer texture, two rgba32f texels
+			struct point_data_t {
+				glm::vec4 position;
+				glm::vec4 color;
+			};
+
+			// one per drawn instance, the pick id is written to the id buffer
+			struct instance_t {
+				slot_t slot;
+				uint32_t pick_id;
+
+				bool operator==(const instance_t & other) const {
+					return slot == other.slot && pick_id == other.pick_id;
+				}
+			};
+
+			std::vector<point_data_t> m_points;
+			std::vector<slot_t> m_free_slots;
+
+			// instances enqueued for the current pass and the ones in the slot buffer
+			mutable std::vector<instance_t> m_queued, m_drawn;
+
+			// range of points that changed since the last upload
+			mutable std::size_t m_dirty_begin, m_dirty_end;
+			mutable std::size_t m_point_capacity, m_slot_capacity;
+
+			GLuint m_vao, m_quad_buffers[3];
+			GLuint m_point_buffer, m_point_texture, m_slot_buffer;
+
+			glm::vec2 m_size;
+
+			std::shared_ptr<shader_t> m_shader;
+			std::shared_ptr<texture_t> m_texture;
+
+		public:
+			point_cloud(std::shared_ptr<shader_t> shader, std::shared_ptr<texture_t> texture);
+			~point_cloud();
+
+			point_cloud(const point_cloud &) = delete;
+			point_cloud & operator=(const point_cloud &) = delete;
+
+			const glm::vec2 & get_size() const;
+			void set_size(const glm::vec2 & size);
+
+			std::size_t get_num_points() const;
+
+			slot_t allocate(const glm::vec3 & position, const glm::vec4 & color);
+			void release(slot_t slot);
+
+			void set_position(slot_t slot, const glm::vec3 & position);
+			void set_color(slot_t slot, const glm::vec4 & color);
+
+			// marks the point to be drawn by the next render call
+			void enqueue(slot_t slot, uint32_t pick_id = pick_id_none);
+
+			virtual void render(app_context & context, const glm::mat4x4 & world_matrix) const override;
+			virtual render_key_t get_render_key() const override;
+			virtual uint32_t get_pick_id() const override;
+
+		private:
+			void m_mark_dirty(slot_t slot);
+			void m_upload_points() const;
+			void m_upload_slots() const;
+	};
+}
@@ -0,0 +1,180 @@
+#pragma once
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+
+namespace mini {
+	// frames kept for the timeline and the trace dump, older frames are also
+	// dropped once the history holds more events than this in total
+	constexpr std::size_t profiler_history_size = 300;
+	constexpr std::size_t profiler_history_events = 1 << 18;
+
+	// per object time below this is not worth a place on the timeline, in us
+	constexpr double profiler_object_threshold = 20.0;
+
+	// cpu scopes are timed with the steady clock and gpu scopes with timestamp
+	// queries that are read back a few frames later without stalling, both end up
+	// on one timeline per frame, scopes are only recorded on the main thread and
+	// cost a single branch while the profiler is off, gpu scopes are meant for
+	// whole passes, work done per object is timed on the cpu and summed up into
+	// one event per object and frame
+	class frame_profiler final {
+		public:
+			enum class track_t : uint32_t {
+				cpu = 0,
+				gpu = 1
+			};
+
+			// times are in microseconds since the profiler was created, count is
+			// the number of samples summed up into the event
+			struct event_t {
+				const char * name;
+				std::string label;
+				track_t track;
+				uint32_t depth;
+				double start;
+				double duration;
+				uint32_t count;
+			};
+
+			struct frame_t {
+				uint64_t index;
+				double start;
+				double duration;
+				bool gpu_resolved;
+				std::vector<event_t> events;
+			};
+
+		private:
+			struct gpu_scope_t {
+				const char * name;
+				std::string label;
+				uint32_t depth;
+				GLuint begin_query;
+				GLuint end_query;
+			};
+
+			struct open_scope_t {
+				std::size_t event;
+				std::size_t gpu_scope;
+			};
+
+			struct object_key_hash {
+				std::size_t operator() (const std::pair<const char *, const void *> & key) const {
+					return std::hash<const void *> () (key.first) ^ (std::hash<const void *> () (key.second) << 1);
+				}
+			};
+
+			// frame whose gpu scopes are still in flight
+			struct gpu_frame_t {
+				uint64_t index;
+				GLuint start_query;
+				GLuint last_query;
+				double start;
+				std::vector<gpu_scope_t> scopes;
+			};
+
+			using profiler_clock = std::chrono::steady_clock;
+
+			profiler_clock::time_point m_epoch;
+			bool m_enabled;
+			bool m_recording;
+
+			uint64_t m_frame_index;
+			frame_t m_frame;
+			std::vector<open_scope_t> m_open_scopes;
+			uint32_t m_gpu_depth;
+
+			// event of every object timed in this frame
+			std::unordered_map<std::pair<const char *, const void *>, std::size_t, object_key_hash> m_object_events;
+
+			std::deque<frame_t> m_history;
+			std::size_t m_history_events;
+
+			gpu_frame_t m_gpu_frame;
+			std::deque<gpu_frame_t> m_gpu_pending;
+			std::vector<GLuint> m_free_queries;
+
+			// timeline state
+			int m_selected_frame;
+
+		public:
+			static frame_profiler & get_instance ();
+
+			frame_profiler (const frame_profiler &) = delete;
+			frame_profiler & operator= (const frame_profiler &) = delete;
+
+			bool is_enabled () const;
+			bool is_recording () const;
+
+			// takes effect with the next frame
+			void set_enabled (bool enabled);
+
+			void begin_frame ();
+			void end_frame ();
+
+			// the label names the object the scope belongs to
+			void begin_scope (const char * name, bool gpu = false);
+			void begin_scope (const char * name, std::string label, bool gpu = false);
+			void end_scope ();
+
+			// microseconds since the profiler was created
+			double get_time () const;
+
+			// adds cpu time spent on one object to its event in this frame
+			void add_object_time (const char * name, const void * object, const std::string & label, double start, double duration);
+
+			const std::deque<frame_t> & get_history () const;
+
+			// writes the history in the chrome trace event format, throws on failure
+			void save_trace (const std::string & path) const;
+
+			// frame graph, timeline of one frame and its most expensive scopes
+			void configure ();
+
+		private:
+			frame_profiler ();
+
+			double m_now () const;
+			GLuint m_get_query ();
+			void m_resolve_gpu_frames ();
+			void m_trim_history ();
+			void m_draw_timeline (const frame_t & frame);
+			void m_draw_top_scopes (const frame_t & frame);
+	};
+
+	// times the enclosing block
+	class profile_scope final {
+		private:
+			bool m_active;
+
+		public:
+			profile_scope (const char * name, bool gpu = false);
+			profile_scope (const char * name, const std::string & label, bool gpu = false);
+			~profile_scope ();
+
+			profile_scope (const profile_scope &) = delete;
+			profile_scope & operator= (const profile_scope &) = delete;
+	};
+
+	// times work done on one object, cpu only, cheap enough for every object
+	class profile_object_scope final {
+		private:
+			const char * m_name;
+			const void * m_object;
+			const std::string * m_label;
+			double m_start;
+
+		public:
+			profile_object_scope (const char * name, const void * object, const std::string & label);
+			~profile_object_scope ();
+
+			profile_object_scope (const profile_object_scope &) = delete;
+			profile_object_scope & operator= (const profile_object_scope &) = delete;
+	};
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+#include "shader.hpp"
+
+namespace mini {
+	// on-disk cache of linked program binaries, a program is identified by
+	// a hash of its sources and of the driver that produced the binary so
+	// that driver updates and shader edits simply miss the cache
+	class program_cache {
+		private:
+			std::string m_directory;
+			std::string m_driver;
+			bool m_enabled;
+
+		public:
+			program_cache(const std::string & directory);
+
+			program_cache(const program_cache &) = delete;
+			program_cache & operator=(const program_cache &) = delete;
+
+			bool is_enabled() const;
+
+			// links the shader from the cache, returns false on a miss
+			bool load(shader_t & shader) const;
+
+			// stores a linked shader, failures only cost the next startup
+			void store(const shader_t & shader) const;
+
+		private:
+			std::string m_get_path(const shader_t & shader) const;
+	};
+}
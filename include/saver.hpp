@@ -0,0 +1,62 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <optional>
+
+#include "serializer.hpp"
+
+namespace mini {
+	// writes scene snapshots on a background thread, the file is written next to
+	// the target and renamed over it once complete so a failed save never leaves
+	// half a scene behind, a save requested while another one runs is queued and
+	// only the latest queued one is kept
+	class scene_saver {
+		private:
+			struct request_t {
+				std::shared_ptr<const scene_snapshot> snapshot;
+				std::string path;
+				bool binary;
+			};
+
+			std::thread m_thread;
+			std::atomic<bool> m_running;
+			std::atomic<float> m_progress;
+
+			// only touched on the main thread or after the worker was joined
+			std::optional<request_t> m_pending;
+			std::string m_path;
+			std::string m_error;
+
+			// error of a save that completed and was replaced by the next one
+			// before poll saw it, reported by the next poll
+			std::string m_unreported_error;
+
+		public:
+			scene_saver();
+			~scene_saver();
+
+			scene_saver(const scene_saver &) = delete;
+			scene_saver & operator=(const scene_saver &) = delete;
+
+			bool is_saving() const;
+			float get_progress() const;
+			const std::string & get_path() const;
+
+			void save(std::shared_ptr<const scene_snapshot> snapshot, const std::string & path, bool binary);
+
+			// blocks until the running and the queued save are written
+			void wait();
+
+			// call once per frame, finishes a completed save and starts the queued
+			// one, returns false with the error when the completed save failed or
+			// an earlier one did that completed while save started the next
+			bool poll(std::string & error);
+
+		private:
+			void m_start(request_t request);
+			void m_worker(request_t request);
+			bool m_write(const std::string & path, const std::string & data);
+	};
+}
@@ -3,6 +3,10 @@
 #include <list>
 #include <unordered_map>
 #include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 
 #include <nlohmann/json.hpp>
 #include <glm/glm.hpp>
@@ -18,6 +22,10 @@ namespace mini {
 	//using cache_object_id_t = std::unordered_map<uint64_t, int>;
 	using cache_id_object_t = std::unordered_map<int, std::shared_ptr<scene_obj_t>>;
 
+	// second half of deserialization, creates the object and its opengl resources
+	using object_builder_t = std::function<std::shared_ptr<scene_obj_t> (scene_controller_base & scene,
+		std::shared_ptr<resource_store> store, cache_id_object_t & cache)>;
+
 	class cache_object_id_t final {
 		private:
 			std::unordered_map<uint64_t, int> m_cache;
@@ -30,6 +38,9 @@ namespace mini {
 			cache_object_id_t (const cache_object_id_t &) = delete;
 			cache_object_id_t & operator= (const cache_object_id_t &) = delete;
 
+			cache_object_id_t (cache_object_id_t &&) = default;
+			cache_object_id_t & operator= (cache_object_id_t &&) = default;
+
 			int add (uint64_t object);
 			void clear ();
 			bool has (uint64_t object) const;
@@ -48,8 +59,40 @@ namespace mini {
 			virtual ~object_deserializer_base () = default;
 			virtual std::shared_ptr<scene_obj_t> deserialize (scene_controller_base & scene, std::shared_ptr<resource_store> store, 
 				const json & data, cache_id_object_t & cache) const = 0;
+
+			// reads and validates the data without touching the scene, safe to call
+			// from any thread, the returned builder has to run on the main thread
+			virtual object_builder_t prepare (const json & data) const = 0;
 	};
 	
+	// immutable copy of everything a save needs, taken on the main thread and
+	// written out from any thread while the scene keeps changing
+	class scene_snapshot {
+		public:
+			using progress_callback_t = std::function<void (float progress)>;
+
+		private:
+			struct point_t {
+				int id;
+				glm::vec3 position;
+				std::string name;
+			};
+
+			std::vector<point_t> m_points;
+			std::vector<json> m_geometry;
+
+			friend class scene_serializer;
+
+		public:
+			scene_snapshot () = default;
+
+			std::size_t get_num_objects () const;
+
+			// progress goes from zero to one over all objects
+			std::string get_data (const progress_callback_t & progress = nullptr) const;
+			std::string get_binary_data (const progress_callback_t & progress = nullptr) const;
+	};
+
 	class scene_serializer {
 		private:
 			struct scene_serializer_node {
@@ -67,8 +110,13 @@ namespace mini {
 			~scene_serializer ();
 
 			std::string get_data ();
+			std::string get_binary_data ();
+			scene_snapshot get_snapshot ();
 			bool add_object (std::shared_ptr<scene_obj_t> object);
 
+			// the scene to file id mapping of the last snapshot, leaves the serializer empty
+			cache_object_id_t take_cache ();
+
 			void reset ();
 	};
 
@@ -79,6 +127,22 @@ namespace mini {
 				std::shared_ptr<scene_obj_t> object;
 			};
 
+			struct point_record_t {
+				int id;
+				glm::vec3 position;
+				std::string name;
+			};
+
+			// geometry object waiting to be prepared by a worker
+			struct load_job_t {
+				json data;
+				int id;
+				object_builder_t builder;
+				std::string error;
+			};
+
+			class sax_handler;
+
 			cache_id_object_t m_cache;
 			bool m_ready;
 
@@ -88,6 +152,14 @@ namespace mini {
 			scene_controller_base & m_scene;
 			std::shared_ptr<resource_store> m_store;
 
+			// streaming load state, jobs never move once pushed
+			std::deque<load_job_t> m_jobs;
+			std::size_t m_next_job;
+			bool m_parse_done;
+
+			std::mutex m_jobs_mutex;
+			std::condition_variable m_jobs_cond;
+
 		public:
 			scene_deserializer (scene_controller_base & scene, std::shared_ptr<resource_store> store);
 			scene_deserializer (scene_controller_base & scene, std::shared_ptr<resource_store> store, const std::string & data);
@@ -95,6 +167,13 @@ namespace mini {
 
 			bool load_safe (const std::string & data);
 			void load (const std::string & data);
+			void load_json (const json & scene);
+
+			// streams the file instead of building a document, geometry is prepared
+			// on worker threads while the rest of the file is still being parsed,
+			// binary scenes are recognized and loaded through load_binary
+			void load_file (const std::string & path);
+			void load_binary (const std::string & path);
 
 			void reset ();
 			bool has_next ();
@@ -104,6 +183,12 @@ namespace mini {
 			void m_init_deserializers ();
 			void m_deserialize_point (const json & data);
 			void m_deserialize_object (const json & data);
+			void m_add_point (int id, const std::string & name, const glm::vec3 & position);
+			void m_add_object (int id, const object_builder_t & builder);
+
+			void m_push_job (json && data);
+			void m_prepare_worker ();
+			void m_prepare_job (load_job_t & job) const;
 	};
 
 	class empty_object_serializer : public object_serializer_base {
@@ -141,5 +226,7 @@ namespace mini {
 
 			virtual std::shared_ptr<scene_obj_t> deserialize (scene_controller_base & scene, std::shared_ptr<resource_store> store, 
 				const json & data, cache_id_object_t & cache) const override;
+
+			virtual object_builder_t prepare (const json & data) const override;
 	};
 }
\ No newline at end of file
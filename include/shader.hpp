@@ -1,11 +1,41 @@
 #pragma once
+#include <array>
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
 #include <stdexcept>
 #include <glad/glad.h>
 
 #include "algebra.hpp"
 
 namespace mini {
+	// uniform block shared by all programs, filled once per frame by the context
+	// the layout has to match app_context::camera_block_t
+	constexpr const char * camera_block_name = "camera_block";
+	constexpr GLuint camera_block_binding = 0;
+
+	// object id written to the pick attachment, updated by the context per draw
+	constexpr const char * pick_block_name = "pick_block";
+	constexpr GLuint pick_block_binding = 1;
+
+	// uniforms set for every drawn object, their locations are resolved once
+	// per program after linking so that a draw does not look up their names
+	enum class shader_uniform_t : uint32_t {
+		world,
+		color,
+		line_width,
+		resolution_u,
+		resolution_v,
+		vertical,
+		domain_sampler,
+		start_t,
+		end_t,
+		size,
+		center,
+		count
+	};
+
 	enum class shader_error_type_t {
 		compile_shader,
 		link_program
@@ -34,6 +64,10 @@ namespace mini {
 			GLuint m_program, m_ps, m_vs, m_gs, m_tcs, m_tes;
 			bool m_is_ready, m_has_geometry, m_has_tesselation;
 
+			// active uniform locations, resolved once after linking
+			std::unordered_map<std::string, GLint> m_locations;
+			std::array<GLint, static_cast<std::size_t> (shader_uniform_t::count)> m_object_locations;
+
 		public:
 			void set_vertex_source (const std::string & source);
 			void set_fragment_source (const std::string & source);
@@ -41,6 +75,14 @@ namespace mini {
 			void set_tesselation_source (const std::string & tcs, const std::string & tes);
 			bool compile ();
 
+			// links the program from a binary retrieved earlier with get_binary,
+			// returns false and leaves the shader untouched if the driver rejects it
+			bool load_binary (GLenum format, const std::vector<uint8_t> & binary);
+			bool get_binary (GLenum & format, std::vector<uint8_t> & binary) const;
+
+			// all stage sources, identifies the program for caching
+			std::string get_combined_source () const;
+
 			bool is_ready () const;
 			
 			shader_t ();
@@ -54,7 +96,19 @@ namespace mini {
 			void bind () const;
 			GLuint get_program_handle () const;
 
-			int get_uniform_location (const std::string & name);
+			// locations are cached, -1 if the program has no such active uniform
+			int get_uniform_location (const std::string & name) const;
+			int get_uniform_location (shader_uniform_t uniform) const;
+
+			void set_uniform_sampler (GLint location, const GLint value);
+			void set_uniform_int (GLint location, const GLint value);
+			void set_uniform_uint (GLint location, const GLuint value);
+			void set_uniform (GLint location, const float value);
+			void set_uniform (GLint location, const glm::vec2 & vector);
+			void set_uniform (GLint location, const glm::vec3 & vector);
+			void set_uniform (GLint location, const glm::vec4 & vector);
+			void set_uniform (GLint location, const glm::mat3x3 & matrix);
+			void set_uniform (GLint location, const glm::mat4x4 & matrix);
 
 			void set_uniform_sampler (const std::string & name, const GLint value);
 			void set_uniform_int (const std::string & name, const GLint value);
@@ -69,5 +123,7 @@ namespace mini {
 		private:
 			bool m_try_compile (GLenum shader_type, const std::string & source, GLuint * out_shader);
 			bool m_try_link ();
+			void m_cache_locations ();
+			void m_bind_blocks ();
 	};
 }
\ No newline at end of file
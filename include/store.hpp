@@ -1,32 +1,77 @@
 #pragma once
 #include <unordered_map>
 #include <memory>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
 
 #include "shader.hpp"
 #include "texture.hpp"
+#include "progcache.hpp"
 
 namespace mini {
+	// lazy registry of shaders and textures, programs are built the first time
+	// they are requested, only the ones marked as eager in the manifest are
+	// built when the store is created
 	class resource_store final {
 		private:
-			std::shared_ptr<shader_t> m_basic_shader, m_grid_xz_shader, m_grid_xy_shader;
-			std::shared_ptr<shader_t> m_billboard_shader, m_billboard_shader_s;
-			std::shared_ptr<shader_t> m_mesh_shader, m_alt_mesh_shader;
-			std::shared_ptr<shader_t> m_bezier_shader, m_bezier_poly_shader;
-			std::shared_ptr<shader_t> m_line_shader;
-			std::shared_ptr<shader_t> m_bezier_surf_shader, m_bezier_surf_solid_shader;
-			std::shared_ptr<shader_t> m_bspline_surf_shader, m_bspline_surf_solid_shader;
-			std::shared_ptr<shader_t> m_gregory_surf_shader, m_gregory_surf_solid_shader;
-			std::shared_ptr<shader_t> m_box_select_shader;
-			std::shared_ptr<shader_t> m_gizmo_shader;
+			// every program the store knows about, the manifest in store.cpp
+			// lists the stage files for each of them in the same order
+			enum class shader_id_t : std::size_t {
+				basic,
+				mesh,
+				alt_mesh,
+				grid_xz,
+				grid_xy,
+				billboard,
+				billboard_s,
+				point,
+				bezier,
+				bezier_poly,
+				line,
+				bezier_surf,
+				bezier_surf_solid,
+				bspline_surf,
+				bspline_surf_solid,
+				gregory_surf,
+				gregory_surf_solid,
+				box_select,
+				gizmo,
+				count
+			};
+
+			static constexpr std::size_t c_num_shaders = static_cast<std::size_t> (shader_id_t::count);
+
+			struct shader_sources_t {
+				std::string vs, ps, tcs, tes, gs;
+			};
+
+			program_cache m_program_cache;
+			mutable uint32_t m_programs_cached, m_programs_compiled;
+
+			// failed builds are marked as built too so they are not retried every frame
+			mutable std::array<std::shared_ptr<shader_t>, c_num_shaders> m_shaders;
+			mutable std::array<bool, c_num_shaders> m_shaders_built;
 
 			std::shared_ptr<texture_t> m_cursor_texture, m_point_texture;
 
+			// background warm up, the worker thread only reads the sources
+			// since programs can only be linked where the gl context is current
+			std::thread m_warm_up_thread;
+			std::atomic<bool> m_warm_up_cancel, m_warm_up_read;
+			std::mutex m_warm_up_mutex;
+			std::deque<std::pair<shader_id_t, shader_sources_t>> m_warm_up_queue;
+			uint32_t m_warm_up_built;
+
 		public:
 			std::shared_ptr<shader_t> get_basic_shader () const;
 			std::shared_ptr<shader_t> get_grid_xz_shader () const;
 			std::shared_ptr<shader_t> get_grid_xy_shader () const;
 			std::shared_ptr<shader_t> get_billboard_shader () const;
 			std::shared_ptr<shader_t> get_billboard_s_shader () const;
+			std::shared_ptr<shader_t> get_point_shader () const;
 			std::shared_ptr<shader_t> get_mesh_shader () const;
 			std::shared_ptr<shader_t> get_alt_mesh_shader () const;
 			std::shared_ptr<shader_t> get_bezier_shader () const;
@@ -46,18 +91,23 @@ namespace mini {
 
 		public:
 			resource_store ();
-			~resource_store () = default;
+			~resource_store ();
 
 			resource_store (const resource_store &) = delete;
 			resource_store & operator= (const resource_store &) = delete;
 
+			// starts reading the sources of all programs that were not built yet
+			void begin_warm_up ();
+
+			// links at most max_programs of the programs read by the warm up,
+			// meant to be called once per frame from the main thread
+			void warm_up (uint32_t max_programs = 1);
+
 		private:
 			std::string m_read_file_content (const std::string & path) const;
-			std::shared_ptr<shader_t> m_load_shader (const std::string & vs_file, const std::string & ps_file) const;
-			std::shared_ptr<shader_t> m_load_shader (const std::string & vs_file, const std::string & ps_file, const std::string & gs_file) const;
-			std::shared_ptr<shader_t> m_load_shader (const std::string & vs_file, const std::string & ps_file, 
-				const std::string & tcs_file, const std::string & tes_file) const;
-			std::shared_ptr<shader_t> m_load_shader (const std::string & vs_file, const std::string & ps_file,
-				const std::string & tcs_file, const std::string & tes_file, const std::string & gs_file) const;
+			shader_sources_t m_read_sources (shader_id_t id) const;
+			std::shared_ptr<shader_t> m_get_shader (shader_id_t id) const;
+			std::shared_ptr<shader_t> m_build_shader (shader_id_t id, const shader_sources_t & sources) const;
+			void m_warm_up_worker (std::vector<shader_id_t> ids);
 	};
-}
\ No newline at end of file
+}
@@ -1,36 +1,14 @@
 #pragma once
+#include <unordered_map>
+
 #include "object.hpp"
 #include "bezier.hpp"
 #include "trimmable.hpp"
+#include "diffsurf.hpp"
+#include "bvh.hpp"
+#include "aligned.hpp"
 
 namespace mini {
-	class differentiable_surface_base {
-		public:
-			// domain information
-			virtual float get_min_u() const = 0;
-			virtual float get_max_u() const = 0;
-			virtual float get_min_v() const = 0;
-			virtual float get_max_v() const = 0;
-
-			// surface point
-			virtual glm::vec3 sample(float u, float v) const = 0;
-
-			// normal
-			virtual glm::vec3 normal(float u, float v) const = 0;
-
-			// first derivatives
-			virtual glm::vec3 ddu(float u, float v) const = 0;
-			virtual glm::vec3 ddv(float u, float v) const = 0;
-
-			virtual ~differentiable_surface_base() {}
-
-			virtual bool is_u_wrapped() const = 0;
-			virtual bool is_v_wrapped() const = 0;
-
-			virtual bool is_trimmable() const;
-			virtual trimmable_surface_domain& get_trimmable_domain();
-	};
-
 	class bicubic_surface : public point_family_base {
 		public:
 			struct surface_patch {
@@ -76,11 +54,23 @@ namespace mini {
 
 			trimmable_surface_domain m_domain;
 
+			// patch-major snapshot of the control points, 16 per patch,
+			// refreshed by the moved handler and rebuilt on topology changes
+			aligned_vector<glm::vec3> m_net;
+			std::unordered_map<uint64_t, std::vector<unsigned int>> m_point_slots;
+
+			// patch bounds computed from the control net
+			patch_bvh m_bvh;
+
 		protected:
 			const std::vector<point_ptr> & t_get_points () const;
 
+			// patch-major control net, null until the patch indices are known
+			const glm::vec3 * t_get_control_net () const;
+
 		public:
 			trimmable_surface_domain& get_domain();
+			const patch_bvh & get_patch_bvh () const;
 
 			bool is_showing_polygon () const;
 			void set_showing_polygon (bool show);
@@ -136,6 +126,7 @@ namespace mini {
 			virtual void configure () override;
 			virtual void integrate (float delta_time) override;
 			virtual void render (app_context & context, const glm::mat4x4 & world_matrix) const override;
+			virtual render_key_t get_render_key () const override;
 
 			using serialized_patch = std::array<uint64_t, 16>;
 
@@ -151,6 +142,8 @@ namespace mini {
 			bool m_calc_pos_buffer ();
 			void m_update_buffers ();
 			void m_destroy_buffers ();
+			void m_rebuild_control_net ();
+			aabb_t m_calc_patch_bounds (unsigned int patch) const;
 			void m_moved_sighandler (signal_event_t sig, scene_obj_t & sender);
 			void m_setup_signals ();
 
@@ -24,6 +24,7 @@ namespace mini {
 			GLenum get_min_filter () const;
 			GLenum get_mag_filter () const;
 			GLenum get_format () const;
+			GLuint get_handle () const;
 
 			texture_t (uint32_t width, uint32_t height, unsigned char * data);
 			texture_t (uint32_t width, uint32_t height, unsigned char * data, GLenum format, 
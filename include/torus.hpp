@@ -25,6 +25,11 @@ namespace mini {
 			
 			trimmable_surface_domain m_domain;
 
+			// patch bounds in world space and the state they were computed for
+			patch_bvh m_bvh;
+			glm::mat4x4 m_bvh_matrix;
+			float m_bvh_inner_radius, m_bvh_outer_radius;
+
 		public:
 			torus_object (scene_controller_base & scene, std::shared_ptr<shader_t> shader, float inner_radius, float outer_radius);
 			~torus_object ();
@@ -32,7 +37,9 @@ namespace mini {
 			torus_object (const torus_object &) = delete;
 			torus_object & operator= (const torus_object &) = delete;
 
+			virtual void integrate (float delta_time) override;
 			virtual void render (app_context & context, const glm::mat4x4 & world_matrix) const override;
+			virtual render_key_t get_render_key() const override;
 			virtual void configure () override;
 			virtual const object_serializer_base & get_serializer () const;
 
@@ -66,9 +73,12 @@ namespace mini {
 
 			virtual bool is_trimmable() const;
 			virtual trimmable_surface_domain& get_trimmable_domain();
+			virtual const patch_bvh* get_bvh() const override;
 
 		private:
 			void m_rebuild ();
+			bool m_is_bvh_valid () const;
+			void m_update_bvh ();
 			void m_generate_geometry ();
 
 			void m_build_geometry (
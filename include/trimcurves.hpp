@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "algebra.hpp"
+#include "trimmask.hpp"
+
+namespace mini {
+	// vector representation of a trimmed [0,1]^2 parameter domain
+	// trimming curves are kept as uv polylines, every curve is closed along
+	// the domain boundary into a loop and a point is classified by the parity
+	// of each loop around it, regions are hidden or shown by toggling
+	// such parity signatures, queries use a uniform grid over the segments
+	class trim_curves {
+		private:
+			static constexpr int c_grid_res = 64;
+
+			using signature_t = std::vector<uint64_t>;
+
+			struct toggle_t {
+				uint32_t num_loops;
+				signature_t signature;
+			};
+
+			bool m_wrap_u, m_wrap_v;
+			bool m_hidden;
+
+			// curves as traced, split at wrapped edges and joined at shared ends
+			std::vector<std::vector<glm::vec2>> m_curves;
+
+			// closed loops stored back to back, loop i occupies the vertices
+			// [m_loop_offsets[i], m_loop_offsets[i + 1]) and the last vertex
+			// connects back to the first one
+			std::vector<glm::vec2> m_loop_points;
+			std::vector<uint32_t> m_loop_offsets;
+
+			// segments overlapping each grid cell, a segment is identified
+			// by the index of its first vertex in m_loop_points
+			std::vector<std::vector<uint32_t>> m_cells;
+			std::vector<uint32_t> m_segment_loops;
+
+			std::vector<toggle_t> m_toggles;
+
+		public:
+			trim_curves();
+
+			void set_wrapping(bool wrap_u, bool wrap_v);
+
+			// adds a curve given by its start and parameter increments before wrapping
+			void add_curve(const glm::vec2 & start, const std::vector<glm::vec2> & directions);
+
+			void clear();
+			void flip();
+			void toggle_region(const glm::vec2 & uv);
+
+			bool empty() const;
+			bool is_visible(const glm::vec2 & uv) const;
+
+			std::size_t get_num_curves() const;
+			const std::vector<glm::vec2> & get_curve(std::size_t index) const;
+
+			// writes the visible and hidden state of every texel center into the mask
+			void rasterize(trim_mask & mask, uint8_t visible, uint8_t hidden) const;
+
+		private:
+			void m_add_piece(std::vector<glm::vec2> & piece);
+			void m_rebuild();
+			void m_close_loop(const std::vector<glm::vec2> & curve);
+
+			void m_signature(const glm::vec2 & uv, signature_t & signature) const;
+			bool m_is_hidden(const signature_t & signature) const;
+	};
+}
\ No newline at end of file
@@ -4,11 +4,13 @@
 
 #include "context.hpp"
 #include "algebra.hpp"
+#include "trimmask.hpp"
+#include "trimcurves.hpp"
 
 namespace mini {
 	class trimmable_surface_domain {
 		private:
-			std::vector<uint8_t> m_domain;
+			trim_mask m_domain;
 
 			uint32_t m_domain_width;
 			uint32_t m_domain_height;
@@ -16,6 +18,15 @@ namespace mini {
 			float m_min_u, m_min_v;
 			float m_max_u, m_max_v;
 
+			// wrapped parameters connect opposite edges of the domain
+			bool m_wrap_u, m_wrap_v;
+
+			// in vector mode the curves are the source of truth
+			// and the mask is only a cached view used for rendering
+			trim_curves m_curves;
+			bool m_vector_mode;
+			bool m_raster_outdated;
+
 			GLuint m_texture;
 
 		public:
@@ -35,15 +46,25 @@ namespace mini {
 			void trim_curve(const std::vector<glm::vec2>& curve_points);
 			void trim_directions(const glm::vec2& start, const std::vector<glm::vec2>& directions);
 			void update_texture();
+			void set_wrapping(bool wrap_u, bool wrap_v);
+
+			bool is_vector_mode() const;
+			void set_vector_mode(bool vector_mode);
+
+			// visibility of a point given by parameters in [0,1]
+			bool is_visible(float u, float v) const;
+			const trim_curves & get_curves() const;
 
 			void bind(uint32_t slot) const;
+			GLuint get_texture_handle() const;
 			void configure();
 
 			uint8_t at(int32_t x, int32_t y) const;
 
 		private:
-			void m_draw_line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint8_t color);
+			void m_draw_uv_line(const glm::vec2 & a, const glm::vec2 & b, uint8_t color);
 			void m_flood_fill(int32_t x, int32_t y);
+			void m_rasterize_curves();
 
 			void m_init_texture();
 			void m_free_texture();
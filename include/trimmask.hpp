@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace mini {
+	// single channel trimming mask stored in square tiles so that changed
+	// regions can be tracked and uploaded separately, it does not depend
+	// on gl and can be used headless
+	class trim_mask {
+		public:
+			static constexpr uint32_t tile_shift = 6;
+			static constexpr uint32_t tile_size = 1 << tile_shift;
+			static constexpr uint32_t tile_area = tile_size * tile_size;
+
+		private:
+			uint32_t m_width, m_height;
+			uint32_t m_tiles_x, m_tiles_y;
+
+			// tile-major storage, every tile is a contiguous tile_size^2 block
+			std::vector<uint8_t> m_data;
+			std::vector<uint8_t> m_dirty;
+			bool m_any_dirty;
+
+		public:
+			trim_mask(uint32_t width, uint32_t height, uint8_t value);
+
+			uint32_t get_width() const;
+			uint32_t get_height() const;
+			uint32_t get_tiles_x() const;
+			uint32_t get_tiles_y() const;
+
+			uint8_t get(uint32_t x, uint32_t y) const;
+			void set(uint32_t x, uint32_t y, uint8_t value);
+
+			void fill(uint8_t value);
+			void swap_values(uint8_t a, uint8_t b);
+
+			// replaces the connected region of texels equal to the one at (x, y),
+			// wrapped axes connect the first and the last column or row
+			// returns the number of texels that were changed
+			std::size_t flood_fill(uint32_t x, uint32_t y, uint8_t value, bool wrap_x, bool wrap_y);
+
+			// texel at parameters in [0, 1], the one whose center (t + 0.5) / size
+			// is closest as sampled by trim_curves::rasterize, wrapped axes take
+			// the parameter modulo one and the others clamp it to the border
+			uint8_t sample(float u, float v, bool wrap_x, bool wrap_y) const;
+
+			// segment between two parameter points with the same mapping, on wrapped
+			// axes it may leave [0, 1] and goes on from the opposite side, a jump
+			// of more than half the domain is taken the short way across the seam
+			void draw_uv_line(float u0, float v0, float u1, float v1, uint8_t value, bool wrap_x, bool wrap_y);
+
+			// tile data has a row stride of tile_size, tiles on the right
+			// and bottom border may be only partially covered by the mask
+			const uint8_t * get_tile(uint32_t tx, uint32_t ty) const;
+
+			bool is_dirty() const;
+			bool is_tile_dirty(uint32_t tx, uint32_t ty) const;
+			void mark_all_dirty();
+			void clear_dirty();
+
+		private:
+			std::size_t m_offset(uint32_t x, uint32_t y) const;
+			void m_mark_dirty(uint32_t x, uint32_t y);
+
+			// unwrapped texel coordinate, only non wrapped axes are clamped
+			int32_t m_to_texel(float t, uint32_t size, bool wrap) const;
+
+			// every texel of the line is taken modulo the mask size
+			void m_draw_line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint8_t value);
+	};
+}
\ No newline at end of file
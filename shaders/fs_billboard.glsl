@@ -3,10 +3,17 @@
 in vec4 vertex_color;
 in vec2 uv;
 
-out vec4 output_color;
+layout (location = 0) out vec4 output_color;
+layout (location = 1) out uint output_id;
+
+// id of the drawn object for viewport picking
+layout (std140) uniform pick_block {
+    uint u_object_id;
+};
 
 uniform sampler2D u_sampler;
 
 void main () {
     output_color = vertex_color * texture(u_sampler, uv);
+    output_id = u_object_id;
 }
\ No newline at end of file
@@ -3,8 +3,15 @@
 in vec4 vertex_color;
 in vec2 uv;
 
-out vec4 output_color;
+layout (location = 0) out vec4 output_color;
+layout (location = 1) out uint output_id;
+
+// id of the drawn object for viewport picking
+layout (std140) uniform pick_block {
+    uint u_object_id;
+};
 
 void main () {
     output_color = vec4 (vertex_color.xyz, 0.35);
+    output_id = u_object_id;
 }
\ No newline at end of file
@@ -6,7 +6,13 @@ in vec3 local_pos;
 in vec3 view_pos;
 in vec3 proj_pos;
 
-out vec4 output_color;
+layout (location = 0) out vec4 output_color;
+layout (location = 1) out uint output_id;
+
+// id of the drawn object for viewport picking
+layout (std140) uniform pick_block {
+    uint u_object_id;
+};
 
 uniform float u_grid_spacing;
 
@@ -24,4 +30,5 @@ void main () {
 
     intensity = min (1.0, (10.0 / distance) * intensity);
     output_color = intensity * vec4 (0.5,0.5,0.5,0.8);
+    output_id = u_object_id;
 }
\ No newline at end of file
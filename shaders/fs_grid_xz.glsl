@@ -6,7 +6,13 @@ in vec3 local_pos;
 in vec3 view_pos;
 in vec3 proj_pos;
 
-out vec4 output_color;
+layout (location = 0) out vec4 output_color;
+layout (location = 1) out uint output_id;
+
+// id of the drawn object for viewport picking
+layout (std140) uniform pick_block {
+    uint u_object_id;
+};
 
 uniform float u_grid_spacing;
 uniform vec3 u_focus_position;
@@ -36,4 +42,5 @@ void main () {
     float zi = 1.0 - step (0.05, d_az);
 
     output_color = intensity * vec4 (0.4 + xi, 0.4 - zi - xi, 0.4 + zi, 0.7);
+    output_id = u_object_id;
 }
\ No newline at end of file
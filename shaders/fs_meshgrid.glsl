@@ -9,7 +9,13 @@ in VS_OUT {
     vec4 proj_pos;
 } fs_in;
 
-out vec4 output_color;
+layout (location = 0) out vec4 output_color;
+layout (location = 1) out uint output_id;
+
+// id of the drawn object for viewport picking
+layout (std140) uniform pick_block {
+    uint u_object_id;
+};
 
 uniform sampler2D u_domain_sampler;
 uniform vec4 u_color;
@@ -37,4 +43,5 @@ void main () {
 
     vec4 color = domain_alpha * intensity * vec4 (u_color.rgb, 1.0);
     output_color = color;
+    output_id = u_object_id;
 }
\ No newline at end of file
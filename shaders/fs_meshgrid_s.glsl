@@ -6,7 +6,13 @@ in vec4 local_pos;
 in vec4 view_pos;
 in vec4 proj_pos;
 
-out vec4 output_color;
+layout (location = 0) out vec4 output_color;
+layout (location = 1) out uint output_id;
+
+// id of the drawn object for viewport picking
+layout (std140) uniform pick_block {
+    uint u_object_id;
+};
 
 float grid_color () {
     vec2 coord = vertex_uv.xy;
@@ -25,4 +31,5 @@ void main () {
 
     vec4 color = intensity * vec4 (0.960, 0.646, 0.0192, 1.0);
     output_color = color;
+    output_id = u_object_id;
 }
\ No newline at end of file
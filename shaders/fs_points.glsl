@@ -0,0 +1,15 @@
+#version 330
+
+in vec4 vertex_color;
+in vec2 uv;
+flat in uint object_id;
+
+layout (location = 0) out vec4 output_color;
+layout (location = 1) out uint output_id;
+
+uniform sampler2D u_sampler;
+
+void main () {
+    output_color = vertex_color * texture(u_sampler, uv);
+    output_id = object_id;
+}
\ No newline at end of file
@@ -1,9 +1,16 @@
 #version 330
 
-out vec4 output_color;
+layout (location = 0) out vec4 output_color;
+layout (location = 1) out uint output_id;
+
+// id of the drawn object for viewport picking
+layout (std140) uniform pick_block {
+    uint u_object_id;
+};
 
 uniform vec4 u_color;
 
 void main () {
     output_color = u_color;
+    output_id = u_object_id;
 }
\ No newline at end of file
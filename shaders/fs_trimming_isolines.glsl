@@ -4,7 +4,13 @@ in GS_OUT {
     vec2 uv;
 } fs_in;
 
-out vec4 output_color;
+layout (location = 0) out vec4 output_color;
+layout (location = 1) out uint output_id;
+
+// id of the drawn object for viewport picking
+layout (std140) uniform pick_block {
+    uint u_object_id;
+};
 
 uniform sampler2D u_domain_sampler;
 uniform vec4 u_color;
@@ -17,4 +23,5 @@ void main () {
     }
 
     output_color = u_color * alpha;
+    output_id = u_object_id;
 }
\ No newline at end of file
@@ -1,7 +1,14 @@
 #version 330
 
-out vec4 output_color;
+layout (location = 0) out vec4 output_color;
+layout (location = 1) out uint output_id;
+
+// id of the drawn object for viewport picking
+layout (std140) uniform pick_block {
+    uint u_object_id;
+};
 
 void main () {
     output_color = vec4(1.0);
+    output_id = u_object_id;
 }
\ No newline at end of file
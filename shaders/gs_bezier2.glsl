@@ -3,8 +3,13 @@
 layout (lines_adjacency) in;
 layout (triangle_strip, max_vertices = 16) out;
 
-// screen resolution
-uniform vec2 u_resolution;
+// camera and screen resolution
+layout (std140) uniform camera_block {
+    mat4 u_view;
+    mat4 u_projection;
+    vec2 u_resolution;
+};
+
 uniform float u_line_width;
 
 void make_line (vec4 p1, vec4 p2) {
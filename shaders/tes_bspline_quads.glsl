@@ -11,8 +11,12 @@ out TES_OUT {
 } tes_out;
 
 uniform mat4 u_world;
-uniform mat4 u_view;
-uniform mat4 u_projection;
+
+layout (std140) uniform camera_block {
+    mat4 u_view;
+    mat4 u_projection;
+    vec2 u_resolution;
+};
 
 float deboor (float b00, float b01, float b02, float b03, float t) {
     float N00 = 1.0;
@@ -3,8 +3,13 @@
 layout (isolines) in;
 
 uniform mat4 u_world;
-uniform mat4 u_view;
-uniform mat4 u_projection;
+
+layout (std140) uniform camera_block {
+    mat4 u_view;
+    mat4 u_projection;
+    vec2 u_resolution;
+};
+
 uniform bool u_vertical;
 
 float decasteljeu (float b00, float b01, float b02, float b03, float t) {
@@ -4,12 +4,15 @@ layout (location = 0) in vec3 a_position;
 layout (location = 1) in vec4 a_color;
 layout (location = 2) in vec2 a_uv;
 
-uniform mat4 u_view;
-uniform mat4 u_projection;
+layout (std140) uniform camera_block {
+    mat4 u_view;
+    mat4 u_projection;
+    vec2 u_resolution;
+};
+
 uniform vec3 u_center;
 uniform vec4 u_color;
 uniform vec2 u_size;
-uniform vec2 u_resolution;
 
 out vec4 vertex_color;
 out vec2 uv;
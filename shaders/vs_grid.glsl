@@ -4,8 +4,12 @@ layout (location = 0) in vec3 a_position;
 layout (location = 1) in vec4 a_color;
 
 uniform mat4 u_world;
-uniform mat4 u_view;
-uniform mat4 u_projection;
+
+layout (std140) uniform camera_block {
+    mat4 u_view;
+    mat4 u_projection;
+    vec2 u_resolution;
+};
 
 out vec4 vertex_color;
 out vec3 local_pos;
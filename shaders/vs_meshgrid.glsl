@@ -5,8 +5,12 @@ layout (location = 1) in vec2 a_uv;
 layout (location = 2) in vec2 a_tex_uv;
 
 uniform mat4 u_world;
-uniform mat4 u_view;
-uniform mat4 u_projection;
+
+layout (std140) uniform camera_block {
+    mat4 u_view;
+    mat4 u_projection;
+    vec2 u_resolution;
+};
 
 out VS_OUT {
     vec2 vertex_uv;
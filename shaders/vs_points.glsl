@@ -0,0 +1,41 @@
+#version 330
+
+layout (location = 0) in vec3 a_position;
+layout (location = 2) in vec2 a_uv;
+layout (location = 3) in uint a_slot;
+layout (location = 4) in uint a_pick_id;
+
+layout (std140) uniform camera_block {
+    mat4 u_view;
+    mat4 u_projection;
+    vec2 u_resolution;
+};
+
+uniform vec2 u_size;
+
+// two texels per point, position followed by color
+uniform samplerBuffer u_points;
+
+out vec4 vertex_color;
+out vec2 uv;
+flat out uint object_id;
+
+void main () {
+    int base = int (a_slot) * 2;
+
+    vec4 center = texelFetch (u_points, base);
+    vec3 scaled_pos = vec3 (
+        u_size.x * a_position.x / u_resolution.x, 
+        u_size.y * a_position.y / u_resolution.y, 
+        a_position.z
+    );
+
+    vertex_color = texelFetch (u_points, base + 1);
+    uv = a_uv;
+    object_id = a_pick_id;
+
+    gl_Position = u_projection * u_view * vec4 (center.xyz, 1.0);
+    gl_Position = gl_Position / gl_Position.w;
+
+    gl_Position.xy += scaled_pos.xy;
+}
\ No newline at end of file
@@ -3,8 +3,12 @@
 layout (location = 0) in vec3 a_position;
 
 uniform mat4 u_world;
-uniform mat4 u_view;
-uniform mat4 u_projection;
+
+layout (std140) uniform camera_block {
+    mat4 u_view;
+    mat4 u_projection;
+    vec2 u_resolution;
+};
 
 void main () {
     gl_Position = u_projection * u_view * u_world * vec4 (a_position, 1.0);
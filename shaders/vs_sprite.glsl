@@ -7,7 +7,12 @@ layout (location = 2) in vec2 a_uv;
 uniform mat4 u_world;
 uniform vec4 u_color;
 uniform vec2 u_size;
-uniform vec2 u_resolution;
+
+layout (std140) uniform camera_block {
+    mat4 u_view;
+    mat4 u_projection;
+    vec2 u_resolution;
+};
 
 out vec4 vertex_color;
 out vec2 uv;
@@ -1,11 +1,13 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <filesystem>
 
 #include <nfd.h>
 
 #include "gui.hpp"
 #include "app.hpp"
+#include "profiler.hpp"
 #include "point.hpp"
 #include "serializer.hpp"
 #include "gapfilling.hpp"
@@ -15,9 +17,13 @@
 namespace mini {
 	constexpr const std::string_view app_title = "modelowanie geometryczne 1";
 
+	// seconds between autosave flushes
+	constexpr float autosave_interval = 5.0f;
+
 	application::object_wrapper_t::object_wrapper_t (std::shared_ptr<scene_obj_t> o, const std::string & name) : object (o), name (name), selected (false) {
 		tmp_name = name;
 		destroy = false;
+		indexed = false;
 
 		object->set_name (name);
 	}
@@ -163,13 +169,10 @@ namespace mini {
 	}
 
 	void application::select_by_id (uint64_t id) {
-		auto iter = m_id_cache.find (id);
+		auto wrapper = m_objects.find (id);
 
-		if (iter != m_id_cache.end ()) {
-			auto object_ptr = iter->second.lock ();
-			if (object_ptr) {
-				m_group_select_add (object_ptr);
-			}
+		if (wrapper) {
+			m_group_select_add (*wrapper);
 		}
 	}
 
@@ -178,18 +181,10 @@ namespace mini {
 	}
 
 	void application::refresh_by_id(uint64_t id) {
-		auto object = get_object(id);
-
-		if (object) {
-			auto it = m_name_cache.find(id);
-			if (it != m_name_cache.end()) {
-				auto old_name = it->second;
+		auto wrapper = m_objects.find(id);
 
-				it->second = object->get_name();
-				
-				m_taken_names.erase(old_name);
-				m_taken_names.insert(it->second);
-			}
+		if (wrapper) {
+			m_objects.rename((*wrapper)->handle, (*wrapper)->object->get_name());
 		}
 	}
 
@@ -251,6 +246,10 @@ namespace mini {
 		return m_points_enabled;
 	}
 
+	std::shared_ptr<point_cloud> application::get_point_cloud () const {
+		return m_point_cloud;
+	}
+
 	app_context & application::get_context () {
 		return m_context;
 	}
@@ -462,9 +461,9 @@ namespace mini {
 		gizmo::gizmo_action_t action = gizmo::gizmo_action_t::none;
 
 		if (group_size == 1) {
-			action = m_gizmo->get_action (data, m_selected_object->object->get_translation ());
+			action = m_get_gizmo ().get_action (data, m_selected_object->object->get_translation ());
 		} else {
-			action = m_gizmo->get_action (data, m_selected_group->get_origin ());
+			action = m_get_gizmo ().get_action (data, m_selected_group->get_origin ());
 		}
 
 		switch (action) {
@@ -494,12 +493,41 @@ namespace mini {
 			return;
 		}
 
+		// the id buffer already knows the frontmost object under the mouse
+		if (m_context.is_pick_enabled ()) {
+			const uint32_t picked_id = m_context.read_pick_id (
+				m_vp_mouse_offset.x, m_vp_mouse_offset.y, gpu_pick_radius_pixels);
+
+			auto picked = m_objects.find (picked_id);
+			if (picked) {
+				m_mark_object (*picked);
+			}
+
+			return;
+		}
+
 		// pass all of this to the hit detect functions
 		std::shared_ptr<object_wrapper_t> selection = nullptr;
 		glm::vec3 pos;
 		float best_dist = 1000000.0f, dist;
 
+		// points come from the spatial index
+		const uint64_t picked_id = m_pick_index.pick (m_get_pick_query (), hit_data.mouse_screen, 
+			pick_radius_pixels, get_camera ().get_position (), dist);
+
+		if (picked_id != 0UL) {
+			auto picked = m_objects.find (picked_id);
+			if (picked) {
+				selection = *picked;
+				best_dist = dist;
+			}
+		}
+
 		for (auto & object : m_objects) {
+			if (object->indexed) {
+				continue;
+			}
+
 			if (object->object->hit_test (hit_data, pos)) {
 				// hit was detected, compare hit vector with "best" hit vector
 				// i.e. select the object closer to the camera
@@ -602,7 +630,8 @@ namespace mini {
 	application::application () : 
 		app_window (1200, 800, std::string (app_title)),
 		m_context (video_mode_t (1200, 800)),
-		m_anaglyph (m_context.get_video_mode ()) {
+		m_anaglyph (m_context.get_video_mode ()),
+		m_journal ("cache/autosave") {
 
 		// render hooks
 		m_context.set_post_render (std::bind (&application::m_post_render, this, std::placeholders::_1));
@@ -611,17 +640,20 @@ namespace mini {
 		m_cam_yaw = 0.0f;
 		m_distance = 10.0f;
 		m_time = 0.0f;
+		m_autosave_time = 0.0f;
 		m_grid_spacing = 1.0f;
 		m_grid_enabled = true;
 		m_viewport_focus = false;
 		m_mouse_in_viewport = false;
 		m_points_enabled = true;
+		m_show_profiler = false;
 
 		m_last_vp_height = m_last_vp_width = 0;
 		m_test_texture = texture_t::load_from_file ("assets/test.png");
 
 		m_store = std::make_shared<resource_store> ();
 		m_factory = std::make_shared<object_factory> (m_store);
+		m_point_cloud = std::make_shared<point_cloud> (m_store->get_point_shader (), m_store->get_point_texture ());
 
 		// initialize gizmos
 		m_cursor_object = std::make_shared<billboard_object> (m_store->get_billboard_s_shader (), m_store->get_cursor_texture ());
@@ -645,13 +677,43 @@ namespace mini {
 		m_bs_top_left = { 0.0f, 0.0f };
 		m_bs_start = { 0.0f, 0.0f };
 
-		m_bs_sprite = std::make_shared<sprite> (m_store->get_box_select_shader (), nullptr);
+		// box select sprite and gizmo are created on first use
+		m_bs_sprite = nullptr;
+		m_gizmo = nullptr;
 
-		// gizmo
-		m_gizmo = std::make_shared<gizmo> (m_store->get_gizmo_shader (), m_store->get_line_shader ());
+		// build the remaining programs in the background over the next frames
+		m_store->begin_warm_up ();
 	}
 
 	void application::t_integrate (float delta_time) {
+		m_store->warm_up ();
+
+		// signals emitted since the last frame, each emitter and signal once
+		{
+			profile_scope scope ("signals");
+			t_dispatch_signals ();
+		}
+
+		std::string save_error;
+		if (!m_saver.poll (save_error)) {
+			std::cerr << "failed to save scene: " << save_error << std::endl;
+		}
+
+		// autosave writes only what changed since the last flush
+		m_journal.poll ();
+		m_autosave_time = m_autosave_time + delta_time;
+
+		if (m_autosave_time >= autosave_interval) {
+			profile_scope scope ("autosave");
+			m_autosave_time = 0.0f;
+
+			if (m_journal.needs_compaction ()) {
+				m_journal.compact (m_get_scene_objects ());
+			} else {
+				m_journal.flush (*this);
+			}
+		}
+
 		// if current tool is disposable then simply remove it
 		if (m_selected_tool) {
 			if (m_selected_tool->is_disposable ()) {
@@ -664,41 +726,50 @@ namespace mini {
 		// update the current group
 		m_selected_group->update ();
 
-		// delete objects
-		for (auto iter = m_objects.begin (); iter != m_objects.end (); ) {
-			if ((*iter)->object->is_disposed ()) {
-				(*iter)->destroy = true;
-			} else if (!(*iter)->object->is_deletabe ()) {
-				(*iter)->destroy = false;
+		// delete objects, subscribers get all deletions of this frame as one batch
+		// which is delivered before unparenting so they can still compare ids
+		std::vector<object_handle_t> destroyed;
+		begin_transaction ();
+
+		for (auto & wrapper : m_objects) {
+			if (wrapper->object->is_disposed ()) {
+				wrapper->destroy = true;
+			} else if (!wrapper->object->is_deletabe ()) {
+				wrapper->destroy = false;
 			}
 
-			if ((*iter)->destroy) {
-				if (m_selected_object && m_selected_object == *iter) {
+			if (wrapper->destroy) {
+				if (m_selected_object && m_selected_object == wrapper) {
 					m_selected_object = m_selected_group->group_pop ();
 				}
 
-				for (auto & listener : m_objects) {
-					listener->object->notify_object_deleted ((*iter)->object);
-				}
-
-				// unparent
-				auto old_id = t_unparent_object (*(*iter)->object);
-				m_id_cache.erase (old_id);
+				t_object_deleted (wrapper->object);
+				m_journal.object_deleted (*wrapper->object);
+				destroyed.push_back (wrapper->handle);
+			}
+		}
 
-				// update taken names
-				m_name_cache.erase (old_id);
-				m_taken_names.erase ((*iter)->name);
+		commit_transaction ();
 
-				iter = m_objects.erase (iter);
-			}
+		// swap and pop, every removal is constant time
+		for (const auto & handle : destroyed) {
+			auto wrapper = *m_objects.get (handle);
 
-			if (iter != m_objects.end ()) {
-				++iter;
-			}
+			m_pick_index.remove (wrapper->object->get_id ());
+			m_context.remove_retained (*wrapper->object);
+			t_unparent_object (*wrapper->object);
+			m_objects.remove (handle);
 		}
 
 		for (auto & obj : m_objects) {
-			obj->object->integrate (delta_time);
+			obj->object->set_selected (obj->selected);
+
+			if (obj->object->is_batched ()) {
+				obj->object->integrate (delta_time);
+			} else {
+				profile_object_scope scope ("integrate", obj->object.get (), obj->name);
+				obj->object->integrate (delta_time);
+			}
 		}
 
 		// if no tool selected then handle mouse events
@@ -746,24 +817,23 @@ namespace mini {
 	}
 
 	void application::t_render () {
-		for (const auto & object : m_objects) {
-			object->object->set_selected (object->selected);
-			m_context.draw (object->object, object->object->get_matrix ());
-		}
+		// scene objects stay in the render list from m_add_object until they are
+		// deleted, points enqueue themselves while they render
+		m_context.draw (m_point_cloud, glm::mat4x4 (1.0f), render_layer_t::overlay);
 		
 		if (m_grid_enabled) {
 			m_grid_xz->set_spacing (m_grid_spacing);
 			m_grid_xy->set_spacing (m_grid_spacing);
 			
 			/*if (abs (m_cam_pitch) < 0.001f) {
-				m_context.draw (m_grid_xy, make_rotation_x (pi_f / 2.0f));
+				m_context.draw (m_grid_xy, make_rotation_x (pi_f / 2.0f), render_layer_t::transparent);
 			}*/
 
-			m_context.draw (m_grid_xz, glm::mat4x4 (1.0f));
+			m_context.draw (m_grid_xz, glm::mat4x4 (1.0f), render_layer_t::transparent);
 		}
 
 		
-		m_context.draw (m_cursor_object, make_translation (m_cursor_position));
+		m_context.draw (m_cursor_object, make_translation (m_cursor_position), render_layer_t::overlay);
 
 		if (m_box_select) {
 			float bs_width = m_bs_sprite->get_size ().x;
@@ -772,7 +842,7 @@ namespace mini {
 			glm::mat4x4 bs_world (1.0f);
 			bs_world = glm::translate (bs_world, { 0.5f * bs_width + m_bs_top_left.x, 0.5f * bs_height + m_bs_top_left.y, 0 });
 
-			m_context.draw (m_bs_sprite, bs_world);
+			m_context.draw (m_bs_sprite, bs_world, render_layer_t::screen);
 		}
 
 		if (m_anaglyph.is_enabled ()) {
@@ -783,6 +853,7 @@ namespace mini {
 
 		// rendering above is done to a buffer
 		// now we can render ui to the window
+		profile_scope scope ("ui");
 
 		m_draw_main_window ();
 		m_draw_viewport ();
@@ -800,6 +871,18 @@ namespace mini {
 		if (m_show_creator) {
 			m_draw_object_creator ();
 		}
+
+		if (m_show_profiler) {
+			m_draw_profiler ();
+		}
+	}
+
+	gizmo & application::m_get_gizmo () {
+		if (!m_gizmo) {
+			m_gizmo = std::make_shared<gizmo> (m_store->get_gizmo_shader (), m_store->get_line_shader ());
+		}
+
+		return *m_gizmo;
 	}
 
 	void application::m_post_render (app_context & context) {
@@ -808,9 +891,9 @@ namespace mini {
 
 		if (m_selected_group && m_selected_group->group_size () >= 1) {
 			if (m_selected_group->group_size () == 1) {
-				m_gizmo->render (context, make_translation (m_selected_object->object->get_translation ()));
+				m_get_gizmo ().render (context, make_translation (m_selected_object->object->get_translation ()));
 			} else {
-				m_gizmo->render (context, make_translation (m_selected_group->get_origin ()));
+				m_get_gizmo ().render (context, make_translation (m_selected_group->get_origin ()));
 			}
 		}
 	}
@@ -822,6 +905,9 @@ namespace mini {
 			if (ImGui::BeginMenu ("File")) {
 				if (ImGui::MenuItem ("New", "Ctrl + N", nullptr, true)) {
 					m_new_project ();
+
+					// opening a scene starts its own base once the objects are in
+					m_journal.compact ({});
 				}
 
 				ImGui::Separator ();
@@ -830,6 +916,10 @@ namespace mini {
 					m_load_scene ();
 				}
 
+				if (ImGui::MenuItem ("Recover Autosave", nullptr, nullptr, m_journal.has_recovery ())) {
+					m_recover_scene ();
+				}
+
 				ImGui::Separator ();
 
 				if (ImGui::MenuItem ("Save As...", "Ctrl + Shift + S", nullptr, true)) {
@@ -874,6 +964,10 @@ namespace mini {
 					m_find_intersection_cursor();
 				}
 
+				if (ImGui::MenuItem("Intersect All Curves", nullptr, nullptr, selected_objects)) {
+					m_find_intersection_all();
+				}
+
 				if (ImGui::MenuItem("Debug Surface", nullptr, nullptr, selected_objects)) {
 					m_debug_surfaces();
 				}
@@ -894,6 +988,12 @@ namespace mini {
 
 				ImGui::EndMenu ();
 			}
+
+			if (m_saver.is_saving ()) {
+				ImGui::Separator ();
+				ImGui::TextDisabled ("Saving %s", m_saver.get_path ().c_str ());
+				ImGui::ProgressBar (m_saver.get_progress (), ImVec2 (120.0f, 0.0f));
+			}
 		}
 
 		ImGui::EndMenuBar ();
@@ -982,6 +1082,17 @@ namespace mini {
 
 			gui::prefix_label ("Points Enabled: ", 250.0f);
 			ImGui::Checkbox ("##points_enable", &m_points_enabled);
+
+			bool pick_enabled = m_context.is_pick_enabled ();
+
+			gui::prefix_label ("GPU Picking: ", 250.0f);
+			if (ImGui::Checkbox ("##gpu_pick_enable", &pick_enabled)) {
+				m_context.set_pick_enabled (pick_enabled);
+			}
+
+			gui::prefix_label ("Profiler: ", 250.0f);
+			ImGui::Checkbox ("##profiler_show", &m_show_profiler);
+
 			ImGui::NewLine ();
 		}
 
@@ -1095,7 +1206,14 @@ namespace mini {
 				ImGui::NewLine ();
 			}
 
+			// edits made in the object window are not always signalled
+			ImGui::BeginGroup ();
 			m_selected_object->object->configure ();
+			ImGui::EndGroup ();
+
+			if (ImGui::IsItemEdited ()) {
+				m_journal.object_changed (*m_selected_object->object);
+			}
 		}
 
 		ImGui::End ();
@@ -1125,6 +1243,35 @@ namespace mini {
 		ImGui::End ();
 	}
 
+	void application::m_draw_profiler () {
+		auto & profiler = frame_profiler::get_instance ();
+
+		ImGui::Begin ("Profiler", &m_show_profiler);
+		ImGui::SetWindowSize (ImVec2 (720, 480), ImGuiCond_Once);
+
+		const bool has_frames = !profiler.get_history ().empty ();
+
+		if (ImGui::Button ("Save Trace...", ImVec2 (0.0f, 24.0f)) && has_frames) {
+			constexpr const nfdchar_t * filters = "json";
+			nfdchar_t * out_path = nullptr;
+
+			if (NFD_SaveDialog (filters, nullptr, &out_path) == NFD_OKAY) {
+				try {
+					profiler.save_trace (std::string (out_path, strlen (out_path)));
+				} catch (const std::exception & error) {
+					std::cerr << "failed to save trace: " << error.what () << std::endl;
+				}
+
+				free (out_path);
+			}
+		}
+
+		ImGui::SameLine ();
+		profiler.configure ();
+
+		ImGui::End ();
+	}
+
 	void application::m_draw_viewport () {
 		ImGui::PushStyleVar (ImGuiStyleVar_WindowMinSize, ImVec2 (320, 240));
 		ImGui::Begin ("Viewport", NULL);
@@ -1194,7 +1341,7 @@ namespace mini {
 				return self;
 			}
 
-			name_free = (m_taken_names.find(real_name) == m_taken_names.end());
+			name_free = !m_objects.is_name_taken(real_name);
 		} while (!name_free);
 
 		return real_name;
@@ -1209,22 +1356,25 @@ namespace mini {
 		auto real_name = m_get_free_name (name);
 
 		std::shared_ptr<object_wrapper_t> wrapper = std::shared_ptr<object_wrapper_t> (new object_wrapper_t (object, real_name));
-		m_objects.push_back (wrapper);
 
 		auto id = t_parent_object (*object);
-		m_id_cache.insert ({ id, wrapper });
+		wrapper->handle = m_objects.insert (id, real_name, wrapper);
 
-		m_name_cache.insert ({ id, real_name });
-		m_taken_names.insert (real_name);
+		glm::vec3 pick_point;
+		if (object->get_pick_point (pick_point)) {
+			m_pick_index.insert (id, pick_point);
+			wrapper->indexed = true;
+		}
 
 		if (select) {
 			m_reset_selection ();
 			m_select_object (wrapper);
 		}
 
-		for (auto & o : m_objects) {
-			o->object->notify_object_created (object);
-		}
+		m_context.add_retained (object, object->get_matrix ());
+
+		m_journal.object_changed (*object);
+		t_object_created (object);
 	}
 
 	void application::m_merge_selection () {
@@ -1272,6 +1422,10 @@ namespace mini {
 		intersection_controller algorithm(*this, m_store, true);
 	}
 
+	void application::m_find_intersection_all() {
+		intersection_controller algorithm(*this, m_store, false, intersection_seeding::grid);
+	}
+
 	void application::m_debug_surfaces() {
 		for (auto iter = get_selected_objects(); iter->has(); iter->next()) {
 			auto object = iter->get_object();
@@ -1285,6 +1439,10 @@ namespace mini {
 	}
 
 	void application::m_begin_box_select () {
+		if (!m_bs_sprite) {
+			m_bs_sprite = std::make_shared<sprite> (m_store->get_box_select_shader (), nullptr);
+		}
+
 		m_box_select = true;
 		m_bs_start = {
 			static_cast<float> (m_vp_mouse_offset.x),
@@ -1295,20 +1453,73 @@ namespace mini {
 	void application::m_end_box_select () {
 		m_box_select = false;
 
+		// everything that left an id inside the box, occluded objects are not selected
+		if (m_context.is_pick_enabled ()) {
+			std::vector<uint32_t> picked_ids;
+
+			m_context.read_pick_ids (
+				static_cast<int32_t> (m_bs_top_left.x), static_cast<int32_t> (m_bs_top_left.y),
+				static_cast<int32_t> (m_bs_bottom_right.x), static_cast<int32_t> (m_bs_bottom_right.y),
+				picked_ids);
+
+			for (const auto id : picked_ids) {
+				auto object = m_objects.find (id);
+				if (object) {
+					m_group_select_add (*object);
+				}
+			}
+
+			return;
+		}
+
 		glm::vec2 screen_res = glm::vec2 (
 			static_cast<float> (m_last_vp_width),
 			static_cast<float> (m_last_vp_height)
 		);
 
 		box_test_data_t box_test (get_camera (), m_bs_top_left, m_bs_bottom_right, screen_res);
+		std::vector<uint64_t> selected_ids;
+
+		m_pick_index.select_box (m_get_pick_query (), m_bs_top_left, m_bs_bottom_right, selected_ids);
+
+		for (const auto id : selected_ids) {
+			auto object = m_objects.find (id);
+			if (object) {
+				m_group_select_add (*object);
+			}
+		}
 
 		for (auto & object : m_objects) {
-			if (object->object->box_test (box_test)) {
+			if (!object->indexed && object->object->box_test (box_test)) {
 				m_group_select_add (object);
 			}
 		}
 	}
 
+	pick_index::query_t application::m_get_pick_query () const {
+		const auto & camera = get_camera ();
+
+		return {
+			camera.get_projection_matrix () * camera.get_view_matrix (),
+			glm::vec2 (static_cast<float> (m_last_vp_width), static_cast<float> (m_last_vp_height))
+		};
+	}
+
+	void application::t_on_object_changed (scene_obj_t & object) {
+		m_journal.object_changed (object);
+
+		// moves, rotations and scaling all end up here
+		m_context.update_retained (object, object.get_matrix ());
+	}
+
+	void application::t_on_object_moved (scene_obj_t & object) {
+		glm::vec3 point;
+
+		if (object.get_id () != 0UL && object.get_pick_point (point)) {
+			m_pick_index.update (object.get_id (), point);
+		}
+	}
+
 	// this function should be the main entry point for the selection
 	// say you were to make a new selection mechanism e.g. based on keyboard
 	// and want it to be consistent with the others
@@ -1404,15 +1615,39 @@ namespace mini {
 		}
 	}
 
-	bool application::m_serialize_scene (std::string & serialized) const {
+	std::shared_ptr<const scene_snapshot> application::m_take_snapshot () const {
 		scene_serializer serializer;
 
 		for (int i = 0; i < m_objects.size (); ++i) {
 			serializer.add_object (m_objects[i]->object);
 		}
 
-		serialized = serializer.get_data ();
-		return true;
+		return std::make_shared<const scene_snapshot> (serializer.get_snapshot ());
+	}
+
+	scene_journal::object_list_t application::m_get_scene_objects () const {
+		scene_journal::object_list_t objects;
+		objects.reserve (m_objects.size ());
+
+		for (const auto & wrapper : m_objects) {
+			objects.push_back (wrapper->object);
+		}
+
+		return objects;
+	}
+
+	void application::m_add_loaded_objects (scene_deserializer & deserializer) {
+		begin_transaction ();
+
+		while (deserializer.has_next ()) {
+			auto object = deserializer.get_next ();
+			add_object (object->get_name (), object);
+		}
+
+		commit_transaction ();
+
+		// the loaded scene becomes the new autosave base
+		m_journal.compact (m_get_scene_objects ());
 	}
 
 	bool application::m_deserialize_scene (const std::string & data) {
@@ -1423,9 +1658,11 @@ namespace mini {
 		m_reset_selection ();
 		m_selected_tool = nullptr;
 		
+		m_context.clear_retained ();
 		m_objects.clear ();
-		m_id_cache.clear ();
+		m_pick_index.clear ();
 		m_project_path.clear ();
+		t_clear_subscriptions ();
 
 		set_cursor_pos ({ 0.0f, 0.0f, 0.0f });
 
@@ -1440,7 +1677,7 @@ namespace mini {
 	}
 
 	void application::m_save_scene_as () {
-		constexpr const nfdchar_t* filters = "json";
+		constexpr const nfdchar_t* filters = "json;mgsb";
 		nfdchar_t * out_path = nullptr;
 
 		nfdresult_t result = NFD_SaveDialog (filters, nullptr, &out_path);
@@ -1460,45 +1697,26 @@ namespace mini {
 
 	void application::m_save_scene () {
 		if (m_is_saved) {
-			std::string serialized;
-			
-			if (m_serialize_scene (serialized)) {
-				std::ofstream fs (m_project_path);
+			// the binary format is picked by its extension
+			const bool binary = std::filesystem::path (m_project_path).extension () == ".mgsb";
 
-				if (fs) {
-					fs << serialized;
-				} else {
-					std::cerr << "failed to open file " << m_project_path << std::endl;
-				}
-			} else {
-				std::cerr << "failed to serialize scene" << std::endl;
-			}
+			// only the snapshot is taken here, it is serialized and written in the background
+			m_saver.save (m_take_snapshot (), m_project_path, binary);
 		}
 	}
 
 	void application::m_load_scene () {
-		constexpr const nfdchar_t * filters = "json";
+		constexpr const nfdchar_t * filters = "json,mgsb";
 		nfdchar_t * in_path = nullptr;
 
 		nfdresult_t result = NFD_OpenDialog (filters, nullptr, &in_path);
 
 		if (result == NFD_OKAY) {
 			std::string path = std::string (in_path, strlen (in_path));
-			std::ifstream stream (path);
-
-			if (!stream) {
-				std::cerr << "failed to open file " << path << std::endl;
-				return;
-			}
-
-			std::stringstream ss;
-			ss << stream.rdbuf ();
-			stream.close ();
-
 			scene_deserializer deserializer (*this, m_store);
 
 			try {
-				deserializer.load (ss.str ());
+				deserializer.load_file (path);
 			} catch (const std::exception & error) {
 				std::cerr << error.what () << std::endl;
 				return;
@@ -1506,11 +1724,7 @@ namespace mini {
 
 			// clear all objects
 			m_new_project ();
-
-			while (deserializer.has_next ()) {
-				auto object = deserializer.get_next ();
-				add_object (object->get_name (), object);
-			}
+			m_add_loaded_objects (deserializer);
 
 			m_is_saved = true;
 			m_project_path = path;
@@ -1518,20 +1732,28 @@ namespace mini {
 		}
 	}
 
+	void application::m_recover_scene () {
+		scene_deserializer deserializer (*this, m_store);
+
+		try {
+			deserializer.load_json (m_journal.recover ());
+		} catch (const std::exception & error) {
+			std::cerr << "failed to recover autosave: " << error.what () << std::endl;
+			return;
+		}
+
+		// the recovered scene is not saved anywhere yet
+		m_new_project ();
+		m_add_loaded_objects (deserializer);
+		m_journal.discard_recovery ();
+	}
+
 	void application::add_object (const std::string & name, std::shared_ptr<scene_obj_t> object) {
 		m_add_object (name, object, true);
 	}
 
 	std::shared_ptr<scene_obj_t> application::get_object (uint64_t id) {
-		auto iter = m_id_cache.find (id);
-
-		if (iter != m_id_cache.end ()) {
-			auto object = iter->second.lock ();
-			if (object) {
-				return object->object;
-			}
-		}
-
-		return nullptr;
+		auto wrapper = m_objects.find (id);
+		return wrapper ? (*wrapper)->object : nullptr;
 	}
 }
\ No newline at end of file
@@ -91,12 +91,12 @@ namespace mini {
 				glBindVertexArray (m_vao);
 				m_bind_shader (context, m_shader, world_matrix);
 
-				m_shader->set_uniform ("u_start_t", 0.0f);
-				m_shader->set_uniform ("u_end_t", 0.5f);
+				m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::start_t), 0.0f);
+				m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::end_t), 0.5f);
 				glDrawArrays (GL_LINES_ADJACENCY, 0, 4);
 
-				m_shader->set_uniform ("u_start_t", 0.5f);
-				m_shader->set_uniform ("u_end_t", 1.0f);
+				m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::start_t), 0.5f);
+				m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::end_t), 1.0f);
 				glDrawArrays (GL_LINES_ADJACENCY, 0, 4);
 
 				break;
@@ -132,22 +132,9 @@ namespace mini {
 	void bezier_segment_gpu::m_bind_shader (app_context & context, std::shared_ptr<shader_t> shader, const glm::mat4x4 & world_matrix) const {
 		shader->bind ();
 
-		const auto & view_matrix = context.get_view_matrix ();
-		const auto & proj_matrix = context.get_projection_matrix ();
-
-		const auto & video_mode = context.get_video_mode ();
-
-		glm::vec2 resolution = {
-			static_cast<float> (video_mode.get_buffer_width ()),
-			static_cast<float> (video_mode.get_buffer_height ())
-		};
-
-		shader->set_uniform ("u_color", get_color ());
-		shader->set_uniform ("u_world", world_matrix);
-		shader->set_uniform ("u_view", view_matrix);
-		shader->set_uniform ("u_projection", proj_matrix);
-		shader->set_uniform ("u_resolution", resolution);
-		shader->set_uniform ("u_line_width", 2.0f);
+		shader->set_uniform (shader->get_uniform_location (shader_uniform_t::color), get_color ());
+		shader->set_uniform (shader->get_uniform_location (shader_uniform_t::world), world_matrix);
+		shader->set_uniform (shader->get_uniform_location (shader_uniform_t::line_width), 2.0f);
 	}
 
 	void bezier_segment_gpu::m_init_positions () {
@@ -457,6 +444,7 @@ namespace mini {
 							t_listen (signal_event_t::moved, *point);
 							m_points.push_back (point_wrapper_t (point));
 							m_queue_curve_rebuild = true;
+							t_notify (signal_event_t::topology);
 						}
 					}
 				}
@@ -469,6 +457,7 @@ namespace mini {
 					if (iter->selected) {
 						iter = m_points.erase (iter);
 						m_queue_curve_rebuild = true;
+						t_notify (signal_event_t::topology);
 					}
 
 					if (iter == m_points.end ()) {
@@ -490,6 +479,9 @@ namespace mini {
 				}
 			}
 
+			get_scene ().subscribe (scene_event_t::created, shared_from_this ());
+			get_scene ().subscribe (scene_event_t::deleted, shared_from_this ());
+
 			m_configured = true;
 		}
 	}
@@ -505,6 +497,7 @@ namespace mini {
 			t_listen (signal_event_t::moved, *point);
 			m_points.push_back (point_wrapper_t (point));
 			m_queue_curve_rebuild = true;
+			t_notify (signal_event_t::topology);
 		}
 	}
 
@@ -531,6 +524,29 @@ namespace mini {
 
 		if (changed) {
 			m_queue_curve_rebuild = true;
+			t_notify (signal_event_t::topology);
+		}
+	}
+
+	void curve_base::t_on_objects_deleted (const scene_controller_base::object_batch_t & objects) {
+		// a single pass over the points no matter how many objects were deleted
+		std::unordered_set<const scene_obj_t *> deleted;
+		deleted.reserve (objects.size ());
+
+		for (const auto & object : objects) {
+			deleted.insert (object.get ());
+		}
+
+		const auto count = m_points.size ();
+
+		m_points.erase (std::remove_if (m_points.begin (), m_points.end (), [&deleted] (const point_wrapper_t & wrapper) {
+			auto point = wrapper.point.lock ();
+			return !point || deleted.count (point.get ()) > 0;
+		}), m_points.end ());
+
+		if (m_points.size () != count) {
+			m_queue_curve_rebuild = true;
+			t_notify (signal_event_t::topology);
 		}
 	}
 
@@ -681,22 +697,9 @@ namespace mini {
 
 		m_shader->bind ();
 
-		const auto & view_matrix = context.get_view_matrix ();
-		const auto & proj_matrix = context.get_projection_matrix ();
-
-		const auto & video_mode = context.get_video_mode ();
-
-		glm::vec2 resolution = {
-			static_cast<float> (video_mode.get_buffer_width ()),
-			static_cast<float> (video_mode.get_buffer_height ())
-		};
-
-		m_shader->set_uniform ("u_color", get_color ());
-		m_shader->set_uniform ("u_world", world_matrix);
-		m_shader->set_uniform ("u_view", view_matrix);
-		m_shader->set_uniform ("u_projection", proj_matrix);
-		m_shader->set_uniform ("u_resolution", resolution);
-		m_shader->set_uniform ("u_line_width", 2.0f);
+		m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::color), get_color ());
+		m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::world), world_matrix);
+		m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::line_width), 2.0f);
 
 		glBindVertexArray (m_vao);
 		glDrawArrays (GL_LINES, 0, m_divisions * 2 + 2);
@@ -705,12 +708,9 @@ namespace mini {
 		if (is_showing_polygon () && m_degree > 1) {
 			m_poly_shader->bind ();
 
-			m_poly_shader->set_uniform ("u_color", get_color ());
-			m_poly_shader->set_uniform ("u_world", world_matrix);
-			m_poly_shader->set_uniform ("u_view", view_matrix);
-			m_poly_shader->set_uniform ("u_projection", proj_matrix);
-			m_poly_shader->set_uniform ("u_resolution", resolution);
-			m_poly_shader->set_uniform ("u_line_width", 2.0f);
+			m_poly_shader->set_uniform (m_poly_shader->get_uniform_location (shader_uniform_t::color), get_color ());
+			m_poly_shader->set_uniform (m_poly_shader->get_uniform_location (shader_uniform_t::world), world_matrix);
+			m_poly_shader->set_uniform (m_poly_shader->get_uniform_location (shader_uniform_t::line_width), 2.0f);
 
 			glBindVertexArray (m_poly_vao);
 			glDrawArrays (GL_LINES, 0, m_degree * 6); // magic number 18, should be called something probably
@@ -1,5 +1,6 @@
 #include "beziersurf.hpp"
 #include "surfacetpl.hpp"
+#include "patcheval.hpp"
 #include "gui.hpp"
 #include "serializer.hpp"
 
@@ -109,6 +110,8 @@ namespace mini {
 
 		m_u_wrapped = u_wrapped;
 		m_v_wrapped = v_wrapped;
+
+		get_domain().set_wrapping(u_wrapped, v_wrapped);
 		
 		// validity check
 		if ((patches_y * patches_x * 9 + patches_x * 3 + patches_y * 3 + 1) != points.size ()) {
@@ -143,6 +146,8 @@ namespace mini {
 
 		m_u_wrapped = u_wrapped;
 		m_v_wrapped = v_wrapped;
+
+		get_domain().set_wrapping(u_wrapped, v_wrapped);
 		
 		// topology validity check
 		if ((patches_x * patches_y * 16) != topology.size ()) {
@@ -270,7 +275,8 @@ namespace mini {
 		auto p2 = bezier_evaluate(p(2, 0), p(2, 1), p(2, 2), p(2, 3), lv);
 		auto p3 = bezier_evaluate(p(3, 0), p(3, 1), p(3, 2), p(3, 3), lv);
 
-		return bezier_derivative(p0, p1, p2, p3, lu);
+		// chain rule, the patch parameter grows faster than the global one
+		return static_cast<float>(get_patches_x()) * bezier_derivative(p0, p1, p2, p3, lu);
 	}
 
 	glm::vec3 bezier_surface_c0::ddv(float u, float v) const {
@@ -292,7 +298,17 @@ namespace mini {
 		auto p2 = bezier_evaluate(p(0, 2), p(1, 2), p(2, 2), p(3, 2), lu);
 		auto p3 = bezier_evaluate(p(0, 3), p(1, 3), p(2, 3), p(3, 3), lu);
 
-		return bezier_derivative(p0, p1, p2, p3, lv);
+		return static_cast<float>(get_patches_y()) * bezier_derivative(p0, p1, p2, p3, lv);
+	}
+
+	void bezier_surface_c0::evaluate(const float * u, const float * v, std::size_t count, surface_samples & out) const {
+		const glm::vec3 * net = t_get_control_net();
+
+		if (!net) {
+			return differentiable_surface_base::evaluate(u, v, count, out);
+		}
+
+		evaluate_bicubic_patches(bicubic_basis::bezier, get_patches_x(), get_patches_y(), net, u, v, count, out);
 	}
 
 	bool bezier_surface_c0::is_u_wrapped() const {
@@ -311,6 +327,11 @@ namespace mini {
 		return get_domain();
 	}
 
+	const patch_bvh* bezier_surface_c0::get_bvh() const {
+		const auto & bvh = get_patch_bvh();
+		return bvh.empty() ? nullptr : &bvh;
+	}
+
 	void bezier_surface_c0::t_calc_idx_buffer (std::vector<GLuint> & indices, std::vector<GLuint> & grid_indices) {
 		// create indices for patches
 		unsigned int i = 0;
@@ -106,24 +106,23 @@ namespace mini {
 		m_shader->bind ();
 
 		// set uniforms
-		const auto & view_matrix = context.get_view_matrix ();
-		const auto & proj_matrix = context.get_projection_matrix ();
-
-		float screen_width = static_cast<float> (context.get_video_mode ().get_buffer_width ());
-		float screen_height = static_cast<float> (context.get_video_mode ().get_buffer_height ());
-
 		glm::vec4 center = { 0.0f, 0.0f, 0.0f, 1.0f };
 		center = world_matrix * center;
 
-		m_shader->set_uniform ("u_size", m_size);
-		m_shader->set_uniform ("u_color", m_color_tint);
-		m_shader->set_uniform ("u_center", static_cast<glm::vec3> (center));
-		m_shader->set_uniform ("u_view", view_matrix);
-		m_shader->set_uniform ("u_projection", proj_matrix);
-		m_shader->set_uniform ("u_resolution", glm::vec2 (screen_width, screen_height));
+		m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::size), m_size);
+		m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::color), m_color_tint);
+		m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::center), static_cast<glm::vec3> (center));
 
 		glDrawElements (GL_TRIANGLES, static_cast<GLsizei> (quad_indices.size ()), GL_UNSIGNED_INT, NULL);
 		glBindVertexArray (static_cast<GLuint>(NULL));
 		glEnable (GL_DEPTH_TEST);
 	}
+
+	render_key_t billboard_object::get_render_key () const {
+		return {
+			m_shader ? m_shader->get_program_handle () : 0,
+			m_vao,
+			m_texture ? m_texture->get_handle () : 0
+		};
+	}
 }
\ No newline at end of file
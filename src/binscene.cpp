@@ -0,0 +1,679 @@
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <limits>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "binscene.hpp"
+
+using nlohmann::json;
+
+namespace mini {
+	static_assert(sizeof(binary_scene_header_t) == 112, "binary scene header has padding");
+	static_assert(sizeof(binary_point_t) == 24, "binary point has padding");
+	static_assert(sizeof(binary_object_t) == 8, "binary object has padding");
+	static_assert(sizeof(binary_surface_t) == 36, "binary surface has padding");
+	static_assert(sizeof(binary_patch_t) == 80, "binary patch has padding");
+
+	static bool read_int32(const json & value, int32_t & result) {
+		if (value.is_number_unsigned()) {
+			const auto number = value.get<uint64_t>();
+			if (number > static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+				return false;
+			}
+
+			result = static_cast<int32_t>(number);
+			return true;
+		}
+
+		if (value.is_number_integer()) {
+			const auto number = value.get<int64_t>();
+			if (number < std::numeric_limits<int32_t>::min() || number > std::numeric_limits<int32_t>::max()) {
+				return false;
+			}
+
+			result = static_cast<int32_t>(number);
+			return true;
+		}
+
+		return false;
+	}
+
+	static bool read_uint32(const json & value, uint32_t & result) {
+		int32_t number;
+		if (!read_int32(value, number) || number < 0) {
+			return false;
+		}
+
+		result = static_cast<uint32_t>(number);
+		return true;
+	}
+
+	// only an object with exactly the three coordinates fits the table
+	static bool read_position(const json & value, float (&result)[3]) {
+		if (!value.is_object() || value.size() != 3) {
+			return false;
+		}
+
+		const char * keys[3] = { "x", "y", "z" };
+
+		for (int i = 0; i < 3; ++i) {
+			auto iter = value.find(keys[i]);
+			if (iter == value.end() || !iter->is_number()) {
+				return false;
+			}
+
+			result[i] = iter->get<float>();
+		}
+
+		return true;
+	}
+
+	static bool read_point_ref(const json & value, int32_t & result) {
+		if (!value.is_object() || value.size() != 1) {
+			return false;
+		}
+
+		auto iter = value.find("id");
+		return iter != value.end() && read_int32(*iter, result);
+	}
+
+	// members of any other type are kept with the rest of the object
+	static bool has_string(const json & object, const char * key) {
+		auto iter = object.find(key);
+		return iter != object.end() && iter->is_string();
+	}
+
+	binary_scene_writer::binary_scene_writer() {
+		m_flags = binary_scene_has_points | binary_scene_has_geometry;
+		m_extra = binary_no_string;
+		m_string_offsets.push_back(0);
+	}
+
+	std::string binary_scene_writer::from_json(const json & scene) {
+		if (!scene.is_object()) {
+			throw std::runtime_error("scene is not a json object");
+		}
+
+		binary_scene_writer writer;
+		json members = json::object();
+
+		writer.m_flags = 0;
+
+		for (auto iter = scene.begin(); iter != scene.end(); ++iter) {
+			if (iter.key() == "points" && iter->is_array()) {
+				writer.m_flags |= binary_scene_has_points;
+				writer.reserve_points(iter->size());
+
+				for (const auto & point : *iter) {
+					writer.add_point(point);
+				}
+			} else if (iter.key() == "geometry" && iter->is_array()) {
+				writer.m_flags |= binary_scene_has_geometry;
+
+				for (const auto & object : *iter) {
+					writer.add_object(object);
+				}
+			} else {
+				members[iter.key()] = iter.value();
+			}
+		}
+
+		writer.m_extra = writer.m_add_extra(members);
+		return writer.get_data();
+	}
+
+	void binary_scene_writer::reserve_points(std::size_t count) {
+		m_points.reserve(count);
+	}
+
+	void binary_scene_writer::add_point(int32_t id, const glm::vec3 & position, const std::string & name) {
+		m_points.push_back({ id, { position.x, position.y, position.z }, m_add_string(name), binary_no_string });
+	}
+
+	void binary_scene_writer::add_point(const json & point) {
+		binary_point_t record;
+
+		if (!point.is_object() || !point.contains("id") || !point.contains("position") ||
+			!read_int32(point["id"], record.id) || !read_position(point["position"], record.position)) {
+
+			throw std::runtime_error("point cannot be stored in a binary scene");
+		}
+
+		json members = point;
+		members.erase("id");
+		members.erase("position");
+
+		record.name = binary_no_string;
+		if (has_string(point, "name")) {
+			record.name = m_add_string(point["name"].get<std::string>());
+			members.erase("name");
+		}
+
+		record.extra = m_add_extra(members);
+		m_points.push_back(record);
+	}
+
+	void binary_scene_writer::add_object(const json & object) {
+		if (m_add_surface(object)) {
+			return;
+		}
+
+		const auto cbor = json::to_cbor(object);
+		const uint32_t index = m_add_string(std::string(cbor.begin(), cbor.end()));
+
+		m_objects.push_back({ binary_object_generic, index });
+	}
+
+	std::string binary_scene_writer::get_data() const {
+		binary_scene_header_t header;
+		std::memset(&header, 0, sizeof(header));
+
+		header.magic = binary_scene_magic;
+		header.version = binary_scene_version;
+		header.flags = m_flags;
+		header.extra = m_extra;
+
+		std::string data(sizeof(header), '\0');
+
+		const auto append = [&data](const void * records, std::size_t count, std::size_t record_size) {
+			// every table starts on an 8 byte boundary so it can be used in place
+			data.resize((data.size() + 7) & ~static_cast<std::size_t>(7), '\0');
+
+			binary_section_t section = { data.size(), count };
+			data.append(static_cast<const char *>(records), count * record_size);
+
+			return section;
+		};
+
+		header.points = append(m_points.data(), m_points.size(), sizeof(binary_point_t));
+		header.objects = append(m_objects.data(), m_objects.size(), sizeof(binary_object_t));
+		header.surfaces = append(m_surfaces.data(), m_surfaces.size(), sizeof(binary_surface_t));
+		header.patches = append(m_patches.data(), m_patches.size(), sizeof(binary_patch_t));
+		header.string_offsets = append(m_string_offsets.data(), m_string_offsets.size(), sizeof(uint64_t));
+		header.string_data = append(m_string_data.data(), m_string_data.size(), 1);
+
+		std::memcpy(&data[0], &header, sizeof(header));
+		return data;
+	}
+
+	uint32_t binary_scene_writer::m_add_string(const std::string & value) {
+		auto iter = m_string_index.find(value);
+		if (iter != m_string_index.end()) {
+			return iter->second;
+		}
+
+		const uint32_t index = static_cast<uint32_t>(m_string_offsets.size() - 1);
+
+		m_string_data.append(value);
+		m_string_offsets.push_back(m_string_data.size());
+		m_string_index.insert({ value, index });
+
+		return index;
+	}
+
+	uint32_t binary_scene_writer::m_add_extra(const json & members) {
+		if (members.empty()) {
+			return binary_no_string;
+		}
+
+		const auto cbor = json::to_cbor(members);
+		return m_add_string(std::string(cbor.begin(), cbor.end()));
+	}
+
+	bool binary_scene_writer::m_add_surface(const json & object) {
+		if (!object.is_object() || !object.contains("objectType") || !object.contains("id") ||
+			!object.contains("size") || !object.contains("patches")) {
+			return false;
+		}
+
+		const auto & type = object["objectType"];
+		if (type != "bezierSurfaceC0" && type != "bezierSurfaceC2") {
+			return false;
+		}
+
+		binary_surface_t surface;
+		const auto & size = object["size"];
+		const auto & patches = object["patches"];
+
+		if (!read_int32(object["id"], surface.id) || !patches.is_array() ||
+			!size.is_object() || size.size() != 2 || !size.contains("x") || !size.contains("y") ||
+			!read_uint32(size["x"], surface.patches_x) || !read_uint32(size["y"], surface.patches_y)) {
+			return false;
+		}
+
+		// every patch has to fit the fixed size table or the surface is kept whole
+		for (const auto & patch : patches) {
+			if (!patch.is_object() || !patch.contains("id") || !patch.contains("controlPoints")) {
+				return false;
+			}
+
+			int32_t id;
+			const auto & control_points = patch["controlPoints"];
+
+			if (!read_int32(patch["id"], id) || !control_points.is_array() || control_points.size() != 16) {
+				return false;
+			}
+
+			for (const auto & point : control_points) {
+				if (!read_point_ref(point, id)) {
+					return false;
+				}
+			}
+		}
+
+		json members = object;
+		members.erase("id");
+		members.erase("objectType");
+		members.erase("size");
+		members.erase("patches");
+
+		surface.type = m_add_string(type.get<std::string>());
+		surface.name = binary_no_string;
+		surface.flags = 0;
+
+		if (has_string(object, "name")) {
+			surface.name = m_add_string(object["name"].get<std::string>());
+			members.erase("name");
+		}
+
+		auto wrapping = object.find("parameterWrapped");
+		if (wrapping != object.end() && wrapping->is_object() && wrapping->size() == 2 &&
+			wrapping->contains("u") && wrapping->contains("v") &&
+			(*wrapping)["u"].is_boolean() && (*wrapping)["v"].is_boolean()) {
+
+			surface.flags |= binary_surface_has_wrapping;
+			surface.flags |= (*wrapping)["u"].get<bool>() ? binary_surface_u_wrapped : 0;
+			surface.flags |= (*wrapping)["v"].get<bool>() ? binary_surface_v_wrapped : 0;
+			members.erase("parameterWrapped");
+		}
+
+		surface.extra = m_add_extra(members);
+		surface.first_patch = static_cast<uint32_t>(m_patches.size());
+		surface.num_patches = static_cast<uint32_t>(patches.size());
+
+		for (const auto & patch : patches) {
+			binary_patch_t record;
+			json patch_members = patch;
+
+			read_int32(patch["id"], record.id);
+			patch_members.erase("id");
+			patch_members.erase("controlPoints");
+
+			int index = 0;
+			for (const auto & point : patch["controlPoints"]) {
+				read_point_ref(point, record.points[index++]);
+			}
+
+			record.type = binary_no_string;
+			if (has_string(patch, "objectType")) {
+				record.type = m_add_string(patch["objectType"].get<std::string>());
+				patch_members.erase("objectType");
+			}
+
+			record.name = binary_no_string;
+			if (has_string(patch, "name")) {
+				record.name = m_add_string(patch["name"].get<std::string>());
+				patch_members.erase("name");
+			}
+
+			record.extra = m_add_extra(patch_members);
+			m_patches.push_back(record);
+		}
+
+		m_objects.push_back({ binary_object_surface, static_cast<uint32_t>(m_surfaces.size()) });
+		m_surfaces.push_back(surface);
+
+		return true;
+	}
+
+	struct binary_scene_reader::mapping_t {
+#ifdef _WIN32
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = NULL;
+#else
+		int file = -1;
+#endif
+		void * data = nullptr;
+		std::size_t size = 0;
+
+		~mapping_t() {
+#ifdef _WIN32
+			if (data) {
+				UnmapViewOfFile(data);
+			}
+
+			if (mapping) {
+				CloseHandle(mapping);
+			}
+
+			if (file != INVALID_HANDLE_VALUE) {
+				CloseHandle(file);
+			}
+#else
+			if (data) {
+				munmap(data, size);
+			}
+
+			if (file >= 0) {
+				::close(file);
+			}
+#endif
+		}
+
+		bool open(const std::string & path) {
+#ifdef _WIN32
+			file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (file == INVALID_HANDLE_VALUE) {
+				return false;
+			}
+
+			LARGE_INTEGER file_size;
+			if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+				return false;
+			}
+
+			mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (!mapping) {
+				return false;
+			}
+
+			data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			size = static_cast<std::size_t>(file_size.QuadPart);
+#else
+			file = ::open(path.c_str(), O_RDONLY);
+			if (file < 0) {
+				return false;
+			}
+
+			struct stat info;
+			if (fstat(file, &info) != 0 || info.st_size == 0) {
+				return false;
+			}
+
+			data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+			if (data == MAP_FAILED) {
+				data = nullptr;
+				return false;
+			}
+
+			size = static_cast<std::size_t>(info.st_size);
+
+			// tables are mostly read front to back
+			madvise(data, size, MADV_SEQUENTIAL);
+#endif
+			return data != nullptr;
+		}
+	};
+
+	binary_scene_reader::binary_scene_reader() {
+		close();
+	}
+
+	binary_scene_reader::~binary_scene_reader() {
+		close();
+	}
+
+	bool binary_scene_reader::is_binary_scene(const std::string & path) {
+		std::ifstream stream(path, std::ios::binary);
+		uint32_t magic = 0;
+
+		return stream.read(reinterpret_cast<char *>(&magic), sizeof(magic)) && magic == binary_scene_magic;
+	}
+
+	void binary_scene_reader::open(const std::string & path) {
+		close();
+
+		m_mapping = std::make_unique<mapping_t>();
+		if (!m_mapping->open(path)) {
+			close();
+			throw std::runtime_error("failed to map file " + path);
+		}
+
+		m_data = static_cast<const uint8_t *>(m_mapping->data);
+		m_size = m_mapping->size;
+
+		try {
+			m_validate();
+		} catch (...) {
+			close();
+			throw;
+		}
+	}
+
+	void binary_scene_reader::close() {
+		m_mapping.reset();
+		m_data = nullptr;
+		m_size = 0;
+
+		m_header = nullptr;
+		m_points = nullptr;
+		m_objects = nullptr;
+		m_surfaces = nullptr;
+		m_patches = nullptr;
+		m_string_offsets = nullptr;
+		m_string_data = nullptr;
+	}
+
+	std::size_t binary_scene_reader::get_num_points() const {
+		return m_header ? static_cast<std::size_t>(m_header->points.count) : 0;
+	}
+
+	std::size_t binary_scene_reader::get_num_objects() const {
+		return m_header ? static_cast<std::size_t>(m_header->objects.count) : 0;
+	}
+
+	const binary_point_t & binary_scene_reader::get_point(std::size_t index) const {
+		return m_points[index];
+	}
+
+	const binary_object_t & binary_scene_reader::get_object(std::size_t index) const {
+		return m_objects[index];
+	}
+
+	const binary_surface_t & binary_scene_reader::get_surface(uint32_t index) const {
+		return m_surfaces[index];
+	}
+
+	const binary_patch_t & binary_scene_reader::get_patch(uint32_t index) const {
+		return m_patches[index];
+	}
+
+	bool binary_scene_reader::has_string(uint32_t index) const {
+		return index != binary_no_string;
+	}
+
+	std::string_view binary_scene_reader::get_string(uint32_t index) const {
+		// indices are checked on access so that loading never walks the point table
+		if (index >= m_header->string_offsets.count - 1) {
+			throw std::runtime_error("binary scene string index out of range");
+		}
+
+		const uint64_t begin = m_string_offsets[index];
+		const uint64_t end = m_string_offsets[index + 1];
+
+		return std::string_view(m_string_data + begin, static_cast<std::size_t>(end - begin));
+	}
+
+	json binary_scene_reader::get_extra(uint32_t index) const {
+		if (!has_string(index)) {
+			return json::object();
+		}
+
+		const auto bytes = get_string(index);
+		return json::from_cbor(bytes.data(), bytes.data() + bytes.size());
+	}
+
+	json binary_scene_reader::get_point_json(std::size_t index) const {
+		const auto & point = m_points[index];
+		json j = get_extra(point.extra);
+
+		j["id"] = point.id;
+
+		if (has_string(point.name)) {
+			j["name"] = std::string(get_string(point.name));
+		}
+
+		j["position"] = {
+			{ "x", point.position[0] },
+			{ "y", point.position[1] },
+			{ "z", point.position[2] }
+		};
+
+		return j;
+	}
+
+	json binary_scene_reader::get_object_json(std::size_t index) const {
+		const auto & object = m_objects[index];
+
+		if (object.kind == binary_object_surface) {
+			return m_get_surface_json(m_surfaces[object.index]);
+		}
+
+		return get_extra(object.index);
+	}
+
+	json binary_scene_reader::to_json() const {
+		json scene = get_extra(m_header->extra);
+
+		if (m_header->flags & binary_scene_has_points) {
+			json points = json::array();
+
+			for (std::size_t i = 0; i < get_num_points(); ++i) {
+				points.push_back(get_point_json(i));
+			}
+
+			scene["points"] = std::move(points);
+		}
+
+		if (m_header->flags & binary_scene_has_geometry) {
+			json geometry = json::array();
+
+			for (std::size_t i = 0; i < get_num_objects(); ++i) {
+				geometry.push_back(get_object_json(i));
+			}
+
+			scene["geometry"] = std::move(geometry);
+		}
+
+		return scene;
+	}
+
+	void binary_scene_reader::m_validate() {
+		if (m_size < sizeof(binary_scene_header_t)) {
+			throw std::runtime_error("file is too small to be a binary scene");
+		}
+
+		m_header = reinterpret_cast<const binary_scene_header_t *>(m_data);
+
+		if (m_header->magic != binary_scene_magic) {
+			throw std::runtime_error("file is not a binary scene");
+		}
+
+		if (m_header->version != binary_scene_version) {
+			throw std::runtime_error("unsupported binary scene version " + std::to_string(m_header->version));
+		}
+
+		const auto section = [this](const binary_section_t & section, std::size_t record_size) {
+			if (section.offset % 8 != 0 || section.offset > m_size ||
+				section.count > (m_size - section.offset) / record_size) {
+				throw std::runtime_error("binary scene table is out of bounds");
+			}
+
+			return m_data + section.offset;
+		};
+
+		m_points = reinterpret_cast<const binary_point_t *>(section(m_header->points, sizeof(binary_point_t)));
+		m_objects = reinterpret_cast<const binary_object_t *>(section(m_header->objects, sizeof(binary_object_t)));
+		m_surfaces = reinterpret_cast<const binary_surface_t *>(section(m_header->surfaces, sizeof(binary_surface_t)));
+		m_patches = reinterpret_cast<const binary_patch_t *>(section(m_header->patches, sizeof(binary_patch_t)));
+		m_string_offsets = reinterpret_cast<const uint64_t *>(section(m_header->string_offsets, sizeof(uint64_t)));
+		m_string_data = reinterpret_cast<const char *>(section(m_header->string_data, 1));
+
+		const uint64_t num_offsets = m_header->string_offsets.count;
+		if (num_offsets == 0 || m_string_offsets[0] != 0 || m_string_offsets[num_offsets - 1] != m_header->string_data.count) {
+			throw std::runtime_error("binary scene string table is corrupted");
+		}
+
+		for (uint64_t i = 1; i < num_offsets; ++i) {
+			if (m_string_offsets[i] < m_string_offsets[i - 1]) {
+				throw std::runtime_error("binary scene string table is corrupted");
+			}
+		}
+
+		for (uint64_t i = 0; i < m_header->surfaces.count; ++i) {
+			const auto & surface = m_surfaces[i];
+			if (static_cast<uint64_t>(surface.first_patch) + surface.num_patches > m_header->patches.count) {
+				throw std::runtime_error("binary scene surface refers to missing patches");
+			}
+		}
+
+		for (uint64_t i = 0; i < m_header->objects.count; ++i) {
+			const auto & object = m_objects[i];
+			const bool valid = (object.kind == binary_object_surface) ?
+				object.index < m_header->surfaces.count :
+				(object.kind == binary_object_generic && object.index < num_offsets - 1);
+
+			if (!valid) {
+				throw std::runtime_error("binary scene object table is corrupted");
+			}
+		}
+	}
+
+	json binary_scene_reader::m_get_surface_json(const binary_surface_t & surface) const {
+		json j = get_extra(surface.extra);
+
+		j["id"] = surface.id;
+		j["objectType"] = std::string(get_string(surface.type));
+		j["size"] = { { "x", surface.patches_x }, { "y", surface.patches_y } };
+
+		if (has_string(surface.name)) {
+			j["name"] = std::string(get_string(surface.name));
+		}
+
+		if (surface.flags & binary_surface_has_wrapping) {
+			j["parameterWrapped"] = {
+				{ "u", (surface.flags & binary_surface_u_wrapped) != 0 },
+				{ "v", (surface.flags & binary_surface_v_wrapped) != 0 }
+			};
+		}
+
+		json patches = json::array();
+
+		for (uint32_t i = 0; i < surface.num_patches; ++i) {
+			const auto & patch = m_patches[surface.first_patch + i];
+			json patch_json = get_extra(patch.extra);
+			json control_points = json::array();
+
+			for (const auto id : patch.points) {
+				control_points.push_back({ { "id", id } });
+			}
+
+			patch_json["id"] = patch.id;
+			patch_json["controlPoints"] = std::move(control_points);
+
+			if (has_string(patch.type)) {
+				patch_json["objectType"] = std::string(get_string(patch.type));
+			}
+
+			if (has_string(patch.name)) {
+				patch_json["name"] = std::string(get_string(patch.name));
+			}
+
+			patches.push_back(std::move(patch_json));
+		}
+
+		j["patches"] = std::move(patches);
+		return j;
+	}
+}
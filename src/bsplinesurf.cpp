@@ -1,5 +1,6 @@
 #include "bsplinesurf.hpp"
 #include "surfacetpl.hpp"
+#include "patcheval.hpp"
 #include "serializer.hpp"
 
 namespace mini {
@@ -117,6 +118,8 @@ namespace mini {
 
 		m_u_wrapped = u_wrapped;
 		m_v_wrapped = v_wrapped;
+
+		get_domain().set_wrapping(u_wrapped, v_wrapped);
 	}
 
 	bspline_surface::bspline_surface (
@@ -151,6 +154,8 @@ namespace mini {
 
 		m_u_wrapped = u_wrapped;
 		m_v_wrapped = v_wrapped;
+
+		get_domain().set_wrapping(u_wrapped, v_wrapped);
 	}
 
 	const object_serializer_base & bspline_surface::get_serializer () const {
@@ -257,7 +262,8 @@ namespace mini {
 		auto p2 = bspline_evaluate(p(2, 0), p(2, 1), p(2, 2), p(2, 3), lv);
 		auto p3 = bspline_evaluate(p(3, 0), p(3, 1), p(3, 2), p(3, 3), lv);
 
-		return bspline_derivative(p0, p1, p2, p3, lu);
+		// chain rule, the patch parameter grows faster than the global one
+		return static_cast<float>(get_patches_x()) * bspline_derivative(p0, p1, p2, p3, lu);
 	}
 
 	glm::vec3 bspline_surface::ddv(float u, float v) const {
@@ -279,7 +285,17 @@ namespace mini {
 		auto p2 = bspline_evaluate(p(0, 2), p(1, 2), p(2, 2), p(3, 2), lu);
 		auto p3 = bspline_evaluate(p(0, 3), p(1, 3), p(2, 3), p(3, 3), lu);
 
-		return bspline_derivative(p0, p1, p2, p3, lv);
+		return static_cast<float>(get_patches_y()) * bspline_derivative(p0, p1, p2, p3, lv);
+	}
+
+	void bspline_surface::evaluate(const float * u, const float * v, std::size_t count, surface_samples & out) const {
+		const glm::vec3 * net = t_get_control_net();
+
+		if (!net) {
+			return differentiable_surface_base::evaluate(u, v, count, out);
+		}
+
+		evaluate_bicubic_patches(bicubic_basis::bspline, get_patches_x(), get_patches_y(), net, u, v, count, out);
 	}
 
 	bool bspline_surface::is_u_wrapped() const {
@@ -298,6 +314,11 @@ namespace mini {
 		return get_domain();
 	}
 
+	const patch_bvh* bspline_surface::get_bvh() const {
+		const auto & bvh = get_patch_bvh();
+		return bvh.empty() ? nullptr : &bvh;
+	}
+
 	void bspline_surface::t_calc_idx_buffer (std::vector<GLuint> & indices, std::vector<GLuint> & grid_indices) {
 		// create indices for patches
 		unsigned int i = 0;
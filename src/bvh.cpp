@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "bvh.hpp"
+
+namespace mini {
+	void aabb_t::extend(const glm::vec3 & point) {
+		min = glm::min(min, point);
+		max = glm::max(max, point);
+	}
+
+	void aabb_t::extend(const aabb_t & box) {
+		min = glm::min(min, box.min);
+		max = glm::max(max, box.max);
+	}
+
+	void aabb_t::inflate(float margin) {
+		min = min - glm::vec3(margin);
+		max = max + glm::vec3(margin);
+	}
+
+	glm::vec3 aabb_t::center() const {
+		return 0.5f * (min + max);
+	}
+
+	bool aabb_t::overlaps(const aabb_t & other) const {
+		return
+			min.x <= other.max.x && other.min.x <= max.x &&
+			min.y <= other.max.y && other.min.y <= max.y &&
+			min.z <= other.max.z && other.min.z <= max.z;
+	}
+
+	float aabb_t::distance(const glm::vec3 & point) const {
+		const auto d = glm::max(glm::max(min - point, point - max), glm::vec3(0.0f));
+		return glm::length(d);
+	}
+
+	void patch_bvh::build(const std::vector<leaf_t> & leaves) {
+		clear();
+
+		if (leaves.empty()) {
+			return;
+		}
+
+		m_leaves = leaves;
+		m_leaf_nodes.resize(leaves.size());
+		m_nodes.reserve(2 * leaves.size() - 1);
+
+		std::vector<int> order(leaves.size());
+		for (int i = 0; i < static_cast<int>(order.size()); ++i) {
+			order[i] = i;
+		}
+
+		m_build_node(order, 0, static_cast<int>(order.size()), -1);
+	}
+
+	void patch_bvh::clear() {
+		m_nodes.clear();
+		m_leaves.clear();
+		m_leaf_nodes.clear();
+	}
+
+	void patch_bvh::refit(int leaf, const aabb_t & bounds) {
+		m_leaves[leaf].bounds = bounds;
+
+		int index = m_leaf_nodes[leaf];
+		m_nodes[index].bounds = bounds;
+
+		for (index = m_nodes[index].parent; index >= 0; index = m_nodes[index].parent) {
+			auto & node = m_nodes[index];
+
+			node.bounds = m_nodes[node.left].bounds;
+			node.bounds.extend(m_nodes[node.right].bounds);
+		}
+	}
+
+	bool patch_bvh::empty() const {
+		return m_nodes.empty();
+	}
+
+	int patch_bvh::get_num_leaves() const {
+		return static_cast<int>(m_leaves.size());
+	}
+
+	const patch_bvh::leaf_t & patch_bvh::get_leaf(int leaf) const {
+		return m_leaves[leaf];
+	}
+
+	const aabb_t & patch_bvh::get_bounds() const {
+		if (m_nodes.empty()) {
+			throw std::runtime_error("bvh is empty");
+		}
+
+		return m_nodes[0].bounds;
+	}
+
+	void patch_bvh::find_overlaps(const patch_bvh & other, std::vector<std::pair<int, int>> & pairs) const {
+		if (empty() || other.empty()) {
+			return;
+		}
+
+		// simultaneous descent, always split the larger of the two nodes
+		std::vector<std::pair<int, int>> stack;
+		stack.push_back({ 0, 0 });
+
+		while (!stack.empty()) {
+			const auto top = stack.back();
+			stack.pop_back();
+
+			const auto & a = m_nodes[top.first];
+			const auto & b = other.m_nodes[top.second];
+
+			if (!a.bounds.overlaps(b.bounds)) {
+				continue;
+			}
+
+			const bool a_leaf = a.leaf >= 0;
+			const bool b_leaf = b.leaf >= 0;
+
+			if (a_leaf && b_leaf) {
+				pairs.push_back({ a.leaf, b.leaf });
+				continue;
+			}
+
+			const auto size_a = glm::length(a.bounds.max - a.bounds.min);
+			const auto size_b = glm::length(b.bounds.max - b.bounds.min);
+
+			if (b_leaf || (!a_leaf && size_a >= size_b)) {
+				stack.push_back({ a.right, top.second });
+				stack.push_back({ a.left, top.second });
+			} else {
+				stack.push_back({ top.first, b.right });
+				stack.push_back({ top.first, b.left });
+			}
+		}
+
+		// traversal order depends on the tree shape, sort to keep results stable
+		std::sort(pairs.begin(), pairs.end());
+	}
+
+	int patch_bvh::find_closest(const glm::vec3 & point) const {
+		if (empty()) {
+			return -1;
+		}
+
+		int best = -1;
+		float best_dist = 0.0f;
+		float best_center = 0.0f;
+
+		std::vector<int> stack;
+		stack.push_back(0);
+
+		while (!stack.empty()) {
+			const auto & node = m_nodes[stack.back()];
+			stack.pop_back();
+
+			const auto dist = node.bounds.distance(point);
+			if (best >= 0 && dist > best_dist) {
+				continue;
+			}
+
+			if (node.leaf >= 0) {
+				const auto center = glm::distance(node.bounds.center(), point);
+
+				if (best < 0 || dist < best_dist || center < best_center) {
+					best = node.leaf;
+					best_dist = dist;
+					best_center = center;
+				}
+
+				continue;
+			}
+
+			// visit the closer child first so the bound tightens quickly
+			const auto dl = m_nodes[node.left].bounds.distance(point);
+			const auto dr = m_nodes[node.right].bounds.distance(point);
+
+			if (dl < dr) {
+				stack.push_back(node.right);
+				stack.push_back(node.left);
+			} else {
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+
+		return best;
+	}
+
+	int patch_bvh::m_build_node(std::vector<int> & leaves, int begin, int end, int parent) {
+		const int index = static_cast<int>(m_nodes.size());
+		m_nodes.emplace_back();
+		m_nodes[index].parent = parent;
+
+		aabb_t bounds = m_leaves[leaves[begin]].bounds;
+		aabb_t centers = { bounds.center(), bounds.center() };
+
+		for (int i = begin + 1; i < end; ++i) {
+			const auto & box = m_leaves[leaves[i]].bounds;
+			bounds.extend(box);
+			centers.extend(box.center());
+		}
+
+		m_nodes[index].bounds = bounds;
+
+		if (end - begin == 1) {
+			m_nodes[index].leaf = leaves[begin];
+			m_leaf_nodes[leaves[begin]] = index;
+			return index;
+		}
+
+		// median split along the longest axis of the leaf centers
+		const auto extent = centers.max - centers.min;
+		int axis = 0;
+
+		if (extent.y > extent[axis]) {
+			axis = 1;
+		}
+
+		if (extent.z > extent[axis]) {
+			axis = 2;
+		}
+
+		const int mid = begin + (end - begin) / 2;
+		std::nth_element(leaves.begin() + begin, leaves.begin() + mid, leaves.begin() + end, [this, axis](int a, int b) {
+			return m_leaves[a].bounds.center()[axis] < m_leaves[b].bounds.center()[axis];
+		});
+
+		const int left = m_build_node(leaves, begin, mid, index);
+		const int right = m_build_node(leaves, mid, end, index);
+
+		m_nodes[index].left = left;
+		m_nodes[index].right = right;
+
+		return index;
+	}
+}
\ No newline at end of file
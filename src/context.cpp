@@ -1,6 +1,10 @@
 #include <cassert>
+#include <tuple>
+#include <algorithm>
+#include <unordered_set>
 
 #include "context.hpp"
+#include "profiler.hpp"
 
 namespace mini {
 	// basic shaders to render the screen buffer
@@ -26,17 +30,54 @@ namespace mini {
 		}
 	)";
 
+	// names of the layer scopes in the profiler
+	static const char * layer_name (render_layer_t layer) {
+		switch (layer) {
+			case render_layer_t::scene:			return "layer scene";
+			case render_layer_t::transparent:	return "layer transparent";
+			case render_layer_t::overlay:		return "layer overlay";
+			case render_layer_t::screen:		return "layer screen";
+		}
+
+		return "layer";
+	}
+
+	bool render_key_t::operator== (const render_key_t & other) const {
+		return shader == other.shader && vao == other.vao && texture == other.texture;
+	}
+
+	bool render_key_t::operator!= (const render_key_t & other) const {
+		return !(*this == other);
+	}
+
+	bool render_key_t::operator< (const render_key_t & other) const {
+		return std::tie (shader, vao, texture) < std::tie (other.shader, other.vao, other.texture);
+	}
+
 	app_context::app_context (const video_mode_t & video_mode) {
 		m_colorbuffer[0] = 0;
 		m_colorbuffer[1] = 0;
 		m_framebuffer[0] = 0;
 		m_framebuffer[1] = 0;
 		m_renderbuffer = 0;
-		m_last_queue_index = 0;
+		m_frame = 0;
+		m_sequence = 0;
+		m_num_transient = 0;
+		m_num_drawn = 0;
+		m_sort_needed = false;
+		m_rendering = false;
 		m_quad_buffer[0] = 0;
 		m_quad_buffer[1] = 0;
 		m_quad_buffer[2] = 0;
 		m_quad_vao = 0;
+		m_camera_ubo = 0;
+		m_pick_ubo = 0;
+		m_idbuffer = 0;
+		m_pick_framebuffer = 0;
+		m_pick_renderbuffer = 0;
+		m_pick_id = pick_id_none;
+		m_pick_enabled = false;
+		m_pick_writes = false;
 
 		m_video_mode = video_mode;
 		m_switch_mode = false;
@@ -50,9 +91,13 @@ namespace mini {
 
 		m_init_frame_buffer ();
 		m_init_screen_quad ();
+		m_init_camera_block ();
+		m_init_pick_block ();
 	}
 
 	app_context::~app_context () {
+		m_destroy_pick_block ();
+		m_destroy_camera_block ();
 		m_destroy_screen_quad ();
 		m_destroy_frame_buffer ();
 	}
@@ -117,13 +162,207 @@ namespace mini {
 		return m_camera->get_projection_matrix ();
 	}
 
-	void app_context::draw (std::weak_ptr<graphics_obj_t> object, glm::mat4x4 world_matrix) {
-		if (m_last_queue_index < RENDER_QUEUE_SIZE - 1) {
-			m_queue[m_last_queue_index].object = object;
-			m_queue[m_last_queue_index].world_matrix = world_matrix;
+	bool app_context::is_pick_enabled () const {
+		return m_pick_enabled;
+	}
+
+	void app_context::set_pick_enabled (bool enabled) {
+		m_pick_enabled = enabled;
+	}
+
+	uint32_t app_context::read_pick_id (int32_t x, int32_t y, int32_t radius) {
+		if (!m_pick_enabled) {
+			return pick_id_none;
+		}
+
+		int32_t region_x = x - radius, region_y = y - radius;
+		int32_t width = 2 * radius + 1, height = 2 * radius + 1;
+		std::vector<uint32_t> ids;
+
+		if (!m_read_pick_region (region_x, region_y, width, height, ids)) {
+			return pick_id_none;
+		}
+
+		// the id closest to the requested pixel wins
+		uint32_t best_id = pick_id_none;
+		int32_t best_dist = 0;
+
+		for (int32_t row = 0; row < height; ++row) {
+			for (int32_t col = 0; col < width; ++col) {
+				const uint32_t id = ids[row * width + col];
+				if (id == pick_id_none) {
+					continue;
+				}
+
+				const int32_t dx = region_x + col - x;
+				const int32_t dy = region_y + row - y;
+				const int32_t dist = dx * dx + dy * dy;
+
+				if (best_id == pick_id_none || dist < best_dist) {
+					best_id = id;
+					best_dist = dist;
+				}
+			}
+		}
+
+		return best_id;
+	}
+
+	void app_context::read_pick_ids (int32_t x0, int32_t y0, int32_t x1, int32_t y1, std::vector<uint32_t> & ids) {
+		if (!m_pick_enabled) {
+			return;
+		}
+
+		int32_t x = std::min (x0, x1), y = std::min (y0, y1);
+		int32_t width = std::abs (x1 - x0) + 1, height = std::abs (y1 - y0) + 1;
+		std::vector<uint32_t> pixels;
+
+		if (!m_read_pick_region (x, y, width, height, pixels)) {
+			return;
+		}
+
+		std::unordered_set<uint32_t> found;
+
+		for (const auto id : pixels) {
+			if (id != pick_id_none && found.insert (id).second) {
+				ids.push_back (id);
+			}
+		}
+	}
+
+	void app_context::draw (std::weak_ptr<graphics_obj_t> object, const glm::mat4x4 & world_matrix, render_layer_t layer) {
+		auto object_ptr = object.lock ();
+		if (!object_ptr) {
+			return;
+		}
+
+		// nested draws come from objects rendering their parts, parts without
+		// their own id are picked as the object that draws them
+		if (m_rendering) {
+			const auto parent_id = m_pick_id;
+			const auto pick_id = object_ptr->get_pick_id ();
+			const bool own_id = m_pick_enabled && pick_id != pick_id_none;
+
+			if (own_id) {
+				m_set_pick_id (pick_id);
+			}
+
+			object_ptr->render (*this, world_matrix);
+
+			if (own_id) {
+				m_set_pick_id (parent_id);
+			}
+
+			return;
+		}
+
+		m_submit (object, world_matrix, layer, false);
+	}
+
+	void app_context::add_retained (std::weak_ptr<graphics_obj_t> object, const glm::mat4x4 & world_matrix, render_layer_t layer) {
+		m_submit (object, world_matrix, layer, true);
+	}
+
+	void app_context::update_retained (const graphics_obj_t & object, const glm::mat4x4 & world_matrix) {
+		auto iter = m_render_index.find (&object);
+		if (iter == m_render_index.end ()) {
+			return;
+		}
+
+		auto & entry = m_render_list[iter->second];
+		if (!entry.retained) {
+			return;
+		}
+
+		const auto key = object.get_render_key ();
+		if (entry.key != key) {
+			entry.key = key;
+			m_sort_needed = true;
+		}
+
+		entry.world_matrix = world_matrix;
+	}
+
+	void app_context::remove_retained (const graphics_obj_t & object) {
+		auto iter = m_render_index.find (&object);
+		if (iter == m_render_index.end ()) {
+			return;
+		}
+
+		auto & entry = m_render_list[iter->second];
+		if (!entry.retained) {
+			return;
+		}
+
+		// left for the sweep at the end of the frame as a stale transient entry
+		entry.retained = false;
+		entry.frame = m_frame - 1;
+		m_num_transient++;
+	}
+
+	void app_context::clear_retained () {
+		for (auto & entry : m_render_list) {
+			if (entry.retained) {
+				entry.retained = false;
+				entry.frame = m_frame - 1;
+				m_num_transient++;
+			}
+		}
+	}
+
+	void app_context::m_submit (std::weak_ptr<graphics_obj_t> object, const glm::mat4x4 & world_matrix, render_layer_t layer, bool retained) {
+		auto object_ptr = object.lock ();
+		if (!object_ptr) {
+			return;
+		}
+
+		const auto key = object_ptr->get_render_key ();
+		auto iter = m_render_index.find (object_ptr.get ());
+
+		if (iter == m_render_index.end ()) {
+			m_render_index.emplace (object_ptr.get (), m_render_list.size ());
+			m_render_list.push_back ({ object, world_matrix, layer, key, m_sequence++, m_frame, retained });
+			m_sort_needed = true;
+
+			if (!retained) {
+				m_num_transient++;
+				m_num_drawn++;
+			}
+
+			return;
+		}
+
+		auto & entry = m_render_list[iter->second];
+
+		// the address was reused by a new object
+		if (entry.object.expired ()) {
+			entry.object = object;
+			entry.sequence = m_sequence++;
+			m_sort_needed = true;
+		}
+
+		if (entry.layer != layer || entry.key != key) {
+			entry.layer = layer;
+			entry.key = key;
+			m_sort_needed = true;
+		}
 
-			m_last_queue_index++;
+		if (!entry.retained) {
+			if (retained) {
+				entry.retained = true;
+				m_num_transient--;
+
+				// an entry counted as drawn in this frame is not transient anymore
+				if (entry.frame == m_frame) {
+					m_num_drawn--;
+				}
+			} else if (entry.frame != m_frame) {
+				m_num_drawn++;
+			}
 		}
+
+		entry.world_matrix = world_matrix;
+		entry.frame = m_frame;
 	}
 
 	void app_context::render (bool clear) {
@@ -149,6 +388,8 @@ namespace mini {
 	}
 
 	void app_context::display (bool present, bool clear) {
+		profile_scope scope ("display", true);
+
 		// setup viewport
 		glEnable (GL_DEPTH_TEST);
 		glEnable (GL_BLEND);
@@ -188,36 +429,157 @@ namespace mini {
 	}
 
 	void app_context::display_scene (bool clear) {
+		profile_scope scope ("display_scene", true);
+
 		glViewport (0, 0, m_video_mode.get_buffer_width (), m_video_mode.get_buffer_height ());
 
 		// clear screen
 		glClearColor (0.15f, 0.15f, 0.15f, 1.0f);
 		glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+		if (m_pick_enabled) {
+			const GLenum draw_buffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+			const GLuint no_object[] = { pick_id_none, 0, 0, 0 };
+
+			glDrawBuffers (2, draw_buffers);
+			glClearBufferuiv (GL_COLOR, 1, no_object);
+
+			// ids are only written while an object with an id is drawn
+			glColorMaski (1, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+			glBindBufferBase (GL_UNIFORM_BUFFER, pick_block_binding, m_pick_ubo);
+
+			m_pick_id = pick_id_none;
+			m_pick_writes = false;
+		}
+
+		if (m_sort_needed) {
+			m_sort_render_list ();
+		}
+
+		// camera uniforms are shared by all programs
+		m_update_camera_block ();
+
 		// render the scene
+		m_rendering = true;
+
 		if (m_pre_render) {
 			m_pre_render (*this);
 		}
 
-		for (uint32_t index = 0; index < m_last_queue_index; ++index) {
-			auto object_ptr = m_queue[index].object.lock ();
+		// the gpu is timed per layer, objects only on the cpu
+		auto & profiler = frame_profiler::get_instance ();
+		bool layer_open = false;
+		render_layer_t layer = render_layer_t::scene;
+
+		for (const auto & entry : m_render_list) {
+			if (!entry.retained && entry.frame != m_frame) {
+				continue;
+			}
+
+			if (!layer_open || entry.layer != layer) {
+				if (layer_open) {
+					profiler.end_scope ();
+				}
+
+				layer = entry.layer;
+				layer_open = true;
+				profiler.begin_scope (layer_name (layer), true);
+			}
+
+			auto object_ptr = entry.object.lock ();
 			if (object_ptr) {
-				object_ptr->render (*this, m_queue[index].world_matrix);
+				if (m_pick_enabled) {
+					m_set_pick_id (object_ptr->get_pick_id ());
+				}
+
+				if (object_ptr->is_batched ()) {
+					object_ptr->render (*this, entry.world_matrix);
+				} else {
+					profile_object_scope object_scope ("render", object_ptr.get (), object_ptr->get_debug_name ());
+					object_ptr->render (*this, entry.world_matrix);
+				}
 			}
 		}
 
+		if (layer_open) {
+			profiler.end_scope ();
+		}
+
+		if (m_pick_enabled) {
+			m_set_pick_id (pick_id_none);
+		}
+
 		if (m_post_render) {
 			m_post_render (*this);
 		}
 
-		// clear the rendering queue
-		// this reset pass has to be done to not persist renderables
+		if (m_pick_enabled) {
+			glColorMaski (1, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+			glDrawBuffer (GL_COLOR_ATTACHMENT0);
+		}
+
+		m_rendering = false;
+
+		// end of frame, forget objects that were not drawn in it
 		if (clear) {
-			for (uint32_t index = 0; index < m_last_queue_index; ++index) {
-				m_queue[index].object.reset ();
+			m_sweep_render_list ();
+			m_frame++;
+		}
+	}
+
+	void app_context::m_sort_render_list () {
+		std::sort (m_render_list.begin (), m_render_list.end (), [] (const render_entry_t & a, const render_entry_t & b) {
+			if (a.layer != b.layer) {
+				return a.layer < b.layer;
+			}
+
+			if (a.key != b.key) {
+				return a.key < b.key;
+			}
+
+			return a.sequence < b.sequence;
+		});
+
+		m_index_render_list ();
+		m_sort_needed = false;
+	}
+
+	void app_context::m_sweep_render_list () {
+		const auto frame = m_frame;
+		const bool stale = m_num_drawn != m_num_transient;
+
+		m_num_drawn = 0;
+
+		// every transient entry was drawn again and no retained one removed
+		if (!stale) {
+			return;
+		}
+
+		auto end = std::remove_if (m_render_list.begin (), m_render_list.end (), [frame] (const render_entry_t & entry) {
+			return (!entry.retained && entry.frame != frame) || entry.object.expired ();
+		});
+
+		m_render_list.erase (end, m_render_list.end ());
+
+		m_num_transient = 0;
+		for (const auto & entry : m_render_list) {
+			if (!entry.retained) {
+				m_num_transient++;
 			}
+		}
 
-			m_last_queue_index = 0;
+		// removal keeps the order, only the indices have to be rebuilt
+		m_index_render_list ();
+	}
+
+	void app_context::m_index_render_list () {
+		m_render_index.clear ();
+
+		for (std::size_t index = 0; index < m_render_list.size (); ++index) {
+			auto object_ptr = m_render_list[index].object.lock ();
+			if (object_ptr) {
+				m_render_index.emplace (object_ptr.get (), index);
+			}
 		}
 	}
 
@@ -256,6 +618,15 @@ namespace mini {
 		// bind the texture as color attachment
 		glFramebufferTexture2D (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D_MULTISAMPLE, m_colorbuffer[back], 0);
 
+		// object ids, only drawn into while picking is enabled
+		glGenTextures (1, &m_idbuffer);
+		glBindTexture (GL_TEXTURE_2D_MULTISAMPLE, m_idbuffer);
+		glTexImage2DMultisample (GL_TEXTURE_2D_MULTISAMPLE, render_samples, GL_R32UI, render_width, render_height, GL_TRUE);
+		glBindTexture (GL_TEXTURE_2D_MULTISAMPLE, static_cast<GLuint>(NULL));
+
+		glFramebufferTexture2D (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D_MULTISAMPLE, m_idbuffer, 0);
+		glDrawBuffer (GL_COLOR_ATTACHMENT0);
+
 		// create renderbuffer for the framebuffer
 		glGenRenderbuffers (1, &m_renderbuffer);
 		glBindRenderbuffer (GL_RENDERBUFFER, m_renderbuffer);
@@ -283,6 +654,20 @@ namespace mini {
 			throw std::runtime_error ("opengl error: front framebuffer is not complete");
 		}
 
+		// single sampled ids resolved from the back buffer for reading
+		glGenRenderbuffers (1, &m_pick_renderbuffer);
+		glBindRenderbuffer (GL_RENDERBUFFER, m_pick_renderbuffer);
+		glRenderbufferStorage (GL_RENDERBUFFER, GL_R32UI, render_width, render_height);
+		glBindRenderbuffer (GL_RENDERBUFFER, static_cast<GLuint>(NULL));
+
+		glGenFramebuffers (1, &m_pick_framebuffer);
+		glBindFramebuffer (GL_FRAMEBUFFER, m_pick_framebuffer);
+		glFramebufferRenderbuffer (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_pick_renderbuffer);
+
+		if (glCheckFramebufferStatus (GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			throw std::runtime_error ("opengl error: pick framebuffer is not complete");
+		}
+
 		glBindTexture (GL_TEXTURE_2D, static_cast<GLuint>(NULL));
 		glBindFramebuffer (GL_FRAMEBUFFER, static_cast<GLuint>(NULL));
 	}
@@ -316,14 +701,130 @@ namespace mini {
 		glBindVertexArray (static_cast<GLuint>(NULL));
 	}
 
+	void app_context::m_init_camera_block () {
+		static_assert (sizeof (camera_block_t) == 144, "camera block does not match the std140 layout");
+
+		glGenBuffers (1, &m_camera_ubo);
+		glBindBuffer (GL_UNIFORM_BUFFER, m_camera_ubo);
+		glBufferData (GL_UNIFORM_BUFFER, sizeof (camera_block_t), NULL, GL_DYNAMIC_DRAW);
+		glBindBuffer (GL_UNIFORM_BUFFER, static_cast<GLuint>(NULL));
+
+		glBindBufferBase (GL_UNIFORM_BUFFER, camera_block_binding, m_camera_ubo);
+	}
+
+	void app_context::m_update_camera_block () {
+		camera_block_t block;
+		block.view = m_camera->get_view_matrix ();
+		block.projection = m_camera->get_projection_matrix ();
+		block.resolution = {
+			static_cast<float> (m_video_mode.get_buffer_width ()),
+			static_cast<float> (m_video_mode.get_buffer_height ())
+		};
+		block.padding = { 0.0f, 0.0f };
+
+		glBindBuffer (GL_UNIFORM_BUFFER, m_camera_ubo);
+		glBufferSubData (GL_UNIFORM_BUFFER, 0, sizeof (camera_block_t), &block);
+		glBindBuffer (GL_UNIFORM_BUFFER, static_cast<GLuint>(NULL));
+
+		// other code may have used the binding point in the meantime
+		glBindBufferBase (GL_UNIFORM_BUFFER, camera_block_binding, m_camera_ubo);
+	}
+
+	void app_context::m_init_pick_block () {
+		static_assert (sizeof (pick_block_t) == 16, "pick block does not match the std140 layout");
+
+		const pick_block_t block = { pick_id_none, { 0, 0, 0 } };
+
+		glGenBuffers (1, &m_pick_ubo);
+		glBindBuffer (GL_UNIFORM_BUFFER, m_pick_ubo);
+		glBufferData (GL_UNIFORM_BUFFER, sizeof (pick_block_t), &block, GL_DYNAMIC_DRAW);
+		glBindBuffer (GL_UNIFORM_BUFFER, static_cast<GLuint>(NULL));
+
+		glBindBufferBase (GL_UNIFORM_BUFFER, pick_block_binding, m_pick_ubo);
+	}
+
+	void app_context::m_set_pick_id (uint32_t pick_id) {
+		if (pick_id == m_pick_id) {
+			return;
+		}
+
+		m_pick_id = pick_id;
+
+		const bool writes = pick_id != pick_id_none;
+		if (writes != m_pick_writes) {
+			const GLboolean mask = writes ? GL_TRUE : GL_FALSE;
+			glColorMaski (1, mask, mask, mask, mask);
+			m_pick_writes = writes;
+		}
+
+		// objects with per instance ids do not read the block
+		if (writes && pick_id != pick_id_per_instance) {
+			const pick_block_t block = { pick_id, { 0, 0, 0 } };
+
+			glBindBuffer (GL_UNIFORM_BUFFER, m_pick_ubo);
+			glBufferSubData (GL_UNIFORM_BUFFER, 0, sizeof (pick_block_t), &block);
+			glBindBuffer (GL_UNIFORM_BUFFER, static_cast<GLuint>(NULL));
+		}
+	}
+
+	bool app_context::m_read_pick_region (int32_t & x, int32_t & y, int32_t & width, int32_t & height, std::vector<uint32_t> & ids) {
+		const int32_t x0 = std::max (x, 0);
+		const int32_t y0 = std::max (y, 0);
+		const int32_t x1 = std::min (x + width, m_video_mode.get_buffer_width ());
+		const int32_t y1 = std::min (y + height, m_video_mode.get_buffer_height ());
+
+		if (x1 <= x0 || y1 <= y0) {
+			return false;
+		}
+
+		x = x0;
+		y = y0;
+		width = x1 - x0;
+		height = y1 - y0;
+
+		// resolve only the requested region, a multisampled buffer cannot be read directly
+		glBindFramebuffer (GL_READ_FRAMEBUFFER, m_framebuffer[back]);
+		glReadBuffer (GL_COLOR_ATTACHMENT1);
+		glBindFramebuffer (GL_DRAW_FRAMEBUFFER, m_pick_framebuffer);
+
+		glBlitFramebuffer (x0, y0, x1, y1, x0, y0, x1, y1, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+		ids.resize (static_cast<std::size_t> (width) * height);
+
+		glBindFramebuffer (GL_READ_FRAMEBUFFER, m_pick_framebuffer);
+		glPixelStorei (GL_PACK_ALIGNMENT, 4);
+		glReadPixels (x0, y0, width, height, GL_RED_INTEGER, GL_UNSIGNED_INT, ids.data ());
+
+		// the blit to the front buffer reads the color attachment
+		glBindFramebuffer (GL_READ_FRAMEBUFFER, m_framebuffer[back]);
+		glReadBuffer (GL_COLOR_ATTACHMENT0);
+
+		glBindFramebuffer (GL_READ_FRAMEBUFFER, static_cast<GLuint>(NULL));
+		glBindFramebuffer (GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(NULL));
+
+		return true;
+	}
+
 	void app_context::m_destroy_frame_buffer () {
 		glDeleteFramebuffers (2, m_framebuffer);
 		glDeleteTextures (2, m_colorbuffer);
 		glDeleteRenderbuffers (1, &m_renderbuffer);
+
+		glDeleteTextures (1, &m_idbuffer);
+		glDeleteFramebuffers (1, &m_pick_framebuffer);
+		glDeleteRenderbuffers (1, &m_pick_renderbuffer);
 	}
 
 	void app_context::m_destroy_screen_quad () {
 		glDeleteBuffers (3, m_quad_buffer);
 		glDeleteVertexArrays (1, &m_quad_vao);
 	}
+
+	void app_context::m_destroy_camera_block () {
+		glDeleteBuffers (1, &m_camera_ubo);
+	}
+
+	void app_context::m_destroy_pick_block () {
+		glDeleteBuffers (1, &m_pick_ubo);
+	}
 }
\ No newline at end of file
@@ -159,20 +159,19 @@ namespace mini {
 		m_shader->bind ();
 
 		// set uniforms
-		const auto& view_matrix = context.get_view_matrix ();
-		const auto& proj_matrix = context.get_projection_matrix ();
-
 		//const auto & view_matrix = make_identity ();
 		//const auto& proj_matrix = make_identity ();
 
-		m_shader->set_uniform ("u_world", world_matrix);
-		m_shader->set_uniform ("u_view", view_matrix);
-		m_shader->set_uniform ("u_projection", proj_matrix);
+		m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::world), world_matrix);
 
 		glDrawElements (GL_TRIANGLES, cube_indices.size (), GL_UNSIGNED_INT, NULL);
 		glBindVertexArray (static_cast<GLuint>(NULL));
 	}
 
+	render_key_t cube_object::get_render_key () const {
+		return { m_shader ? m_shader->get_program_handle () : 0, m_vao, 0 };
+	}
+
 	void cube_object::configure () {
 		// basic configuration properties
 		scene_obj_t::configure ();
@@ -111,29 +111,16 @@ namespace mini {
             return;
         }
 
-        const auto& view_matrix = context.get_view_matrix();
-        const auto& proj_matrix = context.get_projection_matrix();
-
-        const auto& video_mode = context.get_video_mode();
-
-        glm::vec2 resolution = {
-            static_cast<float> (video_mode.get_buffer_width()),
-            static_cast<float> (video_mode.get_buffer_height())
-        };
-
         glBindVertexArray(m_vao);
 
         m_line_shader->bind();
-        m_line_shader->set_uniform("u_world", world_matrix);
-        m_line_shader->set_uniform("u_view", view_matrix);
-        m_line_shader->set_uniform("u_projection", proj_matrix);
-        m_line_shader->set_uniform("u_resolution", resolution);
-        m_line_shader->set_uniform("u_line_width", m_line_width);
+        m_line_shader->set_uniform(m_line_shader->get_uniform_location(shader_uniform_t::world), world_matrix);
+        m_line_shader->set_uniform(m_line_shader->get_uniform_location(shader_uniform_t::line_width), m_line_width);
 
         if (!is_selected()) {
-            m_line_shader->set_uniform("u_color", m_color);
+            m_line_shader->set_uniform(m_line_shader->get_uniform_location(shader_uniform_t::color), m_color);
         } else {
-            m_line_shader->set_uniform("u_color", m_color * point_object::s_select_default);
+            m_line_shader->set_uniform(m_line_shader->get_uniform_location(shader_uniform_t::color), m_color * point_object::s_select_default);
         }
 
         glDrawElements(GL_LINES, m_indices.size(), GL_UNSIGNED_INT, 0);
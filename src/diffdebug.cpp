@@ -116,6 +116,8 @@ namespace mini {
 			t_listen(signal_event_t::moved, *surface);
 			t_listen(signal_event_t::changed, *surface);
 			t_listen(signal_event_t::topology, *surface);
+
+			get_scene().subscribe(scene_event_t::deleted, shared_from_this());
 		}
 
 		m_signals_setup = true;
@@ -140,21 +142,30 @@ namespace mini {
 			const float su = w / static_cast<float>(m_res_u);
 			const float sv = h / static_cast<float>(m_res_v);
 
+			std::vector<float> us, vs;
+			us.reserve(m_res_u * m_res_v);
+			vs.reserve(m_res_u * m_res_v);
+
 			for (unsigned int iu = 0; iu < m_res_u; ++iu) {
 				for (unsigned int iv = 0; iv < m_res_v; ++iv) {
-					unsigned int b = ((iu * m_res_v) + iv) * 2;
+					us.push_back(iu * su);
+					vs.push_back(iv * sv);
+				}
+			}
 
-					const float u = iu * su;
-					const float v = iv * sv;
+			surface_samples samples;
+			surface->evaluate(us.data(), vs.data(), us.size(), samples);
 
-					auto p = surface->sample(u, v);
-					auto n = p + m_scale * surface->normal(u, v);
+			for (unsigned int i = 0; i < samples.size(); ++i) {
+				unsigned int b = i * 2;
 
-					m_segments->update_point(b + 0, p);
-					m_segments->update_point(b + 1, n);
+				auto p = samples.position(i);
+				auto n = p + m_scale * samples.normal(i);
 
-					m_segments->add_segment(b + 0, b + 1);
-				}
+				m_segments->update_point(b + 0, p);
+				m_segments->update_point(b + 1, n);
+
+				m_segments->add_segment(b + 0, b + 1);
 			}
 		}
 
@@ -0,0 +1,69 @@
+#include <stdexcept>
+
+#include "diffsurf.hpp"
+
+namespace mini {
+	void surface_samples::resize(std::size_t count) {
+		for (auto * values : { &x, &y, &z, &du_x, &du_y, &du_z, &dv_x, &dv_y, &dv_z, &n_x, &n_y, &n_z }) {
+			values->resize(count);
+		}
+	}
+
+	std::size_t surface_samples::size() const {
+		return x.size();
+	}
+
+	void surface_samples::set(std::size_t i, const glm::vec3 & position, const glm::vec3 & du, const glm::vec3 & dv, const glm::vec3 & normal) {
+		x[i] = position.x;
+		y[i] = position.y;
+		z[i] = position.z;
+
+		du_x[i] = du.x;
+		du_y[i] = du.y;
+		du_z[i] = du.z;
+
+		dv_x[i] = dv.x;
+		dv_y[i] = dv.y;
+		dv_z[i] = dv.z;
+
+		n_x[i] = normal.x;
+		n_y[i] = normal.y;
+		n_z[i] = normal.z;
+	}
+
+	glm::vec3 surface_samples::position(std::size_t i) const {
+		return { x[i], y[i], z[i] };
+	}
+
+	glm::vec3 surface_samples::ddu(std::size_t i) const {
+		return { du_x[i], du_y[i], du_z[i] };
+	}
+
+	glm::vec3 surface_samples::ddv(std::size_t i) const {
+		return { dv_x[i], dv_y[i], dv_z[i] };
+	}
+
+	glm::vec3 surface_samples::normal(std::size_t i) const {
+		return { n_x[i], n_y[i], n_z[i] };
+	}
+
+	void differentiable_surface_base::evaluate(const float * u, const float * v, std::size_t count, surface_samples & out) const {
+		out.resize(count);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			out.set(i, sample(u[i], v[i]), ddu(u[i], v[i]), ddv(u[i], v[i]), normal(u[i], v[i]));
+		}
+	}
+
+	bool differentiable_surface_base::is_trimmable() const {
+		return false;
+	}
+
+	trimmable_surface_domain& differentiable_surface_base::get_trimmable_domain() {
+		throw std::runtime_error("this surface is not trimmable");
+	}
+
+	const patch_bvh* differentiable_surface_base::get_bvh() const {
+		return nullptr;
+	}
+}
@@ -80,9 +80,6 @@ namespace mini {
 		glBindVertexArray (m_mesh_arrow.vao);
 		m_shader_mesh->bind ();
 
-		const auto & view_matrix = context.get_view_matrix ();
-		const auto & proj_matrix = context.get_projection_matrix ();
-
 		auto local = make_translation ({ 0.0f, 1.0f, 0.0f });
 
 		glm::vec3 center = world_matrix * glm::vec4 { 0.0f, 0.0f, 0.0f, 1.0f };
@@ -95,19 +92,16 @@ namespace mini {
 		glm::mat4x4 forward = scale * make_rotation_z (-glm::pi<float> () * 0.5f) * local;
 		glm::mat4x4 left = scale * make_rotation_x (-glm::pi<float> () * 0.5f) * local;
 
-		m_shader_mesh->set_uniform ("u_view", view_matrix);
-		m_shader_mesh->set_uniform ("u_projection", proj_matrix);
-
-		m_shader_mesh->set_uniform ("u_world", world_matrix * up);
-		m_shader_mesh->set_uniform ("u_color", glm::vec4{ 0.0f, 1.0f, 0.0f, 1.0f });
+		m_shader_mesh->set_uniform (m_shader_mesh->get_uniform_location (shader_uniform_t::world), world_matrix * up);
+		m_shader_mesh->set_uniform (m_shader_mesh->get_uniform_location (shader_uniform_t::color), glm::vec4{ 0.0f, 1.0f, 0.0f, 1.0f });
 		glDrawElements (GL_TRIANGLES, m_mesh_arrow.indices.size (), GL_UNSIGNED_INT, NULL);
 
-		m_shader_mesh->set_uniform ("u_world", world_matrix * forward);
-		m_shader_mesh->set_uniform ("u_color", glm::vec4{ 1.0f, 0.0f, 0.0f, 1.0f });
+		m_shader_mesh->set_uniform (m_shader_mesh->get_uniform_location (shader_uniform_t::world), world_matrix * forward);
+		m_shader_mesh->set_uniform (m_shader_mesh->get_uniform_location (shader_uniform_t::color), glm::vec4{ 1.0f, 0.0f, 0.0f, 1.0f });
 		glDrawElements (GL_TRIANGLES, m_mesh_arrow.indices.size (), GL_UNSIGNED_INT, NULL);
 
-		m_shader_mesh->set_uniform ("u_world", world_matrix * left);
-		m_shader_mesh->set_uniform ("u_color", glm::vec4{ 0.0f, 0.0f, 1.0f, 1.0f });
+		m_shader_mesh->set_uniform (m_shader_mesh->get_uniform_location (shader_uniform_t::world), world_matrix * left);
+		m_shader_mesh->set_uniform (m_shader_mesh->get_uniform_location (shader_uniform_t::color), glm::vec4{ 0.0f, 0.0f, 1.0f, 1.0f });
 		glDrawElements (GL_TRIANGLES, m_mesh_arrow.indices.size (), GL_UNSIGNED_INT, NULL);
 
 		glBindVertexArray (0);
@@ -143,13 +143,13 @@ namespace mini {
 
 				m_bind_shader (context, *m_solid_shader.get (), world_matrix);
 
-				m_solid_shader->set_uniform_uint ("u_resolution_v", static_cast<GLuint> (m_res_v));
-				m_solid_shader->set_uniform_uint ("u_resolution_u", static_cast<GLuint> (m_res_u));
+				m_solid_shader->set_uniform_uint (m_solid_shader->get_uniform_location (shader_uniform_t::resolution_v), static_cast<GLuint> (m_res_v));
+				m_solid_shader->set_uniform_uint (m_solid_shader->get_uniform_location (shader_uniform_t::resolution_u), static_cast<GLuint> (m_res_u));
 
 				if (!is_selected ()) {
-					m_solid_shader->set_uniform ("u_color", m_color);
+					m_solid_shader->set_uniform (m_solid_shader->get_uniform_location (shader_uniform_t::color), m_color);
 				} else {
-					m_solid_shader->set_uniform ("u_color", m_color * point_object::s_select_default);
+					m_solid_shader->set_uniform (m_solid_shader->get_uniform_location (shader_uniform_t::color), m_color * point_object::s_select_default);
 				}
 
 				glPatchParameteri (GL_PATCH_VERTICES, 20);
@@ -160,23 +160,23 @@ namespace mini {
 				m_bind_shader (context, *m_isoline_shader.get (), world_matrix);
 
 				if (!is_selected ()) {
-					m_solid_shader->set_uniform ("u_color", m_color);
+					m_solid_shader->set_uniform (m_solid_shader->get_uniform_location (shader_uniform_t::color), m_color);
 				} else {
-					m_solid_shader->set_uniform ("u_color", m_color * point_object::s_select_default);
+					m_solid_shader->set_uniform (m_solid_shader->get_uniform_location (shader_uniform_t::color), m_color * point_object::s_select_default);
 				}
 
 				// first render pass - u,v
-				m_isoline_shader->set_uniform_int ("u_vertical", true);
-				m_isoline_shader->set_uniform_uint ("u_resolution_v", static_cast<GLuint> (m_res_v));
-				m_isoline_shader->set_uniform_uint ("u_resolution_u", static_cast<GLuint> (m_res_u));
+				m_isoline_shader->set_uniform_int (m_isoline_shader->get_uniform_location (shader_uniform_t::vertical), true);
+				m_isoline_shader->set_uniform_uint (m_isoline_shader->get_uniform_location (shader_uniform_t::resolution_v), static_cast<GLuint> (m_res_v));
+				m_isoline_shader->set_uniform_uint (m_isoline_shader->get_uniform_location (shader_uniform_t::resolution_u), static_cast<GLuint> (m_res_u));
 
 				glPatchParameteri (GL_PATCH_VERTICES, 20);
 				glDrawArrays (GL_PATCHES, 0, m_positions.size ());
 
 				// second render pass = v,u
-				m_isoline_shader->set_uniform_int ("u_vertical", false);
-				m_isoline_shader->set_uniform_uint ("u_resolution_v", static_cast<GLuint> (m_res_u));
-				m_isoline_shader->set_uniform_uint ("u_resolution_u", static_cast<GLuint> (m_res_v));
+				m_isoline_shader->set_uniform_int (m_isoline_shader->get_uniform_location (shader_uniform_t::vertical), false);
+				m_isoline_shader->set_uniform_uint (m_isoline_shader->get_uniform_location (shader_uniform_t::resolution_v), static_cast<GLuint> (m_res_u));
+				m_isoline_shader->set_uniform_uint (m_isoline_shader->get_uniform_location (shader_uniform_t::resolution_u), static_cast<GLuint> (m_res_v));
 
 				glPatchParameteri (GL_PATCH_VERTICES, 20);
 				glDrawArrays (GL_PATCHES, 0, m_positions.size ());
@@ -187,7 +187,7 @@ namespace mini {
 				glBindVertexArray (m_line_vao);
 
 				m_bind_shader (context, *m_line_shader, world_matrix);
-				m_line_shader->set_uniform ("u_color", m_grid_color);
+				m_line_shader->set_uniform (m_line_shader->get_uniform_location (shader_uniform_t::color), m_grid_color);
 
 				glDrawArrays (GL_LINES, 0, m_line_positions.size ());
 			}
@@ -220,7 +220,11 @@ namespace mini {
 			t_listen (signal_event_t::topology, *surf1);
 			t_listen (signal_event_t::topology, *surf2);
 			t_listen (signal_event_t::topology, *surf3);
+
+			get_scene ().subscribe (scene_event_t::deleted, shared_from_this ());
 		}
+
+		m_signals_setup = true;
 	}
 
 	void gregory_surface::m_changed_sighandler (signal_event_t sig, scene_obj_t & sender) {
@@ -283,21 +287,8 @@ namespace mini {
 	void gregory_surface::m_bind_shader (app_context & context, shader_t & shader, const glm::mat4x4 & world_matrix) const {
 		shader.bind ();
 
-		const auto & view_matrix = context.get_view_matrix ();
-		const auto & proj_matrix = context.get_projection_matrix ();
-
-		const auto & video_mode = context.get_video_mode ();
-
-		glm::vec2 resolution = {
-			static_cast<float> (video_mode.get_buffer_width ()),
-			static_cast<float> (video_mode.get_buffer_height ())
-		};
-
-		shader.set_uniform ("u_world", world_matrix);
-		shader.set_uniform ("u_view", view_matrix);
-		shader.set_uniform ("u_projection", proj_matrix);
-		shader.set_uniform ("u_resolution", resolution);
-		shader.set_uniform ("u_line_width", 2.0f);
+		shader.set_uniform (shader.get_uniform_location (shader_uniform_t::world), world_matrix);
+		shader.set_uniform (shader.get_uniform_location (shader_uniform_t::line_width), 2.0f);
 	}
 
 	void gregory_surface::m_calculate_points () {
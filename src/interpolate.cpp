@@ -65,12 +65,12 @@ namespace mini {
 			glBindVertexArray (m_vao);
 			m_bind_shader (context, m_shader1, world_matrix);
 
-			m_shader1->set_uniform ("u_start_t", 0.0f);
-			m_shader1->set_uniform ("u_end_t", 0.5f);
+			m_shader1->set_uniform (m_shader1->get_uniform_location (shader_uniform_t::start_t), 0.0f);
+			m_shader1->set_uniform (m_shader1->get_uniform_location (shader_uniform_t::end_t), 0.5f);
 			glDrawArrays (GL_LINES_ADJACENCY, 0, static_cast<GLsizei>(m_bezier_buffer.size ()));
 
-			m_shader1->set_uniform ("u_start_t", 0.5f);
-			m_shader1->set_uniform ("u_end_t", 1.0f);
+			m_shader1->set_uniform (m_shader1->get_uniform_location (shader_uniform_t::start_t), 0.5f);
+			m_shader1->set_uniform (m_shader1->get_uniform_location (shader_uniform_t::end_t), 1.0f);
 			glDrawArrays (GL_LINES_ADJACENCY, 0, static_cast<GLsizei>(m_bezier_buffer.size ()));
 
 			if (is_show_polygon ()) {
@@ -354,21 +354,8 @@ namespace mini {
 	void interpolating_curve::m_bind_shader (app_context & context, std::shared_ptr<shader_t> shader, const glm::mat4x4 & world_matrix) const {
 		shader->bind ();
 
-		const auto & view_matrix = context.get_view_matrix ();
-		const auto & proj_matrix = context.get_projection_matrix ();
-
-		const auto & video_mode = context.get_video_mode ();
-
-		glm::vec2 resolution = {
-			static_cast<float> (video_mode.get_buffer_width ()),
-			static_cast<float> (video_mode.get_buffer_height ())
-		};
-
-		shader->set_uniform ("u_world", world_matrix);
-		shader->set_uniform ("u_view", view_matrix);
-		shader->set_uniform ("u_projection", proj_matrix);
-		shader->set_uniform ("u_resolution", resolution);
-		shader->set_uniform ("u_line_width", 2.0f);
-		shader->set_uniform ("u_color", get_color ());
+		shader->set_uniform (shader->get_uniform_location (shader_uniform_t::world), world_matrix);
+		shader->set_uniform (shader->get_uniform_location (shader_uniform_t::line_width), 2.0f);
+		shader->set_uniform (shader->get_uniform_location (shader_uniform_t::color), get_color ());
 	}
 }
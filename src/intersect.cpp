@@ -0,0 +1,1051 @@
+#include <array>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+#include "intersect.hpp"
+#include "bvh.hpp"
+
+namespace mini {
+	// gaussian method
+	// solve equation Ax = b
+	inline void gauss(const glm::mat4x4 & A, const glm::vec4 & b, glm::vec4 & x) {
+		glm::mat4x4 M = glm::transpose(A);
+		glm::vec4 c = b;
+
+		for (int k = 0; k < 4; ++k) {
+			int pivot = k;
+			float pivot_val = 0.0f;
+
+			// find pivot
+			for (int i = k; i < 4; ++i) {
+				float a = fabsf(M[i][k]);
+				if (a > pivot_val) {
+					pivot = i;
+					pivot_val = a;
+				}
+			}
+
+			// swap rows k and pivot
+			if (pivot != k) {
+				for (int i = k; i < 4; ++i) {
+					std::swap(M[pivot][i], M[k][i]);
+				}
+
+				std::swap(c[pivot], c[k]);
+			}
+
+			// elimination
+			for (int i = k + 1; i < 4; ++i) {
+				float m = M[i][k] / M[k][k];
+				for (int j = k; j < 4; ++j) {
+					M[i][j] -= m * M[k][j];
+				}
+
+				c[i] -= m * c[k];
+			}
+		}
+
+		// back substitution
+		for (int k = 3; k >= 0; --k) {
+			float sum = c[k];
+			for (int j = k + 1; j < 4; ++j) {
+				sum -= M[k][j] * x[j];
+			}
+
+			x[k] = sum / M[k][k];
+		}
+	}
+
+	constexpr std::array<glm::vec2, 5> c_offsets = { glm::vec2{0.0f, 0.0f}, {0.5f, 0.5f}, {1.0f, 1.0f}, {0.0f, 1.0f}, {1.0f, 0.0f} };
+
+	using surface_ref = const differentiable_surface_base &;
+
+	void wrap_coordinates(surface_ref surface, float & u, float & v) {
+		bool is_u_wrapped = surface.is_u_wrapped();
+		bool is_v_wrapped = surface.is_v_wrapped();
+
+		const auto min_u = surface.get_min_u();
+		const auto min_v = surface.get_min_v();
+		const auto max_u = surface.get_max_u();
+		const auto max_v = surface.get_max_v();
+
+		if (u > max_u) {
+			if (is_u_wrapped) {
+				u = u - max_u;
+			} else {
+				u = max_u;
+			}
+		} else if (u < min_u) {
+			if (is_u_wrapped) {
+				u = u + max_u;
+			} else {
+				u = min_u;
+			}
+		}
+
+		if (v > max_v) {
+			if (is_v_wrapped) {
+				v = v - max_v;
+			} else {
+				v = max_v;
+			}
+		} else if (v < min_v) {
+			if (is_v_wrapped) {
+				v = v + max_v;
+			} else {
+				v = min_v;
+			}
+		}
+	}
+
+	static glm::vec2 project_point_gradient(surface_ref surface, const glm::vec3 & point, const glm::vec2 & s) {
+		const auto ddu = [&](float u, float v) -> float {
+			const auto der = -2.0f * (point - surface.sample(u, v)) * surface.ddu(u, v);
+			return der.x + der.y + der.z;
+		};
+
+		const auto ddv = [&](float u, float v) -> float {
+			const auto der = -2.0f * (point - surface.sample(u, v)) * surface.ddv(u, v);
+			return der.x + der.y + der.z;
+		};
+
+		glm::vec2 current = s;
+		glm::vec2 previous = current;
+
+		constexpr float c_start_step = 0.005f;
+		constexpr float c_epsilon = 0.00001f;
+		constexpr int c_max_steps = 200;
+
+		for (int num_steps = 0; num_steps < c_max_steps; ++num_steps) {
+			glm::vec2 direction = {
+				ddu(current.x, current.y),
+				ddv(current.x, current.y)
+			};
+
+			previous = current;
+			current = current - direction * c_start_step;
+
+			wrap_coordinates(surface, current.x, current.y);
+
+			if (glm::distance(current, previous) < c_epsilon) {
+				break;
+			}
+		}
+
+		return current;
+	}
+
+	// levenberg-marquardt minimization of |S(u,v) - point|
+	static glm::vec2 project_point_newton(surface_ref surface, const glm::vec3 & point, const glm::vec2 & s) {
+		constexpr int c_max_steps = 50;
+		constexpr float c_epsilon = 0.000001f;
+
+		glm::vec2 current = s;
+		glm::vec3 r = surface.sample(current.x, current.y) - point;
+
+		float cost = glm::dot(r, r);
+		float lambda = 0.001f;
+
+		for (int num_steps = 0; num_steps < c_max_steps; ++num_steps) {
+			const auto su = surface.ddu(current.x, current.y);
+			const auto sv = surface.ddv(current.x, current.y);
+
+			// normal equations (J^T J + lambda D) x = -J^T r
+			float a11 = glm::dot(su, su);
+			float a12 = glm::dot(su, sv);
+			float a22 = glm::dot(sv, sv);
+
+			glm::vec2 g = { glm::dot(su, r), glm::dot(sv, r) };
+
+			if (glm::length(g) < c_epsilon) {
+				break;
+			}
+
+			float m11 = a11 + lambda * (a11 + c_epsilon);
+			float m22 = a22 + lambda * (a22 + c_epsilon);
+			float det = m11 * m22 - a12 * a12;
+
+			if (fabsf(det) < 1e-12f) {
+				lambda = lambda * 10.0f;
+				continue;
+			}
+
+			glm::vec2 step = {
+				-(m22 * g.x - a12 * g.y) / det,
+				-(m11 * g.y - a12 * g.x) / det
+			};
+
+			glm::vec2 next = current + step;
+			wrap_coordinates(surface, next.x, next.y);
+
+			const auto next_r = surface.sample(next.x, next.y) - point;
+			const auto next_cost = glm::dot(next_r, next_r);
+
+			if (next_cost < cost) {
+				current = next;
+				r = next_r;
+				cost = next_cost;
+				lambda = glm::max(lambda * 0.3f, 1e-7f);
+
+				if (glm::length(step) < c_epsilon) {
+					break;
+				}
+			} else {
+				lambda = lambda * 10.0f;
+
+				if (lambda > 1e7f) {
+					break;
+				}
+			}
+		}
+
+		return current;
+	}
+
+	static glm::vec2 project_point(surface_ref surface, const intersection_options & options, const glm::vec3 & point, const glm::vec2 & s) {
+		if (options.solver == intersection_solver::newton) {
+			return project_point_newton(surface, point, s);
+		}
+
+		return project_point_gradient(surface, point, s);
+	}
+
+	// closest point projection starting from the patch nearest to the point,
+	// surfaces without a patch hierarchy try a handful of fixed parameters
+	static glm::vec2 project_closest(surface_ref surface, const intersection_options & options, const glm::vec3 & point) {
+		std::vector<glm::vec2> starts;
+		const auto * bvh = surface.get_bvh();
+
+		if (bvh && !bvh->empty()) {
+			const auto & leaf = bvh->get_leaf(bvh->find_closest(point));
+			starts.push_back(0.5f * (leaf.min_param + leaf.max_param));
+		} else {
+			starts.assign(c_offsets.begin(), c_offsets.end());
+		}
+
+		glm::vec2 result = starts.front();
+		auto dist = 100000.0f;
+
+		for (const auto & sp : starts) {
+			auto cproj = project_point(surface, options, point, sp);
+			auto cdist = glm::distance(surface.sample(cproj.x, cproj.y), point);
+
+			if (cdist < dist) {
+				result = cproj;
+				dist = cdist;
+			}
+		}
+
+		return result;
+	}
+
+	static void start_by_hint(
+		surface_ref surface1,
+		surface_ref surface2,
+		const intersection_options & options,
+		glm::vec2 & s1,
+		glm::vec2 & s2) {
+
+		s1 = project_closest(surface1, options, options.hint);
+		s2 = project_closest(surface2, options, options.hint);
+	}
+
+	static void descend_gradient(
+		surface_ref surface1,
+		surface_ref surface2,
+		glm::vec4 & current) {
+
+		// surface1 is parameterized by u,v
+		// surface2 is parameterized by p,q
+		// we look using gradients for such (u,v,p,q) that the distance function
+		// d(u,v,p,q) = |S1(u,v) - S2(p,q)|
+		// is minimal
+
+		const auto gradient = [&](const glm::vec4 & x) -> glm::vec4 {
+			const auto diff = surface1.sample(x[0], x[1]) - surface2.sample(x[2], x[3]);
+
+			return {
+				2.0f * glm::dot(surface1.ddu(x[0], x[1]), diff),
+				2.0f * glm::dot(surface1.ddv(x[0], x[1]), diff),
+				-2.0f * glm::dot(surface2.ddu(x[2], x[3]), diff),
+				-2.0f * glm::dot(surface2.ddv(x[2], x[3]), diff)
+			};
+		};
+
+		glm::vec4 previous = current;
+
+		constexpr float c_start_step = 0.005f;
+		constexpr float c_start_epsilon = 0.0001f;
+		constexpr float c_step_mult = 1.0f / 2.0f;
+		constexpr float c_eps_mult = 1.0f / 10.0f;
+		constexpr int c_max_steps = 1000;
+		constexpr int c_max_epsd = 5;
+
+		float step = c_start_step;
+		float epsilon = c_start_epsilon;
+		float d1 = 0.0f, d2 = 0.0f;
+
+		int num_steps = 0, epsd = 0;
+
+		do {
+			previous = current;
+			current = current - gradient(current) * step;
+
+			wrap_coordinates(surface1, current.x, current.y);
+			wrap_coordinates(surface2, current.z, current.w);
+
+			float du = current[0] - previous[0];
+			float dv = current[1] - previous[1];
+			float dp = current[2] - previous[2];
+			float dq = current[3] - previous[3];
+
+			d1 = glm::sqrt(du*du + dv*dv);
+			d2 = glm::sqrt(dp*dp + dq*dq);
+
+			num_steps++;
+			if (d1 < epsilon && d2 < epsilon && epsd < c_max_epsd) {
+				epsd++;
+				epsilon = epsilon * c_eps_mult;
+				step = step * c_step_mult;
+			}
+		} while ((d1 > epsilon || d2 > epsilon) && num_steps < c_max_steps);
+	}
+
+	// levenberg-marquardt on the residual r(u,v,p,q) = S1(u,v) - S2(p,q)
+	// the system is underdetermined (3 equations, 4 unknowns), the damping
+	// term keeps the normal equations solvable and picks the shortest step
+	static void descend_newton(
+		surface_ref surface1,
+		surface_ref surface2,
+		glm::vec4 & current) {
+
+		constexpr int c_max_steps = 50;
+		constexpr float c_epsilon = 0.000001f;
+
+		glm::vec3 r = surface1.sample(current[0], current[1]) - surface2.sample(current[2], current[3]);
+
+		float cost = glm::dot(r, r);
+		float lambda = 0.001f;
+
+		for (int num_steps = 0; num_steps < c_max_steps && cost > c_epsilon * c_epsilon; ++num_steps) {
+			const std::array<glm::vec3, 4> columns = {
+				surface1.ddu(current[0], current[1]),
+				surface1.ddv(current[0], current[1]),
+				-surface2.ddu(current[2], current[3]),
+				-surface2.ddv(current[2], current[3])
+			};
+
+			glm::mat4x4 A(0.0f);
+			glm::vec4 g;
+
+			for (int i = 0; i < 4; ++i) {
+				g[i] = glm::dot(columns[i], r);
+
+				for (int j = 0; j < 4; ++j) {
+					A[j][i] = glm::dot(columns[i], columns[j]);
+				}
+			}
+
+			for (int i = 0; i < 4; ++i) {
+				A[i][i] = A[i][i] + lambda * (A[i][i] + c_epsilon);
+			}
+
+			glm::vec4 step;
+			gauss(A, -g, step);
+
+			glm::vec4 next = current + step;
+			wrap_coordinates(surface1, next.x, next.y);
+			wrap_coordinates(surface2, next.z, next.w);
+
+			const auto next_r = surface1.sample(next[0], next[1]) - surface2.sample(next[2], next[3]);
+			const auto next_cost = glm::dot(next_r, next_r);
+
+			if (next_cost < cost) {
+				current = next;
+				r = next_r;
+				cost = next_cost;
+				lambda = glm::max(lambda * 0.3f, 1e-7f);
+
+				if (glm::length(step) < c_epsilon) {
+					break;
+				}
+			} else {
+				lambda = lambda * 10.0f;
+
+				if (lambda > 1e7f) {
+					break;
+				}
+			}
+		}
+	}
+
+	static bool find_starting_points(
+		surface_ref surface1,
+		surface_ref surface2,
+		const intersection_options & options,
+		glm::vec2 & p1,
+		glm::vec2 & p2,
+		const glm::vec2 & s1,
+		const glm::vec2 & s2) {
+
+		glm::vec4 current = { s1.x, s1.y, s2.x, s2.y };
+
+		if (options.solver == intersection_solver::newton) {
+			descend_newton(surface1, surface2, current);
+		} else {
+			descend_gradient(surface1, surface2, current);
+		}
+
+		// check if this is actually a point of intersection
+		auto pos1 = surface1.sample(current[0], current[1]);
+		auto pos2 = surface2.sample(current[2], current[3]);
+
+		if (glm::distance(pos1, pos2) > options.tolerance) {
+			return false;
+		}
+
+		p1 = { current[0], current[1] };
+		p2 = { current[2], current[3] };
+
+		return true;
+	}
+
+	inline bool is_in_domain(surface_ref surface, const glm::vec2 & p) {
+		if (!surface.is_u_wrapped() && (p.x < surface.get_min_u() || p.x > surface.get_max_u())) {
+			return false;
+		}
+
+		if (!surface.is_v_wrapped() && (p.y < surface.get_min_v() || p.y > surface.get_max_v())) {
+			return false;
+		}
+
+		return true;
+	}
+
+	// shortest parameter difference b - a, taking wrapping into account
+	inline glm::vec2 wrapped_difference(surface_ref surface, const glm::vec2 & a, const glm::vec2 & b) {
+		glm::vec2 d = b - a;
+
+		if (surface.is_u_wrapped()) {
+			const auto range = surface.get_max_u() - surface.get_min_u();
+
+			if (d.x > 0.5f * range) {
+				d.x = d.x - range;
+			} else if (d.x < -0.5f * range) {
+				d.x = d.x + range;
+			}
+		}
+
+		if (surface.is_v_wrapped()) {
+			const auto range = surface.get_max_v() - surface.get_min_v();
+
+			if (d.y > 0.5f * range) {
+				d.y = d.y - range;
+			} else if (d.y < -0.5f * range) {
+				d.y = d.y + range;
+			}
+		}
+
+		return d;
+	}
+
+	// parameter increment that moves the surface point by the given world offset
+	inline glm::vec2 parameter_offset(surface_ref surface, const glm::vec2 & p, const glm::vec3 & offset) {
+		const auto su = surface.ddu(p.x, p.y);
+		const auto sv = surface.ddv(p.x, p.y);
+
+		float a11 = glm::dot(su, su);
+		float a12 = glm::dot(su, sv);
+		float a22 = glm::dot(sv, sv);
+		float det = a11 * a22 - a12 * a12;
+
+		if (fabsf(det) < 1e-12f) {
+			return { 0.0f, 0.0f };
+		}
+
+		float b1 = glm::dot(su, offset);
+		float b2 = glm::dot(sv, offset);
+
+		return {
+			(a22 * b1 - a12 * b2) / det,
+			(a11 * b2 - a12 * b1) / det
+		};
+	}
+
+	inline bool intersection_tangent(surface_ref surface1, surface_ref surface2, const glm::vec4 & x, float sign, glm::vec3 & t) {
+		auto n1 = surface1.normal(x[0], x[1]);
+		auto n2 = surface2.normal(x[2], x[3]);
+		auto c = glm::cross(n1, n2);
+
+		auto len = glm::length(c);
+		if (len < 1e-6f || len != len) {
+			// surfaces are tangent, the curve direction is undefined
+			return false;
+		}
+
+		t = sign * (c / len);
+		return true;
+	}
+
+	// traces the curve in one direction, returns true if it closed into a loop
+	static bool trace_intersection(
+		surface_ref surface1,
+		surface_ref surface2,
+		const intersection_options & options,
+		glm::vec2 p1,
+		glm::vec2 p2,
+		float sign,
+		intersection_curve & out) {
+
+		constexpr int c_newton_steps = 8;
+		constexpr float c_newton_epsilon = 0.0001f;
+		constexpr float c_shrink_angle = 0.985f; // ~10 degrees between tangents
+		constexpr float c_grow_angle = 0.999f;   // ~2.5 degrees between tangents
+		constexpr float c_step_shrink = 0.5f;
+		constexpr float c_step_grow = 1.5f;
+
+		glm::vec3 t;
+		glm::vec3 P0;
+		float d = options.step;
+
+		const auto f = [&](const glm::vec4 & x) -> glm::vec4 {
+			auto P = surface1.sample(x[0], x[1]);
+			auto Q = surface2.sample(x[2], x[3]);
+
+			return {
+				P.x - Q.x,
+				P.y - Q.y,
+				P.z - Q.z,
+				glm::dot(P - P0, t) - d
+			};
+		};
+
+		const auto J = [&](const glm::vec4 & x) -> glm::mat4x4 {
+			auto dPdu = surface1.ddu(x[0], x[1]);
+			auto dPdv = surface1.ddv(x[0], x[1]);
+			auto dQdp = surface2.ddu(x[2], x[3]);
+			auto dQdq = surface2.ddv(x[2], x[3]);
+
+			// the plane equation only depends on the first surface
+			glm::mat4x4 jacobian{
+				dPdu.x, dPdu.y, dPdu.z, glm::dot(t, dPdu),
+				dPdv.x, dPdv.y, dPdv.z, glm::dot(t, dPdv),
+				-dQdp.x, -dQdp.y, -dQdp.z, 0.0f,
+				-dQdq.x, -dQdq.y, -dQdq.z, 0.0f
+			};
+
+			return jacobian;
+		};
+
+		// returns the number of iterations used or -1 on failure
+		const auto newton = [&](glm::vec4 & x) -> int {
+			for (int j = 0; j < c_newton_steps; ++j) {
+				auto value = f(x);
+				auto dist = glm::length(value);
+
+				if (dist != dist) {
+					return -1;
+				}
+
+				if (dist < c_newton_epsilon) {
+					return j;
+				}
+
+				glm::vec4 s;
+				gauss(J(x), -value, s);
+
+				x = x + s;
+			}
+
+			return (glm::length(f(x)) < c_newton_epsilon) ? c_newton_steps : -1;
+		};
+
+		out.params1.reserve(options.max_steps);
+		out.params2.reserve(options.max_steps);
+		out.directions1.reserve(options.max_steps);
+		out.directions2.reserve(options.max_steps);
+		out.points.reserve(options.max_steps);
+
+		const auto start_p1 = p1;
+		const auto start_p2 = p2;
+		const auto start_point = surface1.sample(p1.x, p1.y);
+
+		float travelled = 0.0f;
+		P0 = start_point;
+
+		for (int i = 0; i < options.max_steps; ++i) {
+			glm::vec4 current = { p1.x, p1.y, p2.x, p2.y };
+
+			if (!intersection_tangent(surface1, surface2, current, sign, t)) {
+				break;
+			}
+
+			// predictor, move both parameters along the tangent
+			auto o1 = parameter_offset(surface1, p1, t * d);
+			auto o2 = parameter_offset(surface2, p2, t * d);
+
+			glm::vec4 x = { p1.x + o1.x, p1.y + o1.y, p2.x + o2.x, p2.y + o2.y };
+
+			// corrector
+			int iterations = newton(x);
+			bool accepted = (iterations >= 0);
+
+			glm::vec3 next_t;
+			float alignment = 1.0f;
+
+			if (accepted) {
+				accepted = intersection_tangent(surface1, surface2, x, sign, next_t);
+				alignment = accepted ? glm::dot(t, next_t) : 0.0f;
+			}
+
+			if (!accepted || alignment < c_shrink_angle) {
+				if (d * c_step_shrink < options.min_step) {
+					break;
+				}
+
+				d = d * c_step_shrink;
+				continue;
+			}
+
+			glm::vec2 next1 = { x.x, x.y };
+			glm::vec2 next2 = { x.z, x.w };
+
+			// leaving a non-wrapped domain, home in on the boundary first
+			bool inside = is_in_domain(surface1, next1) && is_in_domain(surface2, next2);
+
+			if (!inside && d * c_step_shrink >= options.min_step) {
+				d = d * c_step_shrink;
+				continue;
+			}
+
+			out.directions1.push_back(next1 - p1);
+			out.directions2.push_back(next2 - p2);
+
+			p1 = next1;
+			p2 = next2;
+
+			wrap_coordinates(surface1, p1.x, p1.y);
+			wrap_coordinates(surface2, p2.x, p2.y);
+
+			P0 = surface1.sample(p1.x, p1.y);
+			travelled = travelled + d;
+
+			out.params1.push_back(p1);
+			out.params2.push_back(p2);
+			out.points.push_back(P0);
+
+			if (!inside) {
+				break;
+			}
+
+			// back at the start, close the loop and stop
+			if (travelled > 2.0f * d && glm::distance(P0, start_point) < d) {
+				auto d1 = wrapped_difference(surface1, p1, start_p1);
+				auto d2 = wrapped_difference(surface2, p2, start_p2);
+
+				out.directions1.push_back(d1);
+				out.directions2.push_back(d2);
+				out.params1.push_back(start_p1);
+				out.params2.push_back(start_p2);
+				out.points.push_back(start_point);
+
+				return true;
+			}
+
+			if (iterations <= 2 && alignment > c_grow_angle) {
+				d = glm::min(d * c_step_grow, options.max_step);
+			}
+		}
+
+		return false;
+	}
+
+	struct seed_cell {
+		aabb_t bounds;
+		glm::vec3 center_point;
+		glm::vec2 center;
+	};
+
+	// splits a parameter rectangle into a grid of cells and computes
+	// loose world space bounds of every cell from its sampled corners
+	static void build_seed_cells(
+		surface_ref surface,
+		const glm::vec2 & min_param,
+		const glm::vec2 & max_param,
+		int res_u,
+		int res_v,
+		std::vector<seed_cell> & cells) {
+
+		const auto du = (max_param.x - min_param.x) / static_cast<float>(res_u);
+		const auto dv = (max_param.y - min_param.y) / static_cast<float>(res_v);
+
+		// corners of all cells followed by their centers, evaluated in one batch
+		const int num_corners = (res_u + 1) * (res_v + 1);
+		std::vector<float> us, vs;
+		us.reserve(num_corners + res_u * res_v);
+		vs.reserve(num_corners + res_u * res_v);
+
+		for (int j = 0; j <= res_v; ++j) {
+			for (int i = 0; i <= res_u; ++i) {
+				us.push_back(min_param.x + i * du);
+				vs.push_back(min_param.y + j * dv);
+			}
+		}
+
+		for (int j = 0; j < res_v; ++j) {
+			for (int i = 0; i < res_u; ++i) {
+				us.push_back(min_param.x + (i + 0.5f) * du);
+				vs.push_back(min_param.y + (j + 0.5f) * dv);
+			}
+		}
+
+		surface_samples samples;
+		surface.evaluate(us.data(), vs.data(), us.size(), samples);
+
+		cells.clear();
+		cells.reserve(res_u * res_v);
+
+		for (int j = 0; j < res_v; ++j) {
+			for (int i = 0; i < res_u; ++i) {
+				const int center = num_corners + j * res_u + i;
+
+				seed_cell cell;
+				cell.center = { us[center], vs[center] };
+				cell.center_point = samples.position(center);
+				cell.bounds = { cell.center_point, cell.center_point };
+
+				cell.bounds.extend(samples.position((j + 0) * (res_u + 1) + i + 0));
+				cell.bounds.extend(samples.position((j + 0) * (res_u + 1) + i + 1));
+				cell.bounds.extend(samples.position((j + 1) * (res_u + 1) + i + 0));
+				cell.bounds.extend(samples.position((j + 1) * (res_u + 1) + i + 1));
+
+				// the surface bulges between samples, inflate the box
+				// proportionally to its size to stay conservative
+				cell.bounds.inflate(0.25f * glm::length(cell.bounds.max - cell.bounds.min));
+				cells.push_back(cell);
+			}
+		}
+	}
+
+	// returns the patch hierarchy of the surface, surfaces that do not keep
+	// one get a temporary hierarchy built from a grid of sampled cells
+	static const patch_bvh & get_seed_bvh(surface_ref surface, const intersection_options & options, patch_bvh & fallback) {
+		const auto * bvh = surface.get_bvh();
+		if (bvh && !bvh->empty()) {
+			return *bvh;
+		}
+
+		const glm::vec2 min_param = { surface.get_min_u(), surface.get_min_v() };
+		const glm::vec2 max_param = { surface.get_max_u(), surface.get_max_v() };
+		const glm::vec2 size = { 
+			(max_param.x - min_param.x) / static_cast<float>(options.grid_u),
+			(max_param.y - min_param.y) / static_cast<float>(options.grid_v)
+		};
+
+		std::vector<seed_cell> cells;
+		build_seed_cells(surface, min_param, max_param, options.grid_u, options.grid_v, cells);
+
+		std::vector<patch_bvh::leaf_t> leaves;
+		leaves.reserve(cells.size());
+
+		for (const auto & cell : cells) {
+			patch_bvh::leaf_t leaf;
+			leaf.bounds = cell.bounds;
+			leaf.min_param = cell.center - 0.5f * size;
+			leaf.max_param = cell.center + 0.5f * size;
+			leaves.push_back(leaf);
+		}
+
+		fallback.build(leaves);
+		return fallback;
+	}
+
+	// subdivides overlapping leaves so that the whole surface
+	// is seeded at roughly the requested grid resolution
+	static void build_leaf_cells(
+		surface_ref surface,
+		const intersection_options & options,
+		const patch_bvh & bvh,
+		const std::vector<std::vector<int>> & partners,
+		std::vector<std::vector<seed_cell>> & cells) {
+
+		const auto size_u = surface.get_max_u() - surface.get_min_u();
+		const auto size_v = surface.get_max_v() - surface.get_min_v();
+
+		cells.resize(bvh.get_num_leaves());
+
+		for (int i = 0; i < bvh.get_num_leaves(); ++i) {
+			if (partners[i].empty()) {
+				continue;
+			}
+
+			const auto & leaf = bvh.get_leaf(i);
+			const auto extent = leaf.max_param - leaf.min_param;
+
+			int res_u = std::max(1, static_cast<int>(roundf(options.grid_u * extent.x / size_u)));
+			int res_v = std::max(1, static_cast<int>(roundf(options.grid_v * extent.y / size_v)));
+
+			build_seed_cells(surface, leaf.min_param, leaf.max_param, res_u, res_v, cells[i]);
+		}
+	}
+
+	// pairs every cell with the closest overlapping cell of the other surface,
+	// only cells of patches whose bounds overlap are ever compared
+	static void build_grid_seeds(
+		surface_ref surface1,
+		surface_ref surface2,
+		const intersection_options & options,
+		std::vector<std::pair<glm::vec2, glm::vec2>> & seeds) {
+
+		patch_bvh fallback1, fallback2;
+		const auto & bvh1 = get_seed_bvh(surface1, options, fallback1);
+		const auto & bvh2 = get_seed_bvh(surface2, options, fallback2);
+
+		std::vector<std::pair<int, int>> pairs;
+		bvh1.find_overlaps(bvh2, pairs);
+
+		std::vector<std::vector<int>> partners1(bvh1.get_num_leaves());
+		std::vector<std::vector<int>> partners2(bvh2.get_num_leaves());
+
+		for (const auto & pair : pairs) {
+			partners1[pair.first].push_back(pair.second);
+			partners2[pair.second].push_back(pair.first);
+		}
+
+		std::vector<std::vector<seed_cell>> cells1, cells2;
+		build_leaf_cells(surface1, options, bvh1, partners1, cells1);
+		build_leaf_cells(surface2, options, bvh2, partners2, cells2);
+
+		const auto add_closest = [&seeds](const seed_cell & cell, const std::vector<int> & partners, 
+			const std::vector<std::vector<seed_cell>> & others, bool first) {
+
+			const seed_cell * best = nullptr;
+			float best_dist = 0.0f;
+
+			for (auto partner : partners) {
+				for (const auto & other : others[partner]) {
+					if (!cell.bounds.overlaps(other.bounds)) {
+						continue;
+					}
+
+					auto dist = glm::distance(cell.center_point, other.center_point);
+					if (!best || dist < best_dist) {
+						best = &other;
+						best_dist = dist;
+					}
+				}
+			}
+
+			if (best) {
+				if (first) {
+					seeds.push_back({ cell.center, best->center });
+				} else {
+					seeds.push_back({ best->center, cell.center });
+				}
+			}
+		};
+
+		for (int i = 0; i < bvh1.get_num_leaves(); ++i) {
+			for (const auto & cell : cells1[i]) {
+				add_closest(cell, partners1[i], cells2, true);
+			}
+		}
+
+		for (int i = 0; i < bvh2.get_num_leaves(); ++i) {
+			for (const auto & cell : cells2[i]) {
+				add_closest(cell, partners2[i], cells1, false);
+			}
+		}
+	}
+
+	// runs fn(i) for i in [0, count) on a set of worker threads
+	template<typename F> static void parallel_for(int count, unsigned int num_threads, const F & fn) {
+		if (num_threads == 0) {
+			num_threads = std::max(1U, std::thread::hardware_concurrency());
+		}
+
+		num_threads = std::min(num_threads, static_cast<unsigned int>(std::max(count, 1)));
+
+		std::atomic<int> next(0);
+		const auto worker = [&]() {
+			for (int i = next++; i < count; i = next++) {
+				fn(i);
+			}
+		};
+
+		std::vector<std::thread> threads;
+		threads.reserve(num_threads - 1);
+
+		for (unsigned int i = 1; i < num_threads; ++i) {
+			threads.emplace_back(worker);
+		}
+
+		worker();
+
+		for (auto & thread : threads) {
+			thread.join();
+		}
+	}
+
+	static void add_distinct_start(
+		surface_ref surface1,
+		surface_ref surface2,
+		const intersection_options & options,
+		const glm::vec2 & p1,
+		const glm::vec2 & p2,
+		std::vector<intersection_start> & starts) {
+
+		intersection_start start;
+		start.params1 = p1;
+		start.params2 = p2;
+		start.point1 = surface1.sample(p1.x, p1.y);
+		start.point2 = surface2.sample(p2.x, p2.y);
+
+		for (const auto & other : starts) {
+			if (glm::distance(other.point1, start.point1) < options.tolerance) {
+				return;
+			}
+		}
+
+		starts.push_back(start);
+	}
+
+	static void find_fixed_starts(
+		surface_ref surface1,
+		surface_ref surface2,
+		const intersection_options & options,
+		std::vector<intersection_start> & starts) {
+
+		glm::vec2 p1, p2;
+
+		if (options.use_hint) {
+			glm::vec2 s1, s2;
+
+			start_by_hint(surface1, surface2, options, s1, s2);
+			if (find_starting_points(surface1, surface2, options, p1, p2, s1, s2)) {
+				add_distinct_start(surface1, surface2, options, p1, p2, starts);
+				return;
+			}
+		}
+
+		for (const auto & sp : c_offsets) {
+			if (find_starting_points(surface1, surface2, options, p1, p2, sp, sp)) {
+				add_distinct_start(surface1, surface2, options, p1, p2, starts);
+				return;
+			}
+		}
+	}
+
+	static void find_grid_starts(
+		surface_ref surface1,
+		surface_ref surface2,
+		const intersection_options & options,
+		std::vector<intersection_start> & starts) {
+
+		std::vector<std::pair<glm::vec2, glm::vec2>> seeds;
+
+		if (options.use_hint) {
+			glm::vec2 s1, s2;
+
+			start_by_hint(surface1, surface2, options, s1, s2);
+			seeds.push_back({ s1, s2 });
+		}
+
+		build_grid_seeds(surface1, surface2, options, seeds);
+
+		struct seed_result {
+			bool converged = false;
+			glm::vec2 p1, p2;
+		};
+
+		std::vector<seed_result> results(seeds.size());
+
+		parallel_for(static_cast<int>(seeds.size()), options.num_threads, [&](int i) {
+			auto & result = results[i];
+			result.converged = find_starting_points(surface1, surface2, options,
+				result.p1, result.p2, seeds[i].first, seeds[i].second);
+		});
+
+		// merge in seed order so the output does not depend on scheduling
+		for (const auto & result : results) {
+			if (result.converged) {
+				add_distinct_start(surface1, surface2, options, result.p1, result.p2, starts);
+			}
+		}
+	}
+
+	inline float segment_distance(const glm::vec3 & a, const glm::vec3 & b, const glm::vec3 & p) {
+		const auto ab = b - a;
+		const auto len2 = glm::dot(ab, ab);
+
+		if (len2 < 1e-12f) {
+			return glm::distance(a, p);
+		}
+
+		const auto s = glm::clamp(glm::dot(p - a, ab) / len2, 0.0f, 1.0f);
+		return glm::distance(a + s * ab, p);
+	}
+
+	inline bool lies_on_component(const intersection_component & component, const glm::vec3 & point, float radius) {
+		for (const auto * curve : { &component.forward, &component.backward }) {
+			// the first segment starts at the component start point
+			auto prev = component.start.point1;
+
+			for (const auto & p : curve->points) {
+				if (segment_distance(prev, p, point) < radius) {
+					return true;
+				}
+
+				prev = p;
+			}
+		}
+
+		return false;
+	}
+
+	intersection_result intersect(surface_ref surface1, surface_ref surface2, const intersection_options & options) {
+		intersection_result result;
+
+		if (options.seeding == intersection_seeding::grid) {
+			find_grid_starts(surface1, surface2, options, result.starts);
+		} else {
+			find_fixed_starts(surface1, surface2, options, result.starts);
+		}
+
+		// every start point that is not already covered by a traced
+		// curve belongs to another component of the intersection
+		const auto radius = 2.0f * options.tolerance;
+
+		for (const auto & start : result.starts) {
+			bool covered = false;
+
+			for (const auto & component : result.components) {
+				if (lies_on_component(component, start.point1, radius)) {
+					covered = true;
+					break;
+				}
+			}
+
+			if (covered) {
+				continue;
+			}
+
+			intersection_component component;
+			component.start = start;
+
+			component.closed = trace_intersection(surface1, surface2, options, 
+				start.params1, start.params2, +1.0f, component.forward);
+
+			if (!component.closed) {
+				trace_intersection(surface1, surface2, options, 
+					start.params1, start.params2, -1.0f, component.backward);
+			}
+
+			result.components.push_back(std::move(component));
+		}
+
+		result.found = !result.components.empty();
+		return result;
+	}
+}
@@ -0,0 +1,453 @@
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+
+#include "journal.hpp"
+#include "binscene.hpp"
+#include "object.hpp"
+#include "point.hpp"
+
+namespace mini {
+	// a shorter journal is cheaper to replay than to rewrite the base
+	constexpr std::size_t journal_min_records = 4096;
+	constexpr int journal_version = 1;
+
+	using json = nlohmann::json;
+
+	static json serialize_point(int id, const scene_obj_t & point) {
+		const auto & position = point.get_translation();
+		json data;
+
+		data["id"] = id;
+		data["name"] = point.get_name();
+		data["position"] = { { "x", position.x }, { "y", position.y }, { "z", position.z } };
+
+		return data;
+	}
+
+	static void upsert_record(json & table, std::unordered_map<int, std::size_t> & index, json && data) {
+		const int id = data.at("id").get<int>();
+		auto iter = index.find(id);
+
+		if (iter != index.end()) {
+			table[iter->second] = std::move(data);
+		} else {
+			index[id] = table.size();
+			table.push_back(std::move(data));
+		}
+	}
+
+	static bool erase_record(json & table, std::unordered_map<int, std::size_t> & index, int id) {
+		auto iter = index.find(id);
+		if (iter == index.end()) {
+			return false;
+		}
+
+		// holes are dropped once the whole journal is replayed
+		table[iter->second] = nullptr;
+		index.erase(iter);
+		return true;
+	}
+
+	static void drop_erased(json & table) {
+		auto & values = table.get_ref<json::array_t &>();
+		values.erase(std::remove_if(values.begin(), values.end(), [](const json & value) {
+			return value.is_null();
+		}), values.end());
+	}
+
+	scene_journal::scene_journal(const std::string & directory) {
+		m_directory = directory;
+		m_enabled = true;
+		m_generation = 0;
+		m_pending_generation = 0;
+		m_num_records = 0;
+		m_num_base_objects = 0;
+		m_compacting = false;
+
+		std::error_code error;
+		std::filesystem::create_directories(m_directory, error);
+
+		if (error) {
+			std::cerr << "autosave disabled, cannot create " << m_directory << ": " << error.message() << std::endl;
+			m_enabled = false;
+			return;
+		}
+
+		// the journal of a session that did not exit cleanly is kept for recovery
+		if (std::filesystem::exists(m_get_journal_path(), error)) {
+			std::filesystem::rename(m_get_journal_path(), m_get_recovery_path(), error);
+		}
+
+		m_pending_generation = m_read_generation(m_get_recovery_path());
+		m_remove_stale_bases();
+	}
+
+	scene_journal::~scene_journal() {
+		m_saver.wait();
+
+		if (m_enabled) {
+			// a clean exit leaves nothing to recover
+			std::remove(m_get_journal_path().c_str());
+
+			m_generation = 0;
+			m_remove_stale_bases();
+		}
+	}
+
+	bool scene_journal::is_enabled() const {
+		return m_enabled;
+	}
+
+	bool scene_journal::is_compacting() const {
+		return m_compacting;
+	}
+
+	bool scene_journal::needs_compaction() const {
+		return m_enabled && !m_compacting &&
+			(m_generation == 0 || m_num_records > std::max(journal_min_records, m_num_base_objects / 2));
+	}
+
+	void scene_journal::object_changed(const scene_obj_t & object) {
+		if (object.get_id() != 0UL) {
+			m_dirty.insert(object.get_id());
+		}
+	}
+
+	void scene_journal::object_deleted(const scene_obj_t & object) {
+		m_dirty.erase(object.get_id());
+
+		// objects that never reached the file need no record
+		if (m_cache.has(object.get_id())) {
+			m_deleted.push_back(m_cache.get(object.get_id()));
+		}
+	}
+
+	void scene_journal::flush(scene_controller_base & scene) {
+		if (!m_enabled || m_compacting || m_generation == 0) {
+			return;
+		}
+
+		if (m_dirty.empty() && m_deleted.empty()) {
+			return;
+		}
+
+		std::vector<std::shared_ptr<scene_obj_t>> geometry;
+		std::string records;
+		std::size_t num_records = 0;
+
+		const auto get_file_id = [this](const scene_obj_t & object) {
+			return m_cache.has(object.get_id()) ? m_cache.get(object.get_id()) : m_cache.add(object.get_id());
+		};
+
+		// points first so that new geometry finds the ids of its new points
+		for (const auto id : m_dirty) {
+			auto object = scene.get_object(id);
+			if (!object) {
+				continue;
+			}
+
+			if (std::dynamic_pointer_cast<point_object>(object) == nullptr) {
+				geometry.push_back(object);
+				continue;
+			}
+
+			json record;
+			record["point"] = serialize_point(get_file_id(*object), *object);
+
+			records += record.dump();
+			records += '\n';
+			num_records++;
+		}
+
+		for (const auto & object : geometry) {
+			json record;
+
+			try {
+				record["object"] = object->get_serializer().serialize(get_file_id(*object), object, m_cache);
+			} catch (const std::exception & error) {
+				std::cerr << "autosave skipped " << object->get_name() << ": " << error.what() << std::endl;
+				continue;
+			}
+
+			records += record.dump();
+			records += '\n';
+			num_records++;
+		}
+
+		for (const auto id : m_deleted) {
+			json record;
+			record["delete"] = id;
+
+			records += record.dump();
+			records += '\n';
+			num_records++;
+		}
+
+		m_dirty.clear();
+		m_deleted.clear();
+
+		if (m_append(records)) {
+			m_num_records += num_records;
+		}
+	}
+
+	void scene_journal::compact(const object_list_t & objects) {
+		if (!m_enabled) {
+			return;
+		}
+
+		scene_serializer serializer;
+		for (const auto & object : objects) {
+			serializer.add_object(object);
+		}
+
+		auto snapshot = std::make_shared<const scene_snapshot>(serializer.get_snapshot());
+
+		// from here on changes are relative to the new base, they are held back
+		// until it is written and the journal that names it is in place
+		m_cache = serializer.take_cache();
+		m_dirty.clear();
+		m_deleted.clear();
+		m_num_base_objects = snapshot->get_num_objects();
+
+		m_compacting = true;
+		m_pending_generation++;
+		m_saver.save(snapshot, m_get_base_path(m_pending_generation), true);
+	}
+
+	void scene_journal::poll() {
+		if (!m_compacting) {
+			return;
+		}
+
+		std::string error;
+		if (!m_saver.poll(error)) {
+			m_compact_error = error;
+		}
+
+		if (!m_saver.is_saving()) {
+			m_finish_compaction();
+		}
+	}
+
+	bool scene_journal::has_recovery() const {
+		return m_read_generation(m_get_recovery_path()) != 0;
+	}
+
+	json scene_journal::recover() const {
+		std::ifstream stream(m_get_recovery_path(), std::ios::binary);
+		if (!stream) {
+			throw std::runtime_error("no autosave to recover");
+		}
+
+		const uint64_t generation = m_read_generation(m_get_recovery_path());
+		if (generation == 0) {
+			throw std::runtime_error("malformed autosave journal " + m_get_recovery_path());
+		}
+
+		json scene;
+		{
+			binary_scene_reader reader;
+			reader.open(m_get_base_path(generation));
+			scene = reader.to_json();
+		}
+
+		auto & points = scene["points"];
+		auto & geometry = scene["geometry"];
+
+		if (!points.is_array()) {
+			points = json::array();
+		}
+
+		if (!geometry.is_array()) {
+			geometry = json::array();
+		}
+
+		std::unordered_map<int, std::size_t> point_index, geometry_index;
+		point_index.reserve(points.size());
+		geometry_index.reserve(geometry.size());
+
+		for (std::size_t i = 0; i < points.size(); ++i) {
+			point_index[points[i].at("id").get<int>()] = i;
+		}
+
+		for (std::size_t i = 0; i < geometry.size(); ++i) {
+			geometry_index[geometry[i].at("id").get<int>()] = i;
+		}
+
+		std::string line;
+
+		// the header was already read
+		std::getline(stream, line);
+
+		while (std::getline(stream, line)) {
+			if (line.empty()) {
+				continue;
+			}
+
+			json record = json::parse(line, nullptr, false);
+
+			// the last record may have been cut short by the crash
+			if (record.is_discarded()) {
+				break;
+			}
+
+			if (record.contains("point")) {
+				upsert_record(points, point_index, std::move(record["point"]));
+			} else if (record.contains("object")) {
+				upsert_record(geometry, geometry_index, std::move(record["object"]));
+			} else if (record.contains("delete")) {
+				const int id = record["delete"].get<int>();
+
+				if (!erase_record(points, point_index, id)) {
+					erase_record(geometry, geometry_index, id);
+				}
+			}
+		}
+
+		drop_erased(points);
+		drop_erased(geometry);
+
+		return scene;
+	}
+
+	void scene_journal::discard_recovery() {
+		const uint64_t generation = m_read_generation(m_get_recovery_path());
+
+		std::remove(m_get_recovery_path().c_str());
+
+		if (generation != 0 && generation != m_generation) {
+			std::remove(m_get_base_path(generation).c_str());
+		}
+	}
+
+	std::string scene_journal::m_get_journal_path() const {
+		return (std::filesystem::path(m_directory) / "journal.log").string();
+	}
+
+	std::string scene_journal::m_get_recovery_path() const {
+		return (std::filesystem::path(m_directory) / "recovery.log").string();
+	}
+
+	std::string scene_journal::m_get_base_path(uint64_t generation) const {
+		return (std::filesystem::path(m_directory) / ("base." + std::to_string(generation) + ".mgsb")).string();
+	}
+
+	uint64_t scene_journal::m_read_generation(const std::string & path) const {
+		std::ifstream stream(path, std::ios::binary);
+		std::string line;
+
+		if (!stream || !std::getline(stream, line)) {
+			return 0;
+		}
+
+		const json header = json::parse(line, nullptr, false);
+
+		if (header.is_discarded() || !header.is_object() ||
+			header.value("journal", 0) != journal_version || !header.contains("base") || !header["base"].is_number_unsigned()) {
+			return 0;
+		}
+
+		return header["base"].get<uint64_t>();
+	}
+
+	bool scene_journal::m_append(const std::string & records) {
+		std::ofstream stream(m_get_journal_path(), std::ios::binary | std::ios::app);
+
+		if (stream) {
+			stream.write(records.data(), records.size());
+			stream.flush();
+		}
+
+		if (!stream) {
+			std::cerr << "autosave disabled, failed to write " << m_get_journal_path() << std::endl;
+			m_enabled = false;
+			return false;
+		}
+
+		return true;
+	}
+
+	void scene_journal::m_finish_compaction() {
+		m_compacting = false;
+
+		if (!m_compact_error.empty()) {
+			std::cerr << "autosave disabled, failed to write base: " << m_compact_error << std::endl;
+			m_compact_error.clear();
+			m_enabled = false;
+			return;
+		}
+
+		const uint64_t generation = m_pending_generation;
+		const std::string journal_path = m_get_journal_path();
+		const std::string temp_path = journal_path + ".tmp";
+
+		// the old journal and base stay valid until the rename
+		{
+			json header;
+			header["journal"] = journal_version;
+			header["base"] = generation;
+
+			std::ofstream stream(temp_path, std::ios::binary | std::ios::trunc);
+			stream << header.dump() << '\n';
+			stream.flush();
+
+			if (!stream) {
+				stream.close();
+				std::remove(temp_path.c_str());
+
+				std::cerr << "autosave disabled, failed to write " << temp_path << std::endl;
+				m_enabled = false;
+				return;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temp_path, journal_path, error);
+
+		if (error) {
+			std::remove(temp_path.c_str());
+
+			std::cerr << "autosave disabled, failed to replace " << journal_path << ": " << error.message() << std::endl;
+			m_enabled = false;
+			return;
+		}
+
+		m_generation = generation;
+		m_num_records = 0;
+
+		m_remove_stale_bases();
+	}
+
+	void scene_journal::m_remove_stale_bases() const {
+		const uint64_t recovery_generation = m_read_generation(m_get_recovery_path());
+		std::vector<std::filesystem::path> stale;
+		std::error_code error;
+
+		for (const auto & entry : std::filesystem::directory_iterator(m_directory, error)) {
+			const std::string name = entry.path().filename().string();
+
+			if (name.rfind("base.", 0) != 0) {
+				continue;
+			}
+
+			// temporary files of either generation go as well
+			const uint64_t generation = std::strtoull(name.c_str() + 5, nullptr, 10);
+			const bool kept = (generation == m_generation || generation == recovery_generation) &&
+				name == std::filesystem::path(m_get_base_path(generation)).filename().string();
+
+			if (generation == 0 || !kept) {
+				stale.push_back(entry.path());
+			}
+		}
+
+		for (const auto & path : stale) {
+			std::filesystem::remove(path, error);
+		}
+	}
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "gui.hpp"
 #include "object.hpp"
 
@@ -26,6 +28,162 @@ namespace mini {
 
 	scene_controller_base::scene_controller_base () {
 		m_next_id = 100UL;
+		m_transaction_depth = 0;
+	}
+
+	void scene_controller_base::subscribe (scene_event_t event, std::shared_ptr<scene_obj_t> subscriber) {
+		m_subscribers[static_cast<int> (event)].insert ({ subscriber.get (), subscriber });
+	}
+
+	void scene_controller_base::unsubscribe (scene_event_t event, const scene_obj_t & subscriber) {
+		m_subscribers[static_cast<int> (event)].erase (&subscriber);
+	}
+
+	void scene_controller_base::begin_transaction () {
+		m_transaction_depth++;
+	}
+
+	void scene_controller_base::commit_transaction () {
+		if (m_transaction_depth == 0) {
+			throw std::runtime_error ("commit without a matching begin_transaction");
+		}
+
+		if (--m_transaction_depth == 0) {
+			m_flush_transaction ();
+		}
+	}
+
+	void scene_controller_base::t_object_created (std::shared_ptr<scene_obj_t> object) {
+		m_created_pending.insert (object.get ());
+		m_created_batch.push_back (object);
+
+		if (m_transaction_depth == 0) {
+			m_flush_transaction ();
+		}
+	}
+
+	void scene_controller_base::t_object_deleted (std::shared_ptr<scene_obj_t> object) {
+		// a deleted object no longer receives anything
+		for (auto & subscribers : m_subscribers) {
+			subscribers.erase (object.get ());
+		}
+
+		// created and deleted in the same transaction, nobody has to know
+		if (m_created_pending.erase (object.get ()) > 0) {
+			auto iter = std::find (m_created_batch.begin (), m_created_batch.end (), object);
+			if (iter != m_created_batch.end ()) {
+				iter->reset ();
+			}
+		} else {
+			m_deleted_batch.push_back (object);
+		}
+
+		if (m_transaction_depth == 0) {
+			m_flush_transaction ();
+		}
+	}
+
+	void scene_controller_base::m_queue_signal (scene_obj_t & emitter, int signal) {
+		auto weak_emitter = emitter.weak_from_this ();
+
+		// not owned by a shared pointer yet, nothing can be queued for later
+		if (weak_emitter.expired ()) {
+			emitter.m_deliver (static_cast<scene_obj_t::signal_event_t> (signal));
+			return;
+		}
+
+		const uint32_t bit = 1U << signal;
+		auto iter = m_signal_index.find (&emitter);
+
+		// the address of a destroyed emitter may have been reused by a new object
+		if (iter != m_signal_index.end () && !m_signal_queue[iter->second].emitter.expired ()) {
+			m_signal_queue[iter->second].signals |= bit;
+			return;
+		}
+
+		m_signal_index[&emitter] = m_signal_queue.size ();
+		m_signal_queue.push_back ({ weak_emitter, bit });
+	}
+
+	void scene_controller_base::t_dispatch_signals () {
+		constexpr int max_rounds = 8;
+		constexpr int num_signals = static_cast<int> (scene_obj_t::signal_event_t::MAX);
+
+		std::vector<queued_signals_t> queue;
+
+		for (int round = 0; round < max_rounds && !m_signal_queue.empty (); ++round) {
+			queue.swap (m_signal_queue);
+			m_signal_queue.clear ();
+			m_signal_index.clear ();
+
+			for (const auto & entry : queue) {
+				auto emitter = entry.emitter.lock ();
+				if (!emitter) {
+					continue;
+				}
+
+				for (int signal = 0; signal < num_signals; ++signal) {
+					if (entry.signals & (1U << signal)) {
+						emitter->m_deliver (static_cast<scene_obj_t::signal_event_t> (signal));
+					}
+				}
+			}
+
+			queue.clear ();
+		}
+	}
+
+	void scene_controller_base::t_clear_subscriptions () {
+		for (auto & subscribers : m_subscribers) {
+			subscribers.clear ();
+		}
+
+		m_created_batch.clear ();
+		m_deleted_batch.clear ();
+		m_created_pending.clear ();
+	}
+
+	scene_controller_base::object_batch_t scene_controller_base::m_lock_subscribers (scene_event_t event) {
+		auto & subscribers = m_subscribers[static_cast<int> (event)];
+		object_batch_t locked;
+
+		locked.reserve (subscribers.size ());
+
+		for (auto iter = subscribers.begin (); iter != subscribers.end (); ) {
+			auto subscriber = iter->second.lock ();
+
+			if (subscriber) {
+				locked.push_back (subscriber);
+				iter++;
+			} else {
+				iter = subscribers.erase (iter);
+			}
+		}
+
+		return locked;
+	}
+
+	void scene_controller_base::m_flush_transaction () {
+		// handlers are free to create or delete objects, so take the batches out first
+		object_batch_t created, deleted;
+
+		created.swap (m_created_batch);
+		deleted.swap (m_deleted_batch);
+		m_created_pending.clear ();
+
+		created.erase (std::remove (created.begin (), created.end (), nullptr), created.end ());
+
+		if (!deleted.empty ()) {
+			for (auto & subscriber : m_lock_subscribers (scene_event_t::deleted)) {
+				subscriber->notify_objects_deleted (deleted);
+			}
+		}
+
+		if (!created.empty ()) {
+			for (auto & subscriber : m_lock_subscribers (scene_event_t::created)) {
+				subscriber->notify_objects_created (created);
+			}
+		}
 	}
 
 
@@ -124,17 +282,41 @@ namespace mini {
 	}
 
 	void scene_obj_t::m_notify (signal_event_t sig) {
-		auto & set = m_listeners[static_cast<int>(sig)];
-		for (auto iter = set.begin (); iter != set.end (); ) {
-			auto listener = iter->lock();
+		if (sig == signal_event_t::moved) {
+			m_scene.t_on_object_moved (*this);
+		}
+
+		if (sig != signal_event_t::selected) {
+			m_scene.t_on_object_changed (*this);
+		}
+
+		if (m_listeners[static_cast<int>(sig)].empty ()) {
+			return;
+		}
+
+		m_scene.m_queue_signal (*this, static_cast<int>(sig));
+	}
+
+	void scene_obj_t::m_deliver (signal_event_t sig) {
+		auto & listeners = m_listeners[static_cast<int>(sig)];
+		bool expired = false;
+
+		// handlers may start listening to this object, so index instead of iterating
+		for (std::size_t i = 0; i < listeners.size (); ++i) {
+			auto listener = listeners[i].lock ();
 
 			if (listener) {
 				listener->m_receive (sig, *this);
-				iter++;
 			} else {
-				iter = set.erase (iter);
+				expired = true;
 			}
 		}
+
+		if (expired) {
+			listeners.erase (std::remove_if (listeners.begin (), listeners.end (), [] (const std::weak_ptr<scene_obj_t> & listener) {
+				return listener.expired ();
+			}), listeners.end ());
+		}
 	}
 
 	void scene_obj_t::m_receive (signal_event_t sig, scene_obj_t & emitter) {
@@ -161,6 +343,26 @@ namespace mini {
 		t_on_object_deleted (object);
 	}
 
+	void scene_obj_t::notify_objects_created (const scene_controller_base::object_batch_t & objects) {
+		t_on_objects_created (objects);
+	}
+
+	void scene_obj_t::notify_objects_deleted (const scene_controller_base::object_batch_t & objects) {
+		t_on_objects_deleted (objects);
+	}
+
+	void scene_obj_t::t_on_objects_created (const scene_controller_base::object_batch_t & objects) {
+		for (const auto & object : objects) {
+			t_on_object_created (object);
+		}
+	}
+
+	void scene_obj_t::t_on_objects_deleted (const scene_controller_base::object_batch_t & objects) {
+		for (const auto & object : objects) {
+			t_on_object_deleted (object);
+		}
+	}
+
 	const std::string & scene_obj_t::get_type_name () const {
 		return m_type_name;
 	}
@@ -222,6 +424,7 @@ namespace mini {
 		m_translation = translation;
 		
 		if (old_translation != translation) {
+			t_on_translation (translation);
 			m_notify (signal_event_t::moved);
 		}
 	}
@@ -337,6 +540,18 @@ namespace mini {
 		return false;
 	}
 
+	bool scene_obj_t::get_pick_point (glm::vec3 & point) const {
+		return false;
+	}
+
+	uint32_t scene_obj_t::get_pick_id () const {
+		return static_cast<uint32_t> (get_id ());
+	}
+
+	const std::string & scene_obj_t::get_debug_name () const {
+		return m_name;
+	}
+
 	bool scene_obj_t::box_test (const box_test_data_t & data) const {
 		return false;
 	}
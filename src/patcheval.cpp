@@ -0,0 +1,272 @@
+#include "patcheval.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINI_PATCHEVAL_SSE
+#include <emmintrin.h>
+#endif
+
+namespace mini {
+	// position of a global parameter within the patch grid
+	inline unsigned int locate_patch(unsigned int patches, float t, float & local) {
+		float n = static_cast<float>(patches) * glm::clamp(t, 0.0f, 1.0f);
+		unsigned int patch = glm::min(static_cast<unsigned int>(floorf(n)), patches - 1);
+
+		local = n - static_cast<float>(patch);
+		return patch;
+	}
+
+	// cubic basis functions and their derivatives at t
+	inline void basis_weights(bicubic_basis basis, float t, float b[4], float d[4]) {
+		float s = 1.0f - t;
+
+		if (basis == bicubic_basis::bezier) {
+			b[0] = s * s * s;
+			b[1] = 3.0f * t * s * s;
+			b[2] = 3.0f * t * t * s;
+			b[3] = t * t * t;
+
+			d[0] = -3.0f * s * s;
+			d[1] = 3.0f * s * s - 6.0f * t * s;
+			d[2] = 6.0f * t * s - 3.0f * t * t;
+			d[3] = 3.0f * t * t;
+		} else {
+			b[0] = s * s * s / 6.0f;
+			b[1] = (3.0f * t * t * t - 6.0f * t * t + 4.0f) / 6.0f;
+			b[2] = (-3.0f * t * t * t + 3.0f * t * t + 3.0f * t + 1.0f) / 6.0f;
+			b[3] = t * t * t / 6.0f;
+
+			d[0] = -s * s / 2.0f;
+			d[1] = (3.0f * t * t - 4.0f * t) / 2.0f;
+			d[2] = (-3.0f * t * t + 2.0f * t + 1.0f) / 2.0f;
+			d[3] = t * t / 2.0f;
+		}
+	}
+
+	static void evaluate_scalar(
+		bicubic_basis basis,
+		const glm::vec3 * cp,
+		float lu,
+		float lv,
+		float scale_u,
+		float scale_v,
+		std::size_t i,
+		surface_samples & out) {
+
+		float bu[4], du[4], bv[4], dv[4];
+		basis_weights(basis, lu, bu, du);
+		basis_weights(basis, lv, bv, dv);
+
+		glm::vec3 p = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 pu = p, pv = p;
+
+		// contract rows along u first, then combine rows along v
+		for (int y = 0; y < 4; ++y) {
+			glm::vec3 row = { 0.0f, 0.0f, 0.0f };
+			glm::vec3 row_du = row;
+
+			for (int x = 0; x < 4; ++x) {
+				const auto & c = cp[4 * y + x];
+				row = row + bu[x] * c;
+				row_du = row_du + du[x] * c;
+			}
+
+			p = p + bv[y] * row;
+			pu = pu + bv[y] * row_du;
+			pv = pv + dv[y] * row;
+		}
+
+		pu = scale_u * pu;
+		pv = scale_v * pv;
+
+		out.set(i, p, pu, pv, glm::normalize(glm::cross(pu, pv)));
+	}
+
+#ifdef MINI_PATCHEVAL_SSE
+	inline __m128 madd(__m128 acc, __m128 a, __m128 b) {
+		return _mm_add_ps(acc, _mm_mul_ps(a, b));
+	}
+
+	inline void basis_weights(bicubic_basis basis, __m128 t, __m128 b[4], __m128 d[4]) {
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 s = _mm_sub_ps(one, t);
+		const __m128 t2 = _mm_mul_ps(t, t);
+		const __m128 s2 = _mm_mul_ps(s, s);
+		const __m128 ts = _mm_mul_ps(t, s);
+
+		if (basis == bicubic_basis::bezier) {
+			const __m128 c3 = _mm_set1_ps(3.0f);
+			const __m128 c6 = _mm_set1_ps(6.0f);
+
+			b[0] = _mm_mul_ps(s2, s);
+			b[1] = _mm_mul_ps(c3, _mm_mul_ps(ts, s));
+			b[2] = _mm_mul_ps(c3, _mm_mul_ps(ts, t));
+			b[3] = _mm_mul_ps(t2, t);
+
+			d[0] = _mm_mul_ps(_mm_set1_ps(-3.0f), s2);
+			d[1] = _mm_sub_ps(_mm_mul_ps(c3, s2), _mm_mul_ps(c6, ts));
+			d[2] = _mm_sub_ps(_mm_mul_ps(c6, ts), _mm_mul_ps(c3, t2));
+			d[3] = _mm_mul_ps(c3, t2);
+		} else {
+			const __m128 sixth = _mm_set1_ps(1.0f / 6.0f);
+			const __m128 half = _mm_set1_ps(0.5f);
+			const __m128 c2 = _mm_set1_ps(2.0f);
+			const __m128 c3 = _mm_set1_ps(3.0f);
+			const __m128 c4 = _mm_set1_ps(4.0f);
+			const __m128 c6 = _mm_set1_ps(6.0f);
+			const __m128 t3 = _mm_mul_ps(t2, t);
+
+			// (3t^3 - 6t^2 + 4) / 6 and (-3t^3 + 3t^2 + 3t + 1) / 6
+			b[0] = _mm_mul_ps(_mm_mul_ps(s2, s), sixth);
+			b[1] = _mm_mul_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(c3, t3), _mm_mul_ps(c6, t2)), c4), sixth);
+			b[2] = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(c3, _mm_add_ps(_mm_sub_ps(t2, t3), t)), one), sixth);
+			b[3] = _mm_mul_ps(t3, sixth);
+
+			// -(1 - t)^2 / 2, (3t^2 - 4t) / 2, (-3t^2 + 2t + 1) / 2, t^2 / 2
+			d[0] = _mm_mul_ps(_mm_set1_ps(-0.5f), s2);
+			d[1] = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(c3, t2), _mm_mul_ps(c4, t)), half);
+			d[2] = _mm_mul_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(c2, t), _mm_mul_ps(c3, t2)), one), half);
+			d[3] = _mm_mul_ps(t2, half);
+		}
+	}
+
+	// evaluates four parameters lying on the same patch, one per lane
+	static void evaluate_sse(
+		bicubic_basis basis,
+		const glm::vec3 * cp,
+		const float * lu,
+		const float * lv,
+		float scale_u,
+		float scale_v,
+		std::size_t i,
+		surface_samples & out) {
+
+		__m128 bu[4], du[4], bv[4], dv[4];
+		basis_weights(basis, _mm_loadu_ps(lu), bu, du);
+		basis_weights(basis, _mm_loadu_ps(lv), bv, dv);
+
+		__m128 px = _mm_setzero_ps(), py = px, pz = px;
+		__m128 ux = px, uy = px, uz = px;
+		__m128 vx = px, vy = px, vz = px;
+
+		for (int y = 0; y < 4; ++y) {
+			__m128 rx = _mm_setzero_ps(), ry = rx, rz = rx;
+			__m128 rux = rx, ruy = rx, ruz = rx;
+
+			for (int x = 0; x < 4; ++x) {
+				const auto & c = cp[4 * y + x];
+				const __m128 cx = _mm_set1_ps(c.x);
+				const __m128 cy = _mm_set1_ps(c.y);
+				const __m128 cz = _mm_set1_ps(c.z);
+
+				rx = madd(rx, bu[x], cx);
+				ry = madd(ry, bu[x], cy);
+				rz = madd(rz, bu[x], cz);
+
+				rux = madd(rux, du[x], cx);
+				ruy = madd(ruy, du[x], cy);
+				ruz = madd(ruz, du[x], cz);
+			}
+
+			px = madd(px, bv[y], rx);
+			py = madd(py, bv[y], ry);
+			pz = madd(pz, bv[y], rz);
+
+			ux = madd(ux, bv[y], rux);
+			uy = madd(uy, bv[y], ruy);
+			uz = madd(uz, bv[y], ruz);
+
+			vx = madd(vx, dv[y], rx);
+			vy = madd(vy, dv[y], ry);
+			vz = madd(vz, dv[y], rz);
+		}
+
+		const __m128 su = _mm_set1_ps(scale_u);
+		const __m128 sv = _mm_set1_ps(scale_v);
+
+		ux = _mm_mul_ps(ux, su);
+		uy = _mm_mul_ps(uy, su);
+		uz = _mm_mul_ps(uz, su);
+
+		vx = _mm_mul_ps(vx, sv);
+		vy = _mm_mul_ps(vy, sv);
+		vz = _mm_mul_ps(vz, sv);
+
+		// normalized cross product of the partials
+		__m128 nx = _mm_sub_ps(_mm_mul_ps(uy, vz), _mm_mul_ps(uz, vy));
+		__m128 ny = _mm_sub_ps(_mm_mul_ps(uz, vx), _mm_mul_ps(ux, vz));
+		__m128 nz = _mm_sub_ps(_mm_mul_ps(ux, vy), _mm_mul_ps(uy, vx));
+
+		const __m128 len = _mm_sqrt_ps(madd(madd(_mm_mul_ps(nx, nx), ny, ny), nz, nz));
+		nx = _mm_div_ps(nx, len);
+		ny = _mm_div_ps(ny, len);
+		nz = _mm_div_ps(nz, len);
+
+		_mm_storeu_ps(&out.x[i], px);
+		_mm_storeu_ps(&out.y[i], py);
+		_mm_storeu_ps(&out.z[i], pz);
+
+		_mm_storeu_ps(&out.du_x[i], ux);
+		_mm_storeu_ps(&out.du_y[i], uy);
+		_mm_storeu_ps(&out.du_z[i], uz);
+
+		_mm_storeu_ps(&out.dv_x[i], vx);
+		_mm_storeu_ps(&out.dv_y[i], vy);
+		_mm_storeu_ps(&out.dv_z[i], vz);
+
+		_mm_storeu_ps(&out.n_x[i], nx);
+		_mm_storeu_ps(&out.n_y[i], ny);
+		_mm_storeu_ps(&out.n_z[i], nz);
+	}
+#endif
+
+	void evaluate_bicubic_patches(
+		bicubic_basis basis,
+		unsigned int patches_x,
+		unsigned int patches_y,
+		const glm::vec3 * net,
+		const float * u,
+		const float * v,
+		std::size_t count,
+		surface_samples & out) {
+
+		out.resize(count);
+
+		// chain rule, the patch parameter grows faster than the global one
+		const float scale_u = static_cast<float>(patches_x);
+		const float scale_v = static_cast<float>(patches_y);
+
+		std::size_t i = 0;
+
+#ifdef MINI_PATCHEVAL_SSE
+		// runs of four parameters on the same patch go through the vector
+		// kernel, which is the common case for grids denser than the net
+		while (i + 4 <= count) {
+			float lu[4], lv[4];
+			unsigned int patch[4];
+
+			for (int k = 0; k < 4; ++k) {
+				unsigned int x = locate_patch(patches_x, u[i + k], lu[k]);
+				unsigned int y = locate_patch(patches_y, v[i + k], lv[k]);
+
+				patch[k] = y * patches_x + x;
+			}
+
+			if (patch[0] == patch[1] && patch[0] == patch[2] && patch[0] == patch[3]) {
+				evaluate_sse(basis, net + 16 * patch[0], lu, lv, scale_u, scale_v, i, out);
+				i += 4;
+			} else {
+				evaluate_scalar(basis, net + 16 * patch[0], lu[0], lv[0], scale_u, scale_v, i, out);
+				i += 1;
+			}
+		}
+#endif
+
+		for (; i < count; ++i) {
+			float lu, lv;
+			unsigned int x = locate_patch(patches_x, u[i], lu);
+			unsigned int y = locate_patch(patches_y, v[i], lv);
+
+			evaluate_scalar(basis, net + 16 * (y * patches_x + x), lu, lv, scale_u, scale_v, i, out);
+		}
+	}
+}
\ No newline at end of file
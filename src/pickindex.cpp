@@ -0,0 +1,478 @@
+#include <array>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <functional>
+
+#include "pickindex.hpp"
+
+namespace mini {
+	// cell coordinates are packed into 21 bits each
+	constexpr int64_t pick_cell_bias = 1 << 20;
+	constexpr uint64_t pick_cell_mask = (1ull << 21) - 1;
+
+	// the cell size aims for this many points per occupied cell, below the
+	// minimum count the initial cell size is kept
+	constexpr float pick_points_per_cell = 4.0f;
+	constexpr std::size_t pick_rebuild_min = 64;
+
+	static uint64_t pack_cell(const glm::ivec3 & coords) {
+		uint64_t key = 0;
+		for (int i = 0; i < 3; ++i) {
+			key |= (static_cast<uint64_t>(coords[i] + pick_cell_bias) & pick_cell_mask) << (21 * i);
+		}
+
+		return key;
+	}
+
+	static glm::ivec3 unpack_cell(uint64_t key) {
+		glm::ivec3 coords;
+		for (int i = 0; i < 3; ++i) {
+			coords[i] = static_cast<int32_t>(static_cast<int64_t>((key >> (21 * i)) & pick_cell_mask) - pick_cell_bias);
+		}
+
+		return coords;
+	}
+
+	// edge of a cube that holds the wanted number of points on average, flat
+	// and linear point sets only spread over their largest axes, zero if all
+	// points are in one place
+	static float derive_cell_size(const aabb_t & bounds, std::size_t count) {
+		glm::vec3 extent = bounds.max - bounds.min;
+		std::sort(&extent[0], &extent[0] + 3, std::greater<float>());
+
+		const float cells = std::max(static_cast<float>(count) / pick_points_per_cell, 1.0f);
+
+		for (int axes = 3; axes >= 1; --axes) {
+			float volume = 1.0f;
+			for (int i = 0; i < axes; ++i) {
+				volume *= extent[i];
+			}
+
+			const float size = std::pow(volume / cells, 1.0f / static_cast<float>(axes));
+			if (extent[axes - 1] > 0.0f && extent[axes - 1] >= size) {
+				return size;
+			}
+		}
+
+		return 0.0f;
+	}
+
+	static glm::vec4 matrix_row(const glm::mat4x4 & matrix, int row) {
+		return { matrix[0][row], matrix[1][row], matrix[2][row], matrix[3][row] };
+	}
+
+	static bool box_outside_plane(const aabb_t & box, const glm::vec4 & plane) {
+		// the box corner furthest along the plane normal
+		const glm::vec3 corner = {
+			plane.x >= 0.0f ? box.max.x : box.min.x,
+			plane.y >= 0.0f ? box.max.y : box.min.y,
+			plane.z >= 0.0f ? box.max.z : box.min.z
+		};
+
+		return glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f;
+	}
+
+	static glm::vec2 project_to_screen(const glm::mat4x4 & view_projection, const glm::vec2 & screen_res,
+		const glm::vec3 & position, bool & visible) {
+
+		const glm::vec4 clip = view_projection * glm::vec4(position, 1.0f);
+		visible = clip.w > 0.0f;
+
+		const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+		return {
+			((ndc.x + 1.0f) / 2.0f) * screen_res.x,
+			((ndc.y + 1.0f) / 2.0f) * screen_res.y
+		};
+	}
+
+	pick_index::pick_index(float cell_size) {
+		m_cell_size = cell_size;
+		m_rebuild_size = 0;
+		m_cell_min = glm::ivec3(std::numeric_limits<int32_t>::max());
+		m_cell_max = glm::ivec3(std::numeric_limits<int32_t>::min());
+	}
+
+	std::size_t pick_index::size() const {
+		return m_entries.size();
+	}
+
+	bool pick_index::contains(uint64_t id) const {
+		return m_entry_index.find(id) != m_entry_index.end();
+	}
+
+	void pick_index::insert(uint64_t id, const glm::vec3 & position) {
+		if (contains(id)) {
+			update(id, position);
+			return;
+		}
+
+		const uint32_t entry = static_cast<uint32_t>(m_entries.size());
+
+		m_entries.push_back({ id, position, m_get_cell(position), 0 });
+		m_entry_index[id] = entry;
+		m_add_to_cell(entry);
+
+		// rebuilding at every doubling keeps inserts amortized constant time
+		if (m_entries.size() >= pick_rebuild_min && m_entries.size() >= 2 * m_rebuild_size) {
+			m_rebuild();
+		}
+	}
+
+	void pick_index::update(uint64_t id, const glm::vec3 & position) {
+		auto iter = m_entry_index.find(id);
+		if (iter == m_entry_index.end()) {
+			return;
+		}
+
+		const uint32_t entry = iter->second;
+		const uint64_t cell = m_get_cell(position);
+
+		m_entries[entry].position = position;
+
+		if (m_entries[entry].cell != cell) {
+			m_remove_from_cell(entry);
+			m_entries[entry].cell = cell;
+			m_add_to_cell(entry);
+		}
+	}
+
+	void pick_index::remove(uint64_t id) {
+		auto iter = m_entry_index.find(id);
+		if (iter == m_entry_index.end()) {
+			return;
+		}
+
+		const uint32_t entry = iter->second;
+		const uint32_t last = static_cast<uint32_t>(m_entries.size() - 1);
+
+		m_remove_from_cell(entry);
+		m_entry_index.erase(iter);
+
+		// move the last entry into the hole and fix the reference held by its cell
+		if (entry != last) {
+			m_entries[entry] = m_entries[last];
+			m_entry_index[m_entries[entry].id] = entry;
+			m_cells[m_entries[entry].cell][m_entries[entry].cell_slot] = entry;
+		}
+
+		m_entries.pop_back();
+	}
+
+	void pick_index::clear() {
+		m_entries.clear();
+		m_entry_index.clear();
+		m_cells.clear();
+
+		m_rebuild_size = 0;
+		m_cell_min = glm::ivec3(std::numeric_limits<int32_t>::max());
+		m_cell_max = glm::ivec3(std::numeric_limits<int32_t>::min());
+	}
+
+	uint64_t pick_index::pick(const query_t & query, const glm::vec2 & mouse_screen, float radius,
+		const glm::vec3 & camera_pos, float & distance) const {
+
+		m_query_rect(query, mouse_screen - glm::vec2(radius), mouse_screen + glm::vec2(radius));
+
+		uint64_t best_id = 0;
+		float best_dist = 0.0f;
+		bool visible;
+
+		for (const auto candidate : m_candidates) {
+			const auto & entry = m_entries[candidate];
+			const auto pixel_pos = project_to_screen(query.view_projection, query.screen_res, entry.position, visible);
+
+			if (!visible || glm::distance(pixel_pos, mouse_screen) >= radius) {
+				continue;
+			}
+
+			const float dist = glm::distance(camera_pos, entry.position);
+			if (best_id == 0 || dist < best_dist) {
+				best_id = entry.id;
+				best_dist = dist;
+			}
+		}
+
+		distance = best_dist;
+		return best_id;
+	}
+
+	void pick_index::select_box(const query_t & query, const glm::vec2 & top_left_screen,
+		const glm::vec2 & bottom_right_screen, std::vector<uint64_t> & ids) const {
+
+		m_query_rect(query, top_left_screen, bottom_right_screen);
+		bool visible;
+
+		for (const auto candidate : m_candidates) {
+			const auto & entry = m_entries[candidate];
+			const auto pixel_pos = project_to_screen(query.view_projection, query.screen_res, entry.position, visible);
+
+			if (visible &&
+				top_left_screen.x <= pixel_pos.x && pixel_pos.x <= bottom_right_screen.x &&
+				top_left_screen.y <= pixel_pos.y && pixel_pos.y <= bottom_right_screen.y) {
+
+				ids.push_back(entry.id);
+			}
+		}
+	}
+
+	glm::ivec3 pick_index::m_get_cell_coords(const glm::vec3 & position) const {
+		const glm::vec3 scaled = glm::floor(position / m_cell_size);
+		const float limit = static_cast<float>(pick_cell_bias);
+
+		return glm::ivec3(glm::clamp(scaled, glm::vec3(-limit), glm::vec3(limit - 1.0f)));
+	}
+
+	uint64_t pick_index::m_get_cell(const glm::vec3 & position) const {
+		return pack_cell(m_get_cell_coords(position));
+	}
+
+	aabb_t pick_index::m_get_cell_bounds(uint64_t cell) const {
+		const glm::ivec3 coords = unpack_cell(cell);
+		aabb_t bounds;
+
+		bounds.min = glm::vec3(coords) * m_cell_size;
+		bounds.max = bounds.min + glm::vec3(m_cell_size);
+
+		return bounds;
+	}
+
+	void pick_index::m_rebuild() {
+		m_rebuild_size = m_entries.size();
+
+		if (m_entries.empty()) {
+			return;
+		}
+
+		aabb_t bounds;
+		bounds.min = bounds.max = m_entries[0].position;
+
+		for (const auto & entry : m_entries) {
+			bounds.extend(entry.position);
+		}
+
+		const float cell_size = derive_cell_size(bounds, m_entries.size());
+
+		if (cell_size > 0.0f) {
+			// every cell coordinate has to fit its 21 bits
+			const glm::vec3 reach = glm::max(glm::abs(bounds.min), glm::abs(bounds.max));
+			const float max_reach = std::max({ reach.x, reach.y, reach.z });
+			m_cell_size = std::max(cell_size, max_reach / static_cast<float>(pick_cell_bias / 2));
+		}
+
+		m_cells.clear();
+		m_cell_min = glm::ivec3(std::numeric_limits<int32_t>::max());
+		m_cell_max = glm::ivec3(std::numeric_limits<int32_t>::min());
+
+		for (uint32_t entry = 0; entry < m_entries.size(); ++entry) {
+			m_entries[entry].cell = m_get_cell(m_entries[entry].position);
+			m_add_to_cell(entry);
+		}
+	}
+
+	void pick_index::m_add_to_cell(uint32_t entry) {
+		auto & cell = m_cells[m_entries[entry].cell];
+
+		m_entries[entry].cell_slot = static_cast<uint32_t>(cell.size());
+		cell.push_back(entry);
+
+		// grows only, cells emptied since are skipped by the lookup
+		const glm::ivec3 coords = unpack_cell(m_entries[entry].cell);
+		m_cell_min = glm::min(m_cell_min, coords);
+		m_cell_max = glm::max(m_cell_max, coords);
+	}
+
+	void pick_index::m_remove_from_cell(uint32_t entry) {
+		auto iter = m_cells.find(m_entries[entry].cell);
+		if (iter == m_cells.end()) {
+			return;
+		}
+
+		auto & cell = iter->second;
+		const uint32_t slot = m_entries[entry].cell_slot;
+
+		cell[slot] = cell.back();
+		m_entries[cell[slot]].cell_slot = slot;
+		cell.pop_back();
+
+		if (cell.empty()) {
+			m_cells.erase(iter);
+		}
+	}
+
+	bool pick_index::m_get_cell_ranges(const std::array<glm::vec3, 8> & corners) const {
+		m_ranges.clear();
+
+		const glm::vec3 occupied_min = glm::vec3(m_cell_min) * m_cell_size;
+		const glm::vec3 occupied_max = glm::vec3(m_cell_max + 1) * m_cell_size;
+
+		const auto to_cells = [this](const glm::vec3 & point) {
+			const glm::vec3 scaled = glm::clamp(point / m_cell_size, glm::vec3(m_cell_min), glm::vec3(m_cell_max));
+			return glm::ivec3(glm::floor(scaled));
+		};
+
+		glm::vec3 box_min = corners[0], box_max = corners[0];
+		for (const auto & corner : corners) {
+			box_min = glm::min(box_min, corner);
+			box_max = glm::max(box_max, corner);
+		}
+
+		if (glm::any(glm::lessThan(box_max, occupied_min)) || glm::any(glm::greaterThan(box_min, occupied_max))) {
+			return true;
+		}
+
+		// slice along the longest axis of the box, every slice of the convex sub
+		// frustum is bounded by its corners inside the slice and the points where
+		// its edges cross the two slice planes
+		const glm::ivec3 lo = to_cells(box_min), hi = to_cells(box_max);
+		const glm::ivec3 span = hi - lo;
+
+		int axis = 0;
+		if (span[1] > span[axis]) axis = 1;
+		if (span[2] > span[axis]) axis = 2;
+
+		std::size_t num_cells = 0;
+
+		for (int32_t slice = lo[axis]; slice <= hi[axis]; ++slice) {
+			const float slice_min = static_cast<float>(slice) * m_cell_size;
+			const float slice_max = slice_min + m_cell_size;
+
+			glm::vec3 part_min(std::numeric_limits<float>::max());
+			glm::vec3 part_max(std::numeric_limits<float>::lowest());
+			bool empty = true;
+
+			const auto include = [&](const glm::vec3 & point) {
+				part_min = glm::min(part_min, point);
+				part_max = glm::max(part_max, point);
+				empty = false;
+			};
+
+			for (const auto & corner : corners) {
+				if (slice_min <= corner[axis] && corner[axis] <= slice_max) {
+					include(corner);
+				}
+			}
+
+			// edges join corners whose indices differ in one bit
+			for (int i = 0; i < 8; ++i) {
+				for (int bit = 1; bit < 8; bit <<= 1) {
+					if (i & bit) {
+						continue;
+					}
+
+					const auto & a = corners[i];
+					const auto & b = corners[i | bit];
+
+					for (const float plane : { slice_min, slice_max }) {
+						if ((a[axis] - plane) * (b[axis] - plane) < 0.0f) {
+							include(a + (b - a) * ((plane - a[axis]) / (b[axis] - a[axis])));
+						}
+					}
+				}
+			}
+
+			part_min[axis] = part_max[axis] = slice_min;
+
+			if (empty || glm::any(glm::lessThan(part_max, occupied_min)) || glm::any(glm::greaterThan(part_min, occupied_max))) {
+				continue;
+			}
+
+			cell_range_t range = { to_cells(part_min), to_cells(part_max) };
+			range.min[axis] = range.max[axis] = slice;
+
+			const glm::ivec3 size = range.max - range.min + 1;
+			num_cells += static_cast<std::size_t>(size.x) * size.y * size.z;
+
+			if (num_cells > m_cells.size()) {
+				return false;
+			}
+
+			m_ranges.push_back(range);
+		}
+
+		return true;
+	}
+
+	void pick_index::m_query_rect(const query_t & query, const glm::vec2 & min_screen, const glm::vec2 & max_screen) const {
+		m_candidates.clear();
+
+		if (query.screen_res.x <= 0.0f || query.screen_res.y <= 0.0f || m_cells.empty()) {
+			return;
+		}
+
+		const glm::vec2 ndc_min = (min_screen / query.screen_res) * 2.0f - 1.0f;
+		const glm::vec2 ndc_max = (max_screen / query.screen_res) * 2.0f - 1.0f;
+
+		const glm::vec4 row_x = matrix_row(query.view_projection, 0);
+		const glm::vec4 row_y = matrix_row(query.view_projection, 1);
+		const glm::vec4 row_z = matrix_row(query.view_projection, 2);
+		const glm::vec4 row_w = matrix_row(query.view_projection, 3);
+
+		// ndc_min.x * w <= x <= ndc_max.x * w, the same for y, z between the
+		// near and the far plane
+		const std::array<glm::vec4, 6> planes = {
+			row_x - ndc_min.x * row_w,
+			ndc_max.x * row_w - row_x,
+			row_y - ndc_min.y * row_w,
+			ndc_max.y * row_w - row_y,
+			row_z + row_w,
+			row_w - row_z
+		};
+
+		const auto inside = [this, &planes](uint64_t key) {
+			const aabb_t bounds = m_get_cell_bounds(key);
+
+			for (const auto & plane : planes) {
+				if (box_outside_plane(bounds, plane)) {
+					return false;
+				}
+			}
+
+			return true;
+		};
+
+		// corners of the sub frustum on the near and the far plane
+		const glm::mat4x4 inverse = glm::inverse(query.view_projection);
+		std::array<glm::vec3, 8> corners;
+		bool finite = true;
+
+		for (int i = 0; i < 8; ++i) {
+			const glm::vec4 ndc = {
+				(i & 1) ? ndc_max.x : ndc_min.x,
+				(i & 2) ? ndc_max.y : ndc_min.y,
+				(i & 4) ? 1.0f : -1.0f,
+				1.0f
+			};
+
+			const glm::vec4 world = inverse * ndc;
+			corners[i] = glm::vec3(world) / world.w;
+			finite = finite && std::isfinite(corners[i].x) && std::isfinite(corners[i].y) && std::isfinite(corners[i].z);
+		}
+
+		if (finite && m_get_cell_ranges(corners)) {
+			for (const auto & range : m_ranges) {
+				for (int32_t z = range.min.z; z <= range.max.z; ++z) {
+					for (int32_t y = range.min.y; y <= range.max.y; ++y) {
+						for (int32_t x = range.min.x; x <= range.max.x; ++x) {
+							const uint64_t key = pack_cell({ x, y, z });
+							auto iter = m_cells.find(key);
+
+							if (iter != m_cells.end() && inside(key)) {
+								m_candidates.insert(m_candidates.end(), iter->second.begin(), iter->second.end());
+							}
+						}
+					}
+				}
+			}
+
+			return;
+		}
+
+		// the sub frustum covers more cells than are occupied
+		for (const auto & [key, entries] : m_cells) {
+			if (inside(key)) {
+				m_candidates.insert(m_candidates.end(), entries.begin(), entries.end());
+			}
+		}
+	}
+}
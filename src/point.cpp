@@ -1,4 +1,5 @@
 #include "point.hpp"
+#include "pickindex.hpp"
 
 namespace mini {
 	bool point_family_base::get_destroy_allowed () const {
@@ -51,36 +52,53 @@ namespace mini {
 	}
 
 	void point_object::set_color (const glm::vec4 & color) {
-		if (!is_selected ()) {
-			m_billboard.set_color_tint (color);
-		}
-
 		m_color = color;
+		m_update_color ();
 	}
 
 	void point_object::set_select_color (const glm::vec4 & color) {
-		if (is_selected ()) {
-			m_billboard.set_color_tint (color);
-		}
-
 		m_selected_color = color;
+		m_update_color ();
 	}
 
 	point_object::point_object (scene_controller_base & scene, std::shared_ptr<shader_t> shader, std::shared_ptr<texture_t> texture) :
-		scene_obj_t (scene, "point", true, false, false),
-		m_billboard (shader, texture) { 
+		scene_obj_t (scene, "point", true, false, false) { 
 
 		m_color = s_color_default;
 		m_selected_color = s_select_default;
-
 		m_mergeable = true;
-		m_billboard.set_size ({ 16.0f, 16.0f });
+		m_slot = 0;
+
+		auto cloud = scene.get_point_cloud ();
+		if (cloud) {
+			m_cloud = cloud;
+			m_slot = cloud->allocate (get_translation (), m_color);
+		} else {
+			m_billboard = std::make_unique<billboard_object> (shader, texture);
+			m_billboard->set_size ({ 16.0f, 16.0f });
+			m_billboard->set_color_tint (m_color);
+		}
+	}
+
+	point_object::~point_object () {
+		auto cloud = m_cloud.lock ();
+		if (cloud) {
+			cloud->release (m_slot);
+		}
 	}
 
 	void point_object::render (app_context & context, const glm::mat4x4 & world_matrix) const {
-		if (get_scene ().get_show_points ()) {
+		if (!get_scene ().get_show_points ()) {
+			return;
+		}
+
+		auto cloud = m_cloud.lock ();
+		if (cloud) {
+			// drawn later together with all other points
+			cloud->enqueue (m_slot, scene_obj_t::get_pick_id ());
+		} else if (m_billboard) {
 			glDisable (GL_DEPTH_TEST);
-			m_billboard.render (context, world_matrix);
+			m_billboard->render (context, world_matrix);
 			glEnable (GL_DEPTH_TEST);
 		}
 	}
@@ -102,7 +120,7 @@ namespace mini {
 			((screen_pos.y + 1.0f) / 2.0f) * data.screen_res.y
 		};
 
-		if (glm::distance (pixel_pos, data.mouse_screen) < 25.0f) {
+		if (glm::distance (pixel_pos, data.mouse_screen) < pick_radius_pixels) {
 			hit_pos = get_translation ();
 			return true;
 		}
@@ -134,6 +152,20 @@ namespace mini {
 		return false;
 	}
 
+	bool point_object::get_pick_point (glm::vec3 & point) const {
+		point = get_translation ();
+		return true;
+	}
+
+	uint32_t point_object::get_pick_id () const {
+		// points in the cloud carry their id per instance
+		return m_cloud.expired () ? scene_obj_t::get_pick_id () : pick_id_none;
+	}
+
+	bool point_object::is_batched () const {
+		return !m_cloud.expired ();
+	}
+
 	void point_object::add_parent (std::shared_ptr<point_family_base> family) {
 		for (auto iter = m_parents.begin (); iter != m_parents.end (); ) {
 			auto parent = iter->lock();
@@ -192,10 +224,13 @@ namespace mini {
 	}
 
 	void point_object::t_on_selection (bool selected) {
-		if (selected) {
-			m_billboard.set_color_tint (m_selected_color);
-		} else {
-			m_billboard.set_color_tint (m_color);
+		m_update_color ();
+	}
+
+	void point_object::t_on_translation (const glm::vec3 & translation) {
+		auto cloud = m_cloud.lock ();
+		if (cloud) {
+			cloud->set_position (m_slot, translation);
 		}
 	}
 
@@ -231,4 +266,15 @@ namespace mini {
 		set_deletable (deletable);
 		m_mergeable = mergeable;
 	}
+
+	void point_object::m_update_color () {
+		const auto & color = is_selected () ? m_selected_color : m_color;
+		auto cloud = m_cloud.lock ();
+
+		if (cloud) {
+			cloud->set_color (m_slot, color);
+		} else if (m_billboard) {
+			m_billboard->set_color_tint (color);
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cstddef>
+
+#include "pointcloud.hpp"
+#include "profiler.hpp"
+
+namespace mini {
+	constexpr GLuint point_cloud_texture_slot = 1;
+
+	point_cloud::point_cloud(std::shared_ptr<shader_t> shader, std::shared_ptr<texture_t> texture) {
+		m_shader = shader;
+		m_texture = texture;
+		m_size = { 16.0f, 16.0f };
+
+		m_dirty_begin = m_dirty_end = 0;
+		m_point_capacity = m_slot_capacity = 0;
+
+		constexpr GLuint a_position = 0;
+		constexpr GLuint a_uv = 2;
+		constexpr GLuint a_slot = 3;
+		constexpr GLuint a_pick_id = 4;
+
+		glGenVertexArrays(1, &m_vao);
+		glGenBuffers(3, m_quad_buffers);
+		glGenBuffers(1, &m_point_buffer);
+		glGenBuffers(1, &m_slot_buffer);
+		glGenTextures(1, &m_point_texture);
+
+		glBindVertexArray(m_vao);
+
+		glBindBuffer(GL_ARRAY_BUFFER, m_quad_buffers[0]);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * quad_vertices.size(), quad_vertices.data(), GL_STATIC_DRAW);
+		glVertexAttribPointer(a_position, 3, GL_FLOAT, false, sizeof(float) * 3, (void *)0);
+		glEnableVertexAttribArray(a_position);
+
+		glBindBuffer(GL_ARRAY_BUFFER, m_quad_buffers[1]);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * quad_texcoords.size(), quad_texcoords.data(), GL_STATIC_DRAW);
+		glVertexAttribPointer(a_uv, 2, GL_FLOAT, false, sizeof(float) * 2, (void *)0);
+		glEnableVertexAttribArray(a_uv);
+
+		// one slot index per instance, the shader fetches the point by it
+		glBindBuffer(GL_ARRAY_BUFFER, m_slot_buffer);
+		glVertexAttribIPointer(a_slot, 1, GL_UNSIGNED_INT, sizeof(instance_t), (void *)offsetof(instance_t, slot));
+		glVertexAttribDivisor(a_slot, 1);
+		glEnableVertexAttribArray(a_slot);
+
+		glVertexAttribIPointer(a_pick_id, 1, GL_UNSIGNED_INT, sizeof(instance_t), (void *)offsetof(instance_t, pick_id));
+		glVertexAttribDivisor(a_pick_id, 1);
+		glEnableVertexAttribArray(a_pick_id);
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_quad_buffers[2]);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * quad_indices.size(), quad_indices.data(), GL_STATIC_DRAW);
+
+		glBindVertexArray(static_cast<GLuint>(NULL));
+		glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(NULL));
+	}
+
+	point_cloud::~point_cloud() {
+		glDeleteTextures(1, &m_point_texture);
+		glDeleteBuffers(1, &m_slot_buffer);
+		glDeleteBuffers(1, &m_point_buffer);
+		glDeleteBuffers(3, m_quad_buffers);
+		glDeleteVertexArrays(1, &m_vao);
+	}
+
+	const glm::vec2 & point_cloud::get_size() const {
+		return m_size;
+	}
+
+	void point_cloud::set_size(const glm::vec2 & size) {
+		m_size = size;
+	}
+
+	std::size_t point_cloud::get_num_points() const {
+		return m_points.size() - m_free_slots.size();
+	}
+
+	point_cloud::slot_t point_cloud::allocate(const glm::vec3 & position, const glm::vec4 & color) {
+		slot_t slot;
+
+		if (m_free_slots.empty()) {
+			slot = static_cast<slot_t>(m_points.size());
+			m_points.push_back({ glm::vec4(position, 1.0f), color });
+		} else {
+			slot = m_free_slots.back();
+			m_free_slots.pop_back();
+			m_points[slot] = { glm::vec4(position, 1.0f), color };
+		}
+
+		m_mark_dirty(slot);
+		return slot;
+	}
+
+	void point_cloud::release(slot_t slot) {
+		// released slots are never enqueued so their data can stay as it is
+		m_free_slots.push_back(slot);
+	}
+
+	void point_cloud::set_position(slot_t slot, const glm::vec3 & position) {
+		m_points[slot].position = glm::vec4(position, 1.0f);
+		m_mark_dirty(slot);
+	}
+
+	void point_cloud::set_color(slot_t slot, const glm::vec4 & color) {
+		m_points[slot].color = color;
+		m_mark_dirty(slot);
+	}
+
+	void point_cloud::enqueue(slot_t slot, uint32_t pick_id) {
+		m_queued.push_back({ slot, pick_id });
+	}
+
+	void point_cloud::render(app_context & context, const glm::mat4x4 & world_matrix) const {
+		profile_scope scope("point_cloud", true);
+
+		m_upload_points();
+		m_upload_slots();
+
+		if (m_drawn.empty()) {
+			return;
+		}
+
+		glBindVertexArray(m_vao);
+		glDisable(GL_DEPTH_TEST);
+
+		if (m_texture) {
+			m_texture->bind();
+		}
+
+		glActiveTexture(GL_TEXTURE0 + point_cloud_texture_slot);
+		glBindTexture(GL_TEXTURE_BUFFER, m_point_texture);
+
+		m_shader->bind();
+
+		m_shader->set_uniform(m_shader->get_uniform_location(shader_uniform_t::size), m_size);
+		m_shader->set_uniform_sampler("u_points", point_cloud_texture_slot);
+
+		glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(quad_indices.size()), GL_UNSIGNED_INT, NULL,
+			static_cast<GLsizei>(m_drawn.size()));
+
+		glBindTexture(GL_TEXTURE_BUFFER, static_cast<GLuint>(NULL));
+		glActiveTexture(GL_TEXTURE0);
+
+		glBindVertexArray(static_cast<GLuint>(NULL));
+		glEnable(GL_DEPTH_TEST);
+	}
+
+	render_key_t point_cloud::get_render_key() const {
+		return {
+			m_shader ? m_shader->get_program_handle() : 0,
+			m_vao,
+			m_texture ? m_texture->get_handle() : 0
+		};
+	}
+
+	uint32_t point_cloud::get_pick_id() const {
+		// every instance carries the id of its point
+		return pick_id_per_instance;
+	}
+
+	void point_cloud::m_mark_dirty(slot_t slot) {
+		if (m_dirty_begin == m_dirty_end) {
+			m_dirty_begin = slot;
+			m_dirty_end = slot + 1;
+		} else {
+			m_dirty_begin = std::min<std::size_t>(m_dirty_begin, slot);
+			m_dirty_end = std::max<std::size_t>(m_dirty_end, slot + 1);
+		}
+	}
+
+	void point_cloud::m_upload_points() const {
+		if (m_points.size() > m_point_capacity) {
+			// grow geometrically and reupload everything
+			m_point_capacity = std::max<std::size_t>(m_points.size(), m_point_capacity * 2);
+			m_dirty_begin = 0;
+			m_dirty_end = m_points.size();
+
+			glBindBuffer(GL_TEXTURE_BUFFER, m_point_buffer);
+			glBufferData(GL_TEXTURE_BUFFER, sizeof(point_data_t) * m_point_capacity, NULL, GL_DYNAMIC_DRAW);
+
+			glBindTexture(GL_TEXTURE_BUFFER, m_point_texture);
+			glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_point_buffer);
+			glBindTexture(GL_TEXTURE_BUFFER, static_cast<GLuint>(NULL));
+		}
+
+		if (m_dirty_begin == m_dirty_end) {
+			return;
+		}
+
+		glBindBuffer(GL_TEXTURE_BUFFER, m_point_buffer);
+		glBufferSubData(GL_TEXTURE_BUFFER,
+			sizeof(point_data_t) * m_dirty_begin,
+			sizeof(point_data_t) * (m_dirty_end - m_dirty_begin),
+			m_points.data() + m_dirty_begin);
+
+		glBindBuffer(GL_TEXTURE_BUFFER, static_cast<GLuint>(NULL));
+		m_dirty_begin = m_dirty_end = 0;
+	}
+
+	void point_cloud::m_upload_slots() const {
+		// the set of visible points rarely changes between frames
+		if (m_queued == m_drawn) {
+			m_queued.clear();
+			return;
+		}
+
+		m_drawn.swap(m_queued);
+		m_queued.clear();
+
+		glBindBuffer(GL_ARRAY_BUFFER, m_slot_buffer);
+
+		if (m_drawn.size() > m_slot_capacity) {
+			m_slot_capacity = std::max<std::size_t>(m_drawn.size(), m_slot_capacity * 2);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(instance_t) * m_slot_capacity, NULL, GL_DYNAMIC_DRAW);
+		}
+
+		if (!m_drawn.empty()) {
+			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(instance_t) * m_drawn.size(), m_drawn.data());
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(NULL));
+	}
+}
@@ -0,0 +1,530 @@
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <stdexcept>
+
+#include <imgui.h>
+#include <nlohmann/json.hpp>
+
+#include "profiler.hpp"
+
+namespace mini {
+	constexpr std::size_t profiler_query_batch = 64;
+	constexpr std::size_t profiler_no_gpu_scope = static_cast<std::size_t> (-1);
+	constexpr std::size_t profiler_top_scopes = 20;
+
+	constexpr float profiler_row_height = 18.0f;
+	constexpr float profiler_min_label_width = 40.0f;
+
+	static const char * track_name (frame_profiler::track_t track) {
+		return (track == frame_profiler::track_t::gpu) ? "gpu" : "cpu";
+	}
+
+	// every scope name keeps its color from frame to frame
+	static ImU32 scope_color (const char * name) {
+		const auto hash = std::hash<std::string> () (name);
+		const float hue = static_cast<float> (hash % 360) / 360.0f;
+
+		return ImGui::ColorConvertFloat4ToU32 (ImColor::HSV (hue, 0.5f, 0.65f));
+	}
+
+	frame_profiler & frame_profiler::get_instance () {
+		static frame_profiler profiler;
+		return profiler;
+	}
+
+	// queries are not deleted, the profiler outlives the opengl context
+	frame_profiler::frame_profiler () {
+		m_epoch = profiler_clock::now ();
+		m_enabled = false;
+		m_recording = false;
+		m_frame_index = 0;
+		m_gpu_depth = 0;
+		m_history_events = 0;
+		m_selected_frame = 0;
+	}
+
+	bool frame_profiler::is_enabled () const {
+		return m_enabled;
+	}
+
+	bool frame_profiler::is_recording () const {
+		return m_recording;
+	}
+
+	void frame_profiler::set_enabled (bool enabled) {
+		m_enabled = enabled;
+	}
+
+	void frame_profiler::begin_frame () {
+		// queries of earlier frames are read back even after recording stopped
+		m_resolve_gpu_frames ();
+
+		m_recording = m_enabled;
+		if (!m_recording) {
+			return;
+		}
+
+		m_frame.index = m_frame_index++;
+		m_frame.start = m_now ();
+		m_frame.duration = 0.0;
+		m_frame.gpu_resolved = false;
+		m_frame.events.clear ();
+
+		m_open_scopes.clear ();
+		m_object_events.clear ();
+		m_gpu_depth = 0;
+
+		m_gpu_frame.index = m_frame.index;
+		m_gpu_frame.start_query = m_get_query ();
+		m_gpu_frame.last_query = m_gpu_frame.start_query;
+		m_gpu_frame.start = m_frame.start;
+		m_gpu_frame.scopes.clear ();
+
+		glQueryCounter (m_gpu_frame.start_query, GL_TIMESTAMP);
+	}
+
+	void frame_profiler::end_frame () {
+		if (!m_recording) {
+			return;
+		}
+
+		// scopes left open by an exception end with the frame
+		while (!m_open_scopes.empty ()) {
+			end_scope ();
+		}
+
+		m_frame.duration = m_now () - m_frame.start;
+
+		m_gpu_pending.push_back (std::move (m_gpu_frame));
+		m_history_events += m_frame.events.size ();
+		m_history.push_back (std::move (m_frame));
+
+		m_trim_history ();
+		m_recording = false;
+	}
+
+	void frame_profiler::begin_scope (const char * name, bool gpu) {
+		begin_scope (name, std::string (), gpu);
+	}
+
+	void frame_profiler::begin_scope (const char * name, std::string label, bool gpu) {
+		if (!m_recording) {
+			return;
+		}
+
+		open_scope_t scope = { m_frame.events.size (), profiler_no_gpu_scope };
+
+		if (gpu) {
+			const GLuint query = m_get_query ();
+			glQueryCounter (query, GL_TIMESTAMP);
+
+			scope.gpu_scope = m_gpu_frame.scopes.size ();
+			m_gpu_frame.scopes.push_back ({ name, label, m_gpu_depth++, query, 0 });
+			m_gpu_frame.last_query = query;
+		}
+
+		const auto depth = static_cast<uint32_t> (m_open_scopes.size ());
+		m_frame.events.push_back ({ name, std::move (label), track_t::cpu, depth, m_now (), 0.0, 1 });
+		m_open_scopes.push_back (scope);
+	}
+
+	void frame_profiler::end_scope () {
+		if (!m_recording || m_open_scopes.empty ()) {
+			return;
+		}
+
+		const auto scope = m_open_scopes.back ();
+		m_open_scopes.pop_back ();
+
+		auto & event = m_frame.events[scope.event];
+		event.duration = m_now () - event.start;
+
+		if (scope.gpu_scope != profiler_no_gpu_scope) {
+			const GLuint query = m_get_query ();
+			glQueryCounter (query, GL_TIMESTAMP);
+
+			m_gpu_frame.scopes[scope.gpu_scope].end_query = query;
+			m_gpu_frame.last_query = query;
+			m_gpu_depth--;
+		}
+	}
+
+	double frame_profiler::get_time () const {
+		return m_now ();
+	}
+
+	void frame_profiler::add_object_time (const char * name, const void * object, const std::string & label, double start, double duration) {
+		if (!m_recording) {
+			return;
+		}
+
+		auto iter = m_object_events.find ({ name, object });
+		if (iter != m_object_events.end ()) {
+			auto & event = m_frame.events[iter->second];
+			event.duration += duration;
+			event.count++;
+			return;
+		}
+
+		// an object shows up once it takes long enough, later samples are summed up
+		if (duration < profiler_object_threshold) {
+			return;
+		}
+
+		const auto depth = static_cast<uint32_t> (m_open_scopes.size ());
+		m_object_events.emplace (std::make_pair (name, object), m_frame.events.size ());
+		m_frame.events.push_back ({ name, label, track_t::cpu, depth, start, duration, 1 });
+	}
+
+	const std::deque<frame_profiler::frame_t> & frame_profiler::get_history () const {
+		return m_history;
+	}
+
+	void frame_profiler::save_trace (const std::string & path) const {
+		using json = nlohmann::json;
+		json events = json::array ();
+
+		for (const auto track : { track_t::cpu, track_t::gpu }) {
+			json thread_name;
+			thread_name["name"] = "thread_name";
+			thread_name["ph"] = "M";
+			thread_name["pid"] = 0;
+			thread_name["tid"] = static_cast<uint32_t> (track);
+			thread_name["args"]["name"] = track_name (track);
+
+			events.push_back (std::move (thread_name));
+		}
+
+		for (const auto & frame : m_history) {
+			json frame_event;
+			frame_event["name"] = "frame";
+			frame_event["ph"] = "X";
+			frame_event["ts"] = frame.start;
+			frame_event["dur"] = frame.duration;
+			frame_event["pid"] = 0;
+			frame_event["tid"] = static_cast<uint32_t> (track_t::cpu);
+			frame_event["args"]["index"] = frame.index;
+
+			events.push_back (std::move (frame_event));
+
+			for (const auto & event : frame.events) {
+				json trace_event;
+				trace_event["name"] = event.label.empty () ? std::string (event.name) : std::string (event.name) + " " + event.label;
+				trace_event["cat"] = event.name;
+				trace_event["ph"] = "X";
+				trace_event["ts"] = event.start;
+				trace_event["dur"] = event.duration;
+				trace_event["pid"] = 0;
+				trace_event["tid"] = static_cast<uint32_t> (event.track);
+
+				if (event.count > 1) {
+					trace_event["args"]["count"] = event.count;
+				}
+
+				events.push_back (std::move (trace_event));
+			}
+		}
+
+		json trace;
+		trace["traceEvents"] = std::move (events);
+		trace["displayTimeUnit"] = "ms";
+
+		std::ofstream stream (path, std::ios::binary | std::ios::trunc);
+		if (!stream) {
+			throw std::runtime_error ("failed to open file " + path);
+		}
+
+		stream << trace.dump ();
+
+		if (!stream) {
+			throw std::runtime_error ("failed to write file " + path);
+		}
+	}
+
+	void frame_profiler::configure () {
+		bool enabled = m_enabled;
+		if (ImGui::Checkbox ("Record", &enabled)) {
+			set_enabled (enabled);
+		}
+
+		if (m_history.empty ()) {
+			ImGui::TextDisabled ("no frames recorded");
+			return;
+		}
+
+		std::vector<float> durations;
+		durations.reserve (m_history.size ());
+
+		float max_duration = 1000.0f / 60.0f;
+		int newest = static_cast<int> (m_history.size ()) - 1;
+
+		for (const auto & frame : m_history) {
+			durations.push_back (static_cast<float> (frame.duration / 1000.0));
+			max_duration = std::max (max_duration, durations.back ());
+		}
+
+		// the newest frame whose gpu scopes are already in
+		for (int i = newest; i >= 0; --i) {
+			if (m_history[i].gpu_resolved) {
+				newest = i;
+				break;
+			}
+		}
+
+		ImGui::PlotHistogram ("##frame_times", durations.data (), static_cast<int> (durations.size ()),
+			0, nullptr, 0.0f, max_duration, ImVec2 (-1.0f, 60.0f));
+
+		// frames are picked from the graph while not recording
+		if (m_enabled) {
+			m_selected_frame = newest;
+		} else if (ImGui::IsItemHovered () && ImGui::IsMouseClicked (0)) {
+			const float width = std::max (ImGui::GetItemRectSize ().x, 1.0f);
+			const float offset = (ImGui::GetIO ().MousePos.x - ImGui::GetItemRectMin ().x) / width;
+
+			m_selected_frame = static_cast<int> (offset * static_cast<float> (m_history.size ()));
+		}
+
+		m_selected_frame = std::clamp (m_selected_frame, 0, static_cast<int> (m_history.size ()) - 1);
+
+		const auto & frame = m_history[m_selected_frame];
+		ImGui::Text ("Frame %llu: %.3f ms", static_cast<unsigned long long> (frame.index), frame.duration / 1000.0);
+
+		m_draw_timeline (frame);
+		ImGui::NewLine ();
+		m_draw_top_scopes (frame);
+	}
+
+	double frame_profiler::m_now () const {
+		return std::chrono::duration<double, std::micro> (profiler_clock::now () - m_epoch).count ();
+	}
+
+	GLuint frame_profiler::m_get_query () {
+		if (m_free_queries.empty ()) {
+			m_free_queries.resize (profiler_query_batch);
+			glGenQueries (static_cast<GLsizei> (profiler_query_batch), m_free_queries.data ());
+		}
+
+		const GLuint query = m_free_queries.back ();
+		m_free_queries.pop_back ();
+
+		return query;
+	}
+
+	void frame_profiler::m_resolve_gpu_frames () {
+		while (!m_gpu_pending.empty ()) {
+			auto & pending = m_gpu_pending.front ();
+
+			// timestamps complete in order, the last one decides for the whole frame
+			GLuint available = GL_FALSE;
+			glGetQueryObjectuiv (pending.last_query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+			if (available == GL_FALSE) {
+				break;
+			}
+
+			GLuint64 gpu_start = 0;
+			glGetQueryObjectui64v (pending.start_query, GL_QUERY_RESULT, &gpu_start);
+			m_free_queries.push_back (pending.start_query);
+
+			// the frame may already have left the history
+			auto frame = std::lower_bound (m_history.begin (), m_history.end (), pending.index,
+				[] (const frame_t & frame, uint64_t index) {
+					return frame.index < index;
+				});
+
+			if (frame != m_history.end () && frame->index != pending.index) {
+				frame = m_history.end ();
+			}
+
+			for (auto & scope : pending.scopes) {
+				GLuint64 begin = 0, end = 0;
+				glGetQueryObjectui64v (scope.begin_query, GL_QUERY_RESULT, &begin);
+				glGetQueryObjectui64v (scope.end_query, GL_QUERY_RESULT, &end);
+
+				m_free_queries.push_back (scope.begin_query);
+				m_free_queries.push_back (scope.end_query);
+
+				// gpu time is placed relative to the cpu start of the frame
+				if (frame != m_history.end ()) {
+					const double start = pending.start + static_cast<double> (begin - gpu_start) / 1000.0;
+					const double duration = static_cast<double> (end - begin) / 1000.0;
+
+					frame->events.push_back ({ scope.name, std::move (scope.label), track_t::gpu, scope.depth, start, duration, 1 });
+					m_history_events++;
+				}
+			}
+
+			if (frame != m_history.end ()) {
+				frame->gpu_resolved = true;
+			}
+
+			m_gpu_pending.pop_front ();
+		}
+
+		m_trim_history ();
+	}
+
+	void frame_profiler::m_trim_history () {
+		// the newest frame always stays, however many events it has
+		while (m_history.size () > 1 &&
+			(m_history.size () > profiler_history_size || m_history_events > profiler_history_events)) {
+			m_history_events -= m_history.front ().events.size ();
+			m_history.pop_front ();
+		}
+	}
+
+	void frame_profiler::m_draw_timeline (const frame_t & frame) {
+		uint32_t cpu_rows = 1, gpu_rows = 0;
+		double span = std::max (frame.duration, 1.0);
+
+		for (const auto & event : frame.events) {
+			if (event.track == track_t::cpu) {
+				cpu_rows = std::max (cpu_rows, event.depth + 1);
+			} else {
+				gpu_rows = std::max (gpu_rows, event.depth + 1);
+			}
+
+			// gpu work may finish after the cpu frame
+			span = std::max (span, event.start + event.duration - frame.start);
+		}
+
+		const float width = std::max (ImGui::GetContentRegionAvail ().x, 1.0f);
+		const float height = static_cast<float> (cpu_rows + gpu_rows) * profiler_row_height;
+		const float scale = width / static_cast<float> (span);
+		const ImVec2 origin = ImGui::GetCursorScreenPos ();
+
+		ImGui::InvisibleButton ("##timeline", ImVec2 (width, height));
+
+		const bool hovered = ImGui::IsItemHovered ();
+		const ImVec2 mouse = ImGui::GetIO ().MousePos;
+		const event_t * hovered_event = nullptr;
+
+		ImDrawList * draw_list = ImGui::GetWindowDrawList ();
+
+		for (const auto & event : frame.events) {
+			const uint32_t row = (event.track == track_t::cpu) ? event.depth : cpu_rows + event.depth;
+
+			const float x0 = origin.x + static_cast<float> (event.start - frame.start) * scale;
+			const float x1 = std::max (x0 + 1.0f, x0 + static_cast<float> (event.duration) * scale);
+			const float y0 = origin.y + static_cast<float> (row) * profiler_row_height;
+			const float y1 = y0 + profiler_row_height - 1.0f;
+
+			draw_list->AddRectFilled (ImVec2 (x0, y0), ImVec2 (x1, y1), scope_color (event.name));
+
+			if (x1 - x0 > profiler_min_label_width) {
+				const char * text = event.label.empty () ? event.name : event.label.c_str ();
+
+				draw_list->PushClipRect (ImVec2 (x0, y0), ImVec2 (x1, y1), true);
+				draw_list->AddText (ImVec2 (x0 + 3.0f, y0 + 2.0f), IM_COL32_WHITE, text);
+				draw_list->PopClipRect ();
+			}
+
+			if (hovered && x0 <= mouse.x && mouse.x <= x1 && y0 <= mouse.y && mouse.y <= y1) {
+				hovered_event = &event;
+			}
+		}
+
+		if (hovered_event) {
+			ImGui::SetTooltip ("%s %s\n%.3f ms (%s)", hovered_event->name, hovered_event->label.c_str (),
+				hovered_event->duration / 1000.0, track_name (hovered_event->track));
+		}
+	}
+
+	void frame_profiler::m_draw_top_scopes (const frame_t & frame) {
+		struct total_t {
+			const event_t * event;
+			double duration;
+			uint32_t count;
+		};
+
+		// scopes of the same name and object are summed up per track
+		std::vector<total_t> totals;
+		std::unordered_map<std::string, std::size_t> index;
+
+		for (const auto & event : frame.events) {
+			const std::string key = std::string (event.name) + '\n' + event.label + '\n' + track_name (event.track);
+			auto iter = index.find (key);
+
+			if (iter == index.end ()) {
+				index.emplace (key, totals.size ());
+				totals.push_back ({ &event, event.duration, event.count });
+			} else {
+				totals[iter->second].duration += event.duration;
+				totals[iter->second].count += event.count;
+			}
+		}
+
+		const auto count = std::min (totals.size (), profiler_top_scopes);
+		std::partial_sort (totals.begin (), totals.begin () + count, totals.end (), [] (const total_t & a, const total_t & b) {
+			return a.duration > b.duration;
+		});
+
+		ImGui::Columns (4, "##top_scopes");
+		ImGui::Text ("Scope");
+		ImGui::NextColumn ();
+		ImGui::Text ("Object");
+		ImGui::NextColumn ();
+		ImGui::Text ("Track");
+		ImGui::NextColumn ();
+		ImGui::Text ("Time");
+		ImGui::NextColumn ();
+		ImGui::Separator ();
+
+		for (std::size_t i = 0; i < count; ++i) {
+			const auto & total = totals[i];
+
+			ImGui::Text ("%s", total.event->name);
+			ImGui::NextColumn ();
+			ImGui::Text ("%s", total.event->label.c_str ());
+			ImGui::NextColumn ();
+			ImGui::Text ("%s", track_name (total.event->track));
+			ImGui::NextColumn ();
+			ImGui::Text ("%.3f ms (%u)", total.duration / 1000.0, total.count);
+			ImGui::NextColumn ();
+		}
+
+		ImGui::Columns (1);
+	}
+
+	profile_scope::profile_scope (const char * name, bool gpu) {
+		auto & profiler = frame_profiler::get_instance ();
+		m_active = profiler.is_recording ();
+
+		if (m_active) {
+			profiler.begin_scope (name, gpu);
+		}
+	}
+
+	profile_scope::profile_scope (const char * name, const std::string & label, bool gpu) {
+		auto & profiler = frame_profiler::get_instance ();
+		m_active = profiler.is_recording ();
+
+		if (m_active) {
+			profiler.begin_scope (name, label, gpu);
+		}
+	}
+
+	profile_scope::~profile_scope () {
+		if (m_active) {
+			frame_profiler::get_instance ().end_scope ();
+		}
+	}
+
+	profile_object_scope::profile_object_scope (const char * name, const void * object, const std::string & label) {
+		auto & profiler = frame_profiler::get_instance ();
+
+		m_name = name;
+		m_object = object;
+		m_label = profiler.is_recording () ? &label : nullptr;
+		m_start = m_label ? profiler.get_time () : 0.0;
+	}
+
+	profile_object_scope::~profile_object_scope () {
+		if (m_label) {
+			auto & profiler = frame_profiler::get_instance ();
+			profiler.add_object_time (m_name, m_object, *m_label, m_start, profiler.get_time () - m_start);
+		}
+	}
+}
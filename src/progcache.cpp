@@ -0,0 +1,147 @@
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+
+#include "progcache.hpp"
+
+namespace mini {
+	constexpr uint32_t program_cache_magic = 0x4250474d; // "MGPB"
+	constexpr uint32_t program_cache_version = 1;
+
+	struct program_cache_header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t format;
+		uint32_t length;
+	};
+
+	static uint64_t fnv1a(const std::string & data, uint64_t hash = 0xcbf29ce484222325ull) {
+		for (unsigned char c : data) {
+			hash ^= c;
+			hash *= 0x100000001b3ull;
+		}
+
+		return hash;
+	}
+
+	static std::string gl_string(GLenum name) {
+		const auto * value = reinterpret_cast<const char *>(glGetString(name));
+		return value ? std::string(value) : std::string();
+	}
+
+	program_cache::program_cache(const std::string & directory) {
+		m_directory = directory;
+
+		GLint num_formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+
+		m_driver = gl_string(GL_VENDOR) + '\n' + gl_string(GL_RENDERER) + '\n' + gl_string(GL_VERSION);
+		m_enabled = num_formats > 0;
+
+		if (m_enabled) {
+			std::error_code error;
+			std::filesystem::create_directories(m_directory, error);
+			m_enabled = !error;
+		}
+	}
+
+	bool program_cache::is_enabled() const {
+		return m_enabled;
+	}
+
+	bool program_cache::load(shader_t & shader) const {
+		if (!m_enabled) {
+			return false;
+		}
+
+		const std::string path = m_get_path(shader);
+
+		std::error_code error;
+		const auto file_size = std::filesystem::file_size(path, error);
+		if (error) {
+			return false;
+		}
+
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream) {
+			return false;
+		}
+
+		program_cache_header header;
+		if (!stream.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+			return false;
+		}
+
+		if (header.magic != program_cache_magic || header.version != program_cache_version) {
+			return false;
+		}
+
+		// a truncated or corrupt file is a miss, never trust the length to allocate
+		if (header.length == 0 || file_size != sizeof(header) + static_cast<uint64_t>(header.length)) {
+			return false;
+		}
+
+		std::vector<uint8_t> binary(header.length);
+		if (!stream.read(reinterpret_cast<char *>(binary.data()), binary.size())) {
+			return false;
+		}
+
+		return shader.load_binary(static_cast<GLenum>(header.format), binary);
+	}
+
+	void program_cache::store(const shader_t & shader) const {
+		if (!m_enabled) {
+			return;
+		}
+
+		GLenum format = 0;
+		std::vector<uint8_t> binary;
+
+		if (!shader.get_binary(format, binary)) {
+			return;
+		}
+
+		program_cache_header header;
+		header.magic = program_cache_magic;
+		header.version = program_cache_version;
+		header.format = static_cast<uint32_t>(format);
+		header.length = static_cast<uint32_t>(binary.size());
+
+		// write next to the target and rename so a crash never leaves half a binary
+		const std::string path = m_get_path(shader);
+		const std::string temp_path = path + ".tmp";
+
+		{
+			std::ofstream stream(temp_path, std::ios::binary | std::ios::trunc);
+			if (!stream) {
+				return;
+			}
+
+			stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+			stream.write(reinterpret_cast<const char *>(binary.data()), binary.size());
+
+			if (!stream) {
+				stream.close();
+				std::remove(temp_path.c_str());
+				return;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temp_path, path, error);
+
+		if (error) {
+			std::remove(temp_path.c_str());
+		}
+	}
+
+	std::string program_cache::m_get_path(const shader_t & shader) const {
+		const uint64_t hash = fnv1a(shader.get_combined_source(), fnv1a(m_driver));
+
+		char name[32];
+		std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hash));
+
+		return (std::filesystem::path(m_directory) / name).string();
+	}
+}
@@ -0,0 +1,163 @@
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include <algorithm>
+
+#include "saver.hpp"
+
+namespace mini {
+	// serializing and writing each take half of the progress bar
+	constexpr float save_serialize_share = 0.5f;
+	constexpr std::size_t save_chunk_size = 4 << 20;
+
+	scene_saver::scene_saver() {
+		m_running = false;
+		m_progress = 0.0f;
+	}
+
+	scene_saver::~scene_saver() {
+		wait();
+	}
+
+	bool scene_saver::is_saving() const {
+		return m_running || m_pending.has_value();
+	}
+
+	float scene_saver::get_progress() const {
+		return m_progress;
+	}
+
+	const std::string & scene_saver::get_path() const {
+		return m_path;
+	}
+
+	void scene_saver::save(std::shared_ptr<const scene_snapshot> snapshot, const std::string & path, bool binary) {
+		request_t request = { snapshot, path, binary };
+
+		if (m_running) {
+			m_pending = std::move(request);
+			return;
+		}
+
+		// the previous save completed but was not polled yet, its result
+		// must not be taken for the one that starts now
+		if (m_thread.joinable()) {
+			m_thread.join();
+
+			if (!m_error.empty()) {
+				m_unreported_error = m_error;
+			}
+		}
+
+		m_start(std::move(request));
+	}
+
+	void scene_saver::wait() {
+		if (m_thread.joinable()) {
+			m_thread.join();
+		}
+
+		// a queued save is still written, the scene it was taken from may be gone
+		if (m_pending) {
+			m_worker(std::move(*m_pending));
+			m_pending.reset();
+		}
+	}
+
+	bool scene_saver::poll(std::string & error) {
+		if (!m_unreported_error.empty()) {
+			error = m_unreported_error;
+			m_unreported_error.clear();
+			return false;
+		}
+
+		if (m_running || !m_thread.joinable()) {
+			return true;
+		}
+
+		m_thread.join();
+
+		const bool succeeded = m_error.empty();
+		error = m_error;
+		m_error.clear();
+
+		if (m_pending) {
+			m_start(std::move(*m_pending));
+			m_pending.reset();
+		}
+
+		return succeeded;
+	}
+
+	void scene_saver::m_start(request_t request) {
+		m_error.clear();
+		m_path = request.path;
+		m_progress = 0.0f;
+		m_running = true;
+
+		m_thread = std::thread(&scene_saver::m_worker, this, std::move(request));
+	}
+
+	void scene_saver::m_worker(request_t request) {
+		const auto progress = [this](float value) {
+			m_progress = value * save_serialize_share;
+		};
+
+		try {
+			const std::string data = request.binary ?
+				request.snapshot->get_binary_data(progress) :
+				request.snapshot->get_data(progress);
+
+			// the snapshot can go as soon as it is serialized
+			request.snapshot.reset();
+			m_write(request.path, data);
+		} catch (const std::exception & error) {
+			m_error = error.what();
+		}
+
+		m_progress = 1.0f;
+		m_running = false;
+	}
+
+	bool scene_saver::m_write(const std::string & path, const std::string & data) {
+		const std::string temp_path = path + ".tmp";
+
+		{
+			std::ofstream stream(temp_path, std::ios::binary | std::ios::trunc);
+			if (!stream) {
+				m_error = "failed to open file " + temp_path;
+				return false;
+			}
+
+			for (std::size_t offset = 0; offset < data.size() && stream; offset += save_chunk_size) {
+				const std::size_t length = std::min(save_chunk_size, data.size() - offset);
+				stream.write(data.data() + offset, length);
+
+				m_progress = save_serialize_share + (1.0f - save_serialize_share) *
+					static_cast<float>(offset + length) / static_cast<float>(data.size());
+			}
+
+			stream.flush();
+
+			if (!stream) {
+				stream.close();
+				std::remove(temp_path.c_str());
+
+				m_error = "failed to write file " + temp_path;
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temp_path, path, error);
+
+		if (error) {
+			std::remove(temp_path.c_str());
+
+			m_error = "failed to replace " + path + ": " + error.message();
+			return false;
+		}
+
+		return true;
+	}
+}
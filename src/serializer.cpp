@@ -1,6 +1,12 @@
 #include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <optional>
+#include <thread>
+#include <algorithm>
 
 #include "serializer.hpp"
+#include "binscene.hpp"
 #include "object.hpp"
 #include "cube.hpp"
 #include "point.hpp"
@@ -38,7 +44,16 @@ namespace mini {
 	scene_serializer::scene_serializer () { }
 	scene_serializer::~scene_serializer () { }
 
-	std::string scene_serializer::get_data () {
+	// progress is reported in steps, not for every object
+	constexpr std::size_t snapshot_progress_step = 4096;
+
+	std::size_t scene_snapshot::get_num_objects () const {
+		return m_points.size () + m_geometry.size ();
+	}
+
+	std::string scene_snapshot::get_data (const progress_callback_t & progress) const {
+		const float total = static_cast<float> (std::max<std::size_t> (get_num_objects (), 1));
+		std::size_t done = 0;
 		json scene;
 
 		{
@@ -47,10 +62,14 @@ namespace mini {
 				json point_s;
 				
 				point_s["id"] = point.id;
-				point_s["name"] = point.object->get_name ();
-				point_s["position"] = s_serialize_data (point.object->get_translation ());
+				point_s["name"] = point.name;
+				point_s["position"] = s_serialize_data (point.position);
 
 				points.push_back (point_s);
+
+				if (progress && ++done % snapshot_progress_step == 0) {
+					progress (done / total);
+				}
 			}
 
 			scene["points"] = std::move (points);
@@ -58,9 +77,12 @@ namespace mini {
 
 		{
 			json geometry;
-			for (auto & object : m_geometry) {
-				const auto & serializer = object.object->get_serializer ();
-				geometry.push_back (serializer.serialize (object.id, object.object, m_cache));
+			for (const auto & object : m_geometry) {
+				geometry.push_back (object);
+
+				if (progress && ++done % snapshot_progress_step == 0) {
+					progress (done / total);
+				}
 			}
 
 			scene["geometry"] = std::move (geometry);
@@ -69,9 +91,72 @@ namespace mini {
 		std::stringstream ss;
 		ss << scene;
 
+		if (progress) {
+			progress (1.0f);
+		}
+
 		return ss.str ();
 	}
 
+	std::string scene_snapshot::get_binary_data (const progress_callback_t & progress) const {
+		const float total = static_cast<float> (std::max<std::size_t> (get_num_objects (), 1));
+		std::size_t done = 0;
+
+		binary_scene_writer writer;
+		writer.reserve_points (m_points.size ());
+
+		// points skip json altogether, they are most of the scene
+		for (const auto & point : m_points) {
+			writer.add_point (point.id, point.position, point.name);
+
+			if (progress && ++done % snapshot_progress_step == 0) {
+				progress (done / total);
+			}
+		}
+
+		for (const auto & object : m_geometry) {
+			writer.add_object (object);
+
+			if (progress && ++done % snapshot_progress_step == 0) {
+				progress (done / total);
+			}
+		}
+
+		auto data = writer.get_data ();
+
+		if (progress) {
+			progress (1.0f);
+		}
+
+		return data;
+	}
+
+	std::string scene_serializer::get_data () {
+		return get_snapshot ().get_data ();
+	}
+
+	std::string scene_serializer::get_binary_data () {
+		return get_snapshot ().get_binary_data ();
+	}
+
+	scene_snapshot scene_serializer::get_snapshot () {
+		scene_snapshot snapshot;
+
+		// points are copied as they are, objects keep only what they serialize to
+		snapshot.m_points.reserve (m_points.size ());
+		for (const auto & point : m_points) {
+			snapshot.m_points.push_back ({ point.id, point.object->get_translation (), point.object->get_name () });
+		}
+
+		snapshot.m_geometry.reserve (m_geometry.size ());
+		for (auto & object : m_geometry) {
+			const auto & serializer = object.object->get_serializer ();
+			snapshot.m_geometry.push_back (serializer.serialize (object.id, object.object, m_cache));
+		}
+
+		return snapshot;
+	}
+
 	bool scene_serializer::add_object (std::shared_ptr<scene_obj_t> object) {
 		scene_serializer_node node;
 
@@ -87,6 +172,13 @@ namespace mini {
 		return true;
 	}
 
+	cache_object_id_t scene_serializer::take_cache () {
+		cache_object_id_t cache = std::move (m_cache);
+
+		reset ();
+		return cache;
+	}
+
 	void scene_serializer::reset () {
 		m_cache.clear ();
 		m_geometry.clear ();
@@ -307,11 +399,206 @@ namespace mini {
 		return c;
 	}
 
+	// the smallest a serialized point can be, used to reserve the point records
+	constexpr std::size_t min_point_bytes = 64;
+
+	// receives parser events for a whole scene file, points are written straight into
+	// records and every geometry object is built into its own small document that is
+	// handed to the workers as soon as it is closed
+	class scene_deserializer::sax_handler final : public json::json_sax_t {
+		private:
+			enum class section_t {
+				none,
+				points,
+				geometry
+			};
+
+			scene_deserializer & m_deserializer;
+			std::vector<point_record_t> & m_points;
+
+			section_t m_section;
+			std::size_t m_depth;
+
+			// keys of the top level, the point and the point position
+			std::string m_keys[3];
+			point_record_t m_point;
+
+			// geometry object that is currently parsed
+			json m_object;
+			std::string m_object_key;
+			std::vector<json *> m_stack;
+
+		public:
+			sax_handler (scene_deserializer & deserializer, std::vector<point_record_t> & points) :
+				m_deserializer (deserializer), m_points (points) {
+
+				m_section = section_t::none;
+				m_depth = 0;
+			}
+
+			bool null () override {
+				return m_value (json (nullptr));
+			}
+
+			bool boolean (bool value) override {
+				return m_value (json (value));
+			}
+
+			bool number_integer (number_integer_t value) override {
+				m_point_number (static_cast<double> (value));
+				return m_value (json (value));
+			}
+
+			bool number_unsigned (number_unsigned_t value) override {
+				m_point_number (static_cast<double> (value));
+				return m_value (json (value));
+			}
+
+			bool number_float (number_float_t value, const string_t & text) override {
+				m_point_number (static_cast<double> (value));
+				return m_value (json (value));
+			}
+
+			bool string (string_t & value) override {
+				if (m_section == section_t::points && m_depth == 3 && m_keys[1] == "name") {
+					m_point.name = value;
+				}
+
+				return m_value (json (std::move (value)));
+			}
+
+			bool binary (binary_t & value) override {
+				return m_value (json (std::move (value)));
+			}
+
+			bool start_object (std::size_t size) override {
+				if (m_is_building () || (m_section == section_t::geometry && m_depth == 2)) {
+					m_stack.push_back (m_add (json::object ()));
+				} else if (m_section == section_t::points && m_depth == 2) {
+					m_point = { -1, glm::vec3 (0.0f), "point" };
+					m_keys[1].clear ();
+				}
+
+				m_depth++;
+				return true;
+			}
+
+			bool key (string_t & value) override {
+				if (m_is_building ()) {
+					m_object_key = std::move (value);
+				} else if (m_depth >= 1 && m_depth <= 4) {
+					// depth two is the points array itself and has no keys
+					m_keys[m_depth == 1 ? 0 : m_depth - 2] = std::move (value);
+				}
+
+				return true;
+			}
+
+			bool end_object () override {
+				m_depth--;
+
+				if (m_is_building ()) {
+					m_stack.pop_back ();
+
+					if (m_stack.empty ()) {
+						m_deserializer.m_push_job (std::move (m_object));
+						m_object = json ();
+					}
+				} else if (m_section == section_t::points && m_depth == 2) {
+					m_points.push_back (std::move (m_point));
+				}
+
+				return true;
+			}
+
+			bool start_array (std::size_t size) override {
+				if (m_is_building ()) {
+					m_stack.push_back (m_add (json::array ()));
+				} else if (m_depth == 1) {
+					if (m_keys[0] == "points") {
+						m_section = section_t::points;
+					} else if (m_keys[0] == "geometry") {
+						m_section = section_t::geometry;
+					}
+				}
+
+				m_depth++;
+				return true;
+			}
+
+			bool end_array () override {
+				m_depth--;
+
+				if (m_is_building ()) {
+					m_stack.pop_back ();
+				} else if (m_depth == 1) {
+					m_section = section_t::none;
+				}
+
+				return true;
+			}
+
+			bool parse_error (std::size_t position, const std::string & token, const nlohmann::detail::exception & error) override {
+				throw std::runtime_error (std::string ("failed to parse scene: ") + error.what ());
+			}
+
+		private:
+			bool m_is_building () const {
+				return !m_stack.empty ();
+			}
+
+			void m_point_number (double value) {
+				if (m_section != section_t::points) {
+					return;
+				}
+
+				if (m_depth == 3 && m_keys[1] == "id") {
+					m_point.id = static_cast<int> (value);
+				} else if (m_depth == 4 && m_keys[1] == "position") {
+					if (m_keys[2] == "x") {
+						m_point.position.x = static_cast<float> (value);
+					} else if (m_keys[2] == "y") {
+						m_point.position.y = static_cast<float> (value);
+					} else if (m_keys[2] == "z") {
+						m_point.position.z = static_cast<float> (value);
+					}
+				}
+			}
+
+			bool m_value (json && value) {
+				if (m_is_building ()) {
+					m_add (std::move (value));
+				}
+
+				return true;
+			}
+
+			json * m_add (json && value) {
+				if (m_stack.empty ()) {
+					m_object = std::move (value);
+					return &m_object;
+				}
+
+				// only the innermost open container changes so the pointers stay valid
+				json * parent = m_stack.back ();
+				if (parent->is_array ()) {
+					parent->push_back (std::move (value));
+					return &parent->back ();
+				}
+
+				json & slot = (*parent)[m_object_key];
+				slot = std::move (value);
+				return &slot;
+			}
+	};
+
 	scene_deserializer::scene_deserializer (scene_controller_base & scene, std::shared_ptr<resource_store> store) : 
 		m_scene (scene) {
 
 		m_store = store;
 		m_ready = false;
+		m_next_job = 0;
+		m_parse_done = false;
 		m_init_deserializers ();
 	}
 
@@ -320,6 +607,8 @@ namespace mini {
 
 		m_store = store;
 		m_ready = false;
+		m_next_job = 0;
+		m_parse_done = false;
 		m_init_deserializers ();
 		load (data);
 	}
@@ -337,14 +626,20 @@ namespace mini {
 	}
 
 	void scene_deserializer::load (const std::string & data) {
-		json j = json::parse (data);
+		load_json (json::parse (data));
+	}
 
-		for (const auto & point : j["points"]) {
-			m_deserialize_point (point);
+	void scene_deserializer::load_json (const json & scene) {
+		if (scene.contains ("points")) {
+			for (const auto & point : scene["points"]) {
+				m_deserialize_point (point);
+			}
 		}
 
-		for (const auto & geometry : j["geometry"]) {
-			m_deserialize_object (geometry);
+		if (scene.contains ("geometry")) {
+			for (const auto & geometry : scene["geometry"]) {
+				m_deserialize_object (geometry);
+			}
 		}
 
 		std::sort (m_objects.begin (), m_objects.end (), [](const object_deque_item & a, const object_deque_item & b) {
@@ -352,6 +647,92 @@ namespace mini {
 		});
 	}
 
+	void scene_deserializer::load_file (const std::string & path) {
+		if (binary_scene_reader::is_binary_scene (path)) {
+			load_binary (path);
+			return;
+		}
+
+		std::ifstream stream (path, std::ios::binary);
+		if (!stream) {
+			throw std::runtime_error ("failed to open file " + path);
+		}
+
+		// an upper bound, pages that are never written are never committed either
+		std::vector<point_record_t> points;
+		std::error_code error;
+		const auto file_size = std::filesystem::file_size (path, error);
+
+		if (!error) {
+			points.reserve (static_cast<std::size_t> (file_size) / min_point_bytes);
+		}
+
+		m_jobs.clear ();
+		m_next_job = 0;
+		m_parse_done = false;
+
+		const unsigned int num_workers = std::max (2U, std::thread::hardware_concurrency ()) - 1;
+		std::vector<std::thread> workers;
+
+		workers.reserve (num_workers);
+		for (unsigned int i = 0; i < num_workers; ++i) {
+			workers.emplace_back (&scene_deserializer::m_prepare_worker, this);
+		}
+
+		const auto stop_workers = [this, &workers] () {
+			{
+				std::lock_guard<std::mutex> lock (m_jobs_mutex);
+				m_parse_done = true;
+			}
+
+			m_jobs_cond.notify_all ();
+
+			for (auto & worker : workers) {
+				worker.join ();
+			}
+		};
+
+		try {
+			sax_handler handler (*this, points);
+			json::sax_parse (stream, &handler);
+		} catch (...) {
+			stop_workers ();
+			m_jobs.clear ();
+			throw;
+		}
+
+		stop_workers ();
+
+		// everything below creates opengl resources and has to stay on this thread
+		for (const auto & point : points) {
+			m_add_point (point.id, point.name, point.position);
+		}
+
+		points.clear ();
+		points.shrink_to_fit ();
+
+		for (auto & job : m_jobs) {
+			if (!job.error.empty ()) {
+				const std::string message = job.error;
+				m_jobs.clear ();
+
+				throw std::runtime_error (message);
+			}
+
+			if (job.builder) {
+				m_add_object (job.id, job.builder);
+			}
+
+			job.builder = nullptr;
+		}
+
+		m_jobs.clear ();
+
+		std::sort (m_objects.begin (), m_objects.end (), [](const object_deque_item & a, const object_deque_item & b) {
+			return a.id < b.id;
+		});
+	}
+
 	void scene_deserializer::reset () {
 		m_objects.clear ();
 		m_cache.clear ();
@@ -381,8 +762,26 @@ namespace mini {
 	void scene_deserializer::m_deserialize_point (const json & data) {
 		int id = data["id"].get<int> ();
 
+		if (data.find ("name") != data.end ()) {
+			m_add_point (id, data["name"].get<std::string> (), s_deserialize_vector (data["position"]));
+		} else {
+			m_add_point (id, "point", s_deserialize_vector (data["position"]));
+		}
+	}
+
+	void scene_deserializer::m_deserialize_object (const json & data) {
+		std::string type = data["objectType"].get<std::string> ();
+		int id = data["id"].get<int> ();
+
+		auto deserializer = m_deserializers.find (type);
+		if (deserializer != m_deserializers.end ()) {
+			m_add_object (id, deserializer->second->prepare (data));
+		}
+	}
+
+	void scene_deserializer::m_add_point (int id, const std::string & name, const glm::vec3 & position) {
 		if (m_cache.find (id) != m_cache.end ()) {
-			throw std::runtime_error ("duplicate object id " + id);
+			throw std::runtime_error ("duplicate object id " + std::to_string (id));
 		}
 
 		auto point = std::make_shared<point_object> (
@@ -391,13 +790,8 @@ namespace mini {
 			m_store->get_point_texture ()
 		);
 
-		if (data.find ("name") != data.end ()) {
-			point->set_name (data["name"].get<std::string> ());
-		} else {
-			point->set_name ("point");
-		}
-		
-		point->set_translation (s_deserialize_vector (data["position"]));
+		point->set_name (name);
+		point->set_translation (position);
 
 		// if id < 0 then it will not be ever referenced
 		if (id >= 0) {
@@ -407,337 +801,465 @@ namespace mini {
 		m_objects.push_back ({ id, point });
 	}
 
-	void scene_deserializer::m_deserialize_object (const json & data) {
-		std::string type = data["objectType"].get<std::string> ();
-		int id = data["id"].get<int> ();
-
+	void scene_deserializer::m_add_object (int id, const object_builder_t & builder) {
 		if (m_cache.find (id) != m_cache.end ()) {
-			throw std::runtime_error ("duplicate object id " + id);
+			throw std::runtime_error ("duplicate object id " + std::to_string (id));
 		}
 
-		auto deserializer = m_deserializers.find (type);
-		if (deserializer != m_deserializers.end ()) {
-			auto object = deserializer->second->deserialize (m_scene, m_store, data, m_cache);
+		auto object = builder (m_scene, m_store, m_cache);
 
-			if (object) {
-				m_cache.insert ({ id, object });
-				m_objects.push_back ({ id, object });
-			}
+		if (object) {
+			m_cache.insert ({ id, object });
+			m_objects.push_back ({ id, object });
 		}
 	}
 
-	inline void s_deserialize_transform (scene_obj_t & obj, const json & data) {
-		if (obj.is_movable ()) {
-			obj.set_translation (s_deserialize_vector (data["position"]));
-		}
-
-		if (obj.is_scalable ()) {
-			obj.set_scale (s_deserialize_vector (data["scale"]));
+	void scene_deserializer::m_push_job (json && data) {
+		{
+			std::lock_guard<std::mutex> lock (m_jobs_mutex);
+			m_jobs.push_back ({ std::move (data), 0, nullptr, std::string () });
 		}
 
-		if (obj.is_rotatable ()) {
-			obj.set_euler_angles (s_deserialize_vector (data["rotation"]));
-		}
+		m_jobs_cond.notify_one ();
 	}
 
-	inline void s_deserialize_point_list (scene_controller_base & scene, std::shared_ptr<resource_store> store,
-		const json & data, const cache_id_object_t & cache, point_list & points) {
-		
-		if (!data.is_array ()) {
-			throw std::runtime_error ("cannot deserialize point list from non-array json data");
-		}
+	void scene_deserializer::m_prepare_worker () {
+		while (true) {
+			load_job_t * job;
 
-		points.reserve (data.size ());
-
-		for (const auto & el : data) {
-			int id = el["id"].get<int> ();
-			auto it = cache.find (id);
+			{
+				std::unique_lock<std::mutex> lock (m_jobs_mutex);
+				m_jobs_cond.wait (lock, [this] () {
+					return m_next_job < m_jobs.size () || m_parse_done;
+				});
 
-			if (it == cache.end ()) {
-				throw std::runtime_error ("failed to deserialize point " + id);
-			}
-
-			auto object_ptr = it->second;
-			auto point_ptr = std::dynamic_pointer_cast<point_object> (object_ptr);
+				if (m_next_job >= m_jobs.size ()) {
+					return;
+				}
 
-			if (!point_ptr) {
-				throw std::runtime_error ("object id " + std::to_string (id) + " does not refer to a point");
+				job = &m_jobs[m_next_job++];
 			}
 
-			points.push_back (point_ptr);
+			m_prepare_job (*job);
 		}
 	}
 
-	DESERIALIZER (point_object) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
-		const json & data, cache_id_object_t & cache) const {
+	void scene_deserializer::m_prepare_job (load_job_t & job) const {
+		try {
+			const std::string type = job.data["objectType"].get<std::string> ();
+			job.id = job.data["id"].get<int> ();
 
-		auto point = std::make_shared<point_object> (
-			scene,
-			store->get_billboard_s_shader (),
-			store->get_point_texture ()
-		);
+			// unknown objects are skipped like in a regular load
+			auto deserializer = m_deserializers.find (type);
+			if (deserializer != m_deserializers.end ()) {
+				job.builder = deserializer->second->prepare (job.data);
+			}
+		} catch (const std::exception & error) {
+			job.error = error.what ();
+		}
 
-		point->set_name (data["name"].get<std::string> ());
-		s_deserialize_transform (*point, data);
-		return point;
+		job.data = json ();
 	}
 
-	DESERIALIZER (torus_object) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
-		const json & data, cache_id_object_t & cache) const {
+	// transform read ahead of creating the object, missing parts are left alone
+	struct transform_data_t {
+		std::optional<glm::vec3> position, scale, rotation;
+	};
 
-		unsigned int div_u = data["samples"]["x"].get<unsigned int> ();
-		unsigned int div_v = data["samples"]["y"].get<unsigned int> ();
+	inline transform_data_t s_read_transform (const json & data) {
+		transform_data_t transform;
 
-		float small_r = data["smallRadius"].get<float> ();
-		float large_r = data["largeRadius"].get<float> ();
-		
-		auto torus = std::make_shared<torus_object> (
-			scene,
-			store->get_mesh_shader (),
-			small_r, large_r
-		);
+		if (data.contains ("position")) {
+			transform.position = s_deserialize_vector (data["position"]);
+		}
 
-		torus->set_name (data["name"].get<std::string>());
-		torus->set_div_u (div_u);
-		torus->set_div_v (div_v);
+		if (data.contains ("scale")) {
+			transform.scale = s_deserialize_vector (data["scale"]);
+		}
+
+		if (data.contains ("rotation")) {
+			transform.rotation = s_deserialize_vector (data["rotation"]);
+		}
 
-		s_deserialize_transform (*torus, data);
-		return torus;
+		return transform;
 	}
 
-	DESERIALIZER (cube_object) (scene_controller_base & scene, std::shared_ptr<resource_store> store, 
-		const json & data, cache_id_object_t & cache) const {
+	inline void s_apply_transform (scene_obj_t & obj, const transform_data_t & transform) {
+		if (obj.is_movable () && transform.position) {
+			obj.set_translation (*transform.position);
+		}
 
-		auto cube = std::make_shared<cube_object> (
-			scene,
-			store->get_basic_shader ()
-		);
+		if (obj.is_scalable () && transform.scale) {
+			obj.set_scale (*transform.scale);
+		}
 
-		cube->set_name (data["name"].get<std::string> ());
-		s_deserialize_transform (*cube, data);
-		return cube;
+		if (obj.is_rotatable () && transform.rotation) {
+			obj.set_euler_angles (*transform.rotation);
+		}
 	}
 
-	DESERIALIZER (bezier_curve_c0) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
-		const json & data, cache_id_object_t & cache) const {
+	inline std::vector<int> s_read_point_ids (const json & data) {
+		if (!data.is_array ()) {
+			throw std::runtime_error ("cannot deserialize point list from non-array json data");
+		}
 
-		point_list control_points;
-		s_deserialize_point_list (scene, store, data["controlPoints"], cache, control_points);
+		std::vector<int> ids;
+		ids.reserve (data.size ());
 
-		auto curve = std::make_shared<bezier_curve_c0> (
-			scene,
-			store->get_bezier_shader (),
-			store->get_line_shader (),
-			control_points
-		);
+		for (const auto & el : data) {
+			ids.push_back (el["id"].get<int> ());
+		}
 
-		curve->set_name (data["name"].get<std::string> ());
-		return curve;
+		return ids;
 	}
 
-	DESERIALIZER (bspline_curve) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
-		const json & data, cache_id_object_t & cache) const {
-
-		point_list control_points;
-		s_deserialize_point_list (scene, store, data["controlPoints"], cache, control_points);
+	inline void s_resolve_point_list (const std::vector<int> & ids, const cache_id_object_t & cache, point_list & points) {
+		points.reserve (points.size () + ids.size ());
 
-		auto curve = std::make_shared<bspline_curve> (
-			scene,
-			store->get_bezier_shader (),
-			store->get_line_shader (),
-			store->get_billboard_s_shader (),
-			store->get_point_texture (),
-			control_points
-		);
-
-		curve->set_name (data["name"].get<std::string> ());
-		return curve;
-	}
+		for (const auto id : ids) {
+			auto it = cache.find (id);
 
-	DESERIALIZER (interpolating_curve) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
-		const json & data, cache_id_object_t & cache) const {
+			if (it == cache.end ()) {
+				throw std::runtime_error ("failed to deserialize point " + std::to_string (id));
+			}
 
-		point_list control_points;
-		s_deserialize_point_list (scene, store, data["controlPoints"], cache, control_points);
+			auto point_ptr = std::dynamic_pointer_cast<point_object> (it->second);
 
-		auto curve = std::make_shared<interpolating_curve> (
-			scene,
-			store->get_bezier_shader (),
-			store->get_line_shader (),
-			control_points
-		);
+			if (!point_ptr) {
+				throw std::runtime_error ("object id " + std::to_string (id) + " does not refer to a point");
+			}
 
-		curve->set_name (data["name"].get<std::string> ());
-		return curve;
+			points.push_back (point_ptr);
+		}
 	}
 
-	DESERIALIZER (bezier_surface_c0) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
-		const json & data, cache_id_object_t & cache) const {
-
-		// this is going to be complicated :)
-		point_list control_points;
+	// everything needed to build a surface, the topology indexes the point ids
+	struct surface_data_t {
+		std::string name;
+		unsigned int patches_x, patches_y;
+		bool u_wrapped, v_wrapped;
 
-		std::map<int, GLuint> id_map;
+		std::vector<int> point_ids;
 		std::vector<GLuint> topology;
+	};
+
+	inline surface_data_t s_read_surface (const json & data, const std::string & patch_type, const std::string & label) {
+		surface_data_t surface;
 
-		unsigned int patches_x = data["size"]["x"];
-		unsigned int patches_y = data["size"]["y"];
+		surface.name = data["name"].get<std::string> ();
+		surface.patches_x = data["size"]["x"];
+		surface.patches_y = data["size"]["y"];
 
-		bool u_wrapped = false;
-		bool v_wrapped = false;
+		surface.u_wrapped = false;
+		surface.v_wrapped = false;
 
 		if (data.contains("parameterWrapped")) {
-			auto parameterWrapped = data["parameterWrapped"];
+			const auto & parameterWrapped = data["parameterWrapped"];
 
 			if (parameterWrapped.contains("u")) {
-				u_wrapped = parameterWrapped["u"].get<bool>();
+				surface.u_wrapped = parameterWrapped["u"].get<bool>();
 			}
 
 			if (parameterWrapped.contains("v")) {
-				v_wrapped = parameterWrapped["v"].get<bool>();
+				surface.v_wrapped = parameterWrapped["v"].get<bool>();
 			}
 		}
 
-		control_points.reserve (patches_x * patches_y * 3 + patches_y * 3 + patches_x * 3 + 1);
+		surface.point_ids.reserve (data["patches"].size () * 16);
+		surface.topology.reserve (data["patches"].size () * 16);
+
 		for (const auto & patch : data["patches"]) {
-			std::array<GLuint, 16> patch_topology;
 			auto type = patch["objectType"].get<std::string> ();
 
-			if (type != "bezierPatchC0") {
+			if (type != patch_type) {
 				throw std::runtime_error ("invalid patch type " + type + " for surface");
 			}
 
 			int patch_index = 0;
 			for (const auto & point_s : patch["controlPoints"]) {
-				int id = point_s["id"].get<int> ();
-
-				/*auto iter_id_map = id_map.find(id);
-				if (iter_id_map != id_map.end ()) {
-					patch_topology[patch_index] = iter_id_map->second;
-					patch_index++;
-					continue;
-				}*/
-
-				// point was not yet indexed, add it to the index
-				auto iter_cache = cache.find (id);
-				if (iter_cache == cache.end ()) {
-					throw std::runtime_error ("failed to deserialize point " + id);
-				}
-
-				auto point = std::dynamic_pointer_cast<point_object> (iter_cache->second);
-				if (!point) {
-					throw std::runtime_error ("object id " + std::to_string (id) + " does not refer to a point");
-				}
-
-				control_points.push_back (point);
-				GLuint point_index = static_cast<GLuint> (control_points.size () - 1);
-
-				patch_topology[patch_index] = point_index;
+				// every patch references its own copy of the point, shared points
+				// are merged by the surface itself
+				surface.point_ids.push_back (point_s["id"].get<int> ());
+				surface.topology.push_back (static_cast<GLuint> (surface.point_ids.size () - 1));
 				patch_index++;
-
-				id_map.insert ({ id, point_index });
 			}
 
 			if (patch_index != 16) {
-				throw std::runtime_error ("incorrect number of control points for c0 surface patch: " + patch_index);
+				throw std::runtime_error ("incorrect number of control points for " + label + " surface patch: " + 
+					std::to_string (patch_index));
 			}
-
-			topology.insert (topology.end (), patch_topology.begin (), patch_topology.end ());
 		}
 
-		auto patch = std::make_shared<bezier_surface_c0> (
-			scene,
-			store->get_bezier_surf_shader (),
-			store->get_bezier_surf_solid_shader (),
-			store->get_line_shader (),
-			patches_x, patches_y, control_points, topology, u_wrapped, v_wrapped);
+		return surface;
+	}
 
-		patch->set_name (data["name"].get<std::string> ());
-		return patch;
+#define PREPARE(T) template<> object_builder_t generic_object_deserializer<T>::prepare
+
+	PREPARE (point_object) (const json & data) const {
+		auto name = data["name"].get<std::string> ();
+		auto transform = s_read_transform (data);
+
+		return [name, transform] (scene_controller_base & scene, std::shared_ptr<resource_store> store, cache_id_object_t & cache) {
+			auto point = std::make_shared<point_object> (
+				scene,
+				store->get_billboard_s_shader (),
+				store->get_point_texture ()
+			);
+
+			point->set_name (name);
+			s_apply_transform (*point, transform);
+			return std::static_pointer_cast<scene_obj_t> (point);
+		};
 	}
 
-	DESERIALIZER (bspline_surface) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
-		const json & data, cache_id_object_t & cache) const {
+	PREPARE (torus_object) (const json & data) const {
+		unsigned int div_u = data["samples"]["x"].get<unsigned int> ();
+		unsigned int div_v = data["samples"]["y"].get<unsigned int> ();
+
+		float small_r = data["smallRadius"].get<float> ();
+		float large_r = data["largeRadius"].get<float> ();
 
-		point_list control_points;
+		auto name = data["name"].get<std::string> ();
+		auto transform = s_read_transform (data);
 
-		std::map<int, GLuint> id_map;
-		std::vector<GLuint> topology;
+		return [=] (scene_controller_base & scene, std::shared_ptr<resource_store> store, cache_id_object_t & cache) {
+			auto torus = std::make_shared<torus_object> (
+				scene,
+				store->get_mesh_shader (),
+				small_r, large_r
+			);
 
-		unsigned int patches_x = data["size"]["x"];
-		unsigned int patches_y = data["size"]["y"];
+			torus->set_name (name);
+			torus->set_div_u (div_u);
+			torus->set_div_v (div_v);
 
-		bool u_wrapped = false;
-		bool v_wrapped = false;
+			s_apply_transform (*torus, transform);
+			return std::static_pointer_cast<scene_obj_t> (torus);
+		};
+	}
 
-		if (data.contains("parameterWrapped")) {
-			auto parameterWrapped = data["parameterWrapped"];
+	PREPARE (cube_object) (const json & data) const {
+		auto name = data["name"].get<std::string> ();
+		auto transform = s_read_transform (data);
 
-			if (parameterWrapped.contains("u")) {
-				u_wrapped = parameterWrapped["u"].get<bool>();
-			}
+		return [name, transform] (scene_controller_base & scene, std::shared_ptr<resource_store> store, cache_id_object_t & cache) {
+			auto cube = std::make_shared<cube_object> (
+				scene,
+				store->get_basic_shader ()
+			);
 
-			if (parameterWrapped.contains("v")) {
-				v_wrapped = parameterWrapped["v"].get<bool>();
+			cube->set_name (name);
+			s_apply_transform (*cube, transform);
+			return std::static_pointer_cast<scene_obj_t> (cube);
+		};
+	}
+
+	PREPARE (bezier_curve_c0) (const json & data) const {
+		auto name = data["name"].get<std::string> ();
+		auto ids = s_read_point_ids (data["controlPoints"]);
+
+		return [name, ids] (scene_controller_base & scene, std::shared_ptr<resource_store> store, cache_id_object_t & cache) {
+			point_list control_points;
+			s_resolve_point_list (ids, cache, control_points);
+
+			auto curve = std::make_shared<bezier_curve_c0> (
+				scene,
+				store->get_bezier_shader (),
+				store->get_line_shader (),
+				control_points
+			);
+
+			curve->set_name (name);
+			return std::static_pointer_cast<scene_obj_t> (curve);
+		};
+	}
+
+	PREPARE (bspline_curve) (const json & data) const {
+		auto name = data["name"].get<std::string> ();
+		auto ids = s_read_point_ids (data["controlPoints"]);
+
+		return [name, ids] (scene_controller_base & scene, std::shared_ptr<resource_store> store, cache_id_object_t & cache) {
+			point_list control_points;
+			s_resolve_point_list (ids, cache, control_points);
+
+			auto curve = std::make_shared<bspline_curve> (
+				scene,
+				store->get_bezier_shader (),
+				store->get_line_shader (),
+				store->get_billboard_s_shader (),
+				store->get_point_texture (),
+				control_points
+			);
+
+			curve->set_name (name);
+			return std::static_pointer_cast<scene_obj_t> (curve);
+		};
+	}
+
+	PREPARE (interpolating_curve) (const json & data) const {
+		auto name = data["name"].get<std::string> ();
+		auto ids = s_read_point_ids (data["controlPoints"]);
+
+		return [name, ids] (scene_controller_base & scene, std::shared_ptr<resource_store> store, cache_id_object_t & cache) {
+			point_list control_points;
+			s_resolve_point_list (ids, cache, control_points);
+
+			auto curve = std::make_shared<interpolating_curve> (
+				scene,
+				store->get_bezier_shader (),
+				store->get_line_shader (),
+				control_points
+			);
+
+			curve->set_name (name);
+			return std::static_pointer_cast<scene_obj_t> (curve);
+		};
+	}
+
+	static object_builder_t s_bezier_surface_builder (std::shared_ptr<surface_data_t> surface) {
+		return [surface] (scene_controller_base & scene, std::shared_ptr<resource_store> store, cache_id_object_t & cache) {
+			point_list control_points;
+			s_resolve_point_list (surface->point_ids, cache, control_points);
+
+			auto patch = std::make_shared<bezier_surface_c0> (
+				scene,
+				store->get_bezier_surf_shader (),
+				store->get_bezier_surf_solid_shader (),
+				store->get_line_shader (),
+				surface->patches_x, surface->patches_y, control_points, surface->topology, 
+				surface->u_wrapped, surface->v_wrapped);
+
+			patch->set_name (surface->name);
+			return std::static_pointer_cast<scene_obj_t> (patch);
+		};
+	}
+
+	static object_builder_t s_bspline_surface_builder (std::shared_ptr<surface_data_t> surface) {
+		return [surface] (scene_controller_base & scene, std::shared_ptr<resource_store> store, cache_id_object_t & cache) {
+			point_list control_points;
+			s_resolve_point_list (surface->point_ids, cache, control_points);
+
+			auto patch = std::make_shared<bspline_surface> (
+				scene,
+				store->get_bspline_surf_shader (),
+				store->get_bspline_surf_solid_shader (),
+				store->get_line_shader (),
+				surface->patches_x, surface->patches_y, control_points, surface->topology, 
+				surface->u_wrapped, surface->v_wrapped);
+
+			patch->set_name (surface->name);
+			return std::static_pointer_cast<scene_obj_t> (patch);
+		};
+	}
+
+	PREPARE (bezier_surface_c0) (const json & data) const {
+		return s_bezier_surface_builder (std::make_shared<surface_data_t> (s_read_surface (data, "bezierPatchC0", "c0")));
+	}
+
+	PREPARE (bspline_surface) (const json & data) const {
+		return s_bspline_surface_builder (std::make_shared<surface_data_t> (s_read_surface (data, "bezierPatchC2", "c2")));
+	}
+
+	void scene_deserializer::load_binary (const std::string & path) {
+		binary_scene_reader reader;
+		reader.open (path);
+
+		// the point table is used in place, only names are copied out
+		for (std::size_t i = 0; i < reader.get_num_points (); ++i) {
+			const auto & point = reader.get_point (i);
+			const glm::vec3 position = { point.position[0], point.position[1], point.position[2] };
+
+			if (reader.has_string (point.name)) {
+				m_add_point (point.id, std::string (reader.get_string (point.name)), position);
+			} else {
+				m_add_point (point.id, "point", position);
 			}
 		}
 
-		control_points.reserve ((3 + patches_x) * (3 + patches_y));
-		for (const auto & patch : data["patches"]) {
-			std::array<GLuint, 16> patch_topology;
-			auto type = patch["objectType"].get<std::string> ();
+		for (std::size_t i = 0; i < reader.get_num_objects (); ++i) {
+			const auto & object = reader.get_object (i);
 
-			if (type != "bezierPatchC2") {
-				throw std::runtime_error ("invalid patch type " + type + " for surface");
+			if (object.kind != binary_object_surface) {
+				m_deserialize_object (reader.get_object_json (i));
+				continue;
 			}
 
-			int patch_index = 0;
-			for (const auto & point_s : patch["controlPoints"]) {
-				int id = point_s["id"].get<int> ();
-
-				/*auto iter_id_map = id_map.find(id);
-				if (iter_id_map != id_map.end ()) {
-					patch_topology[patch_index] = iter_id_map->second;
-					patch_index++;
-					continue;
-				}*/
-
-				// point was not yet indexed, add it to the index
-				auto iter_cache = cache.find (id);
-				if (iter_cache == cache.end ()) {
-					throw std::runtime_error ("failed to deserialize point " + id);
-				}
+			const auto & record = reader.get_surface (object.index);
+			const auto type = reader.get_string (record.type);
+			const auto patch_type = (type == "bezierSurfaceC0") ? "bezierPatchC0" : "bezierPatchC2";
 
-				auto point = std::dynamic_pointer_cast<point_object> (iter_cache->second);
-				if (!point) {
-					throw std::runtime_error ("object id " + std::to_string (id) + " does not refer to a point");
-				}
+			auto surface = std::make_shared<surface_data_t> ();
 
-				control_points.push_back (point);
-				GLuint point_index = static_cast<GLuint> (control_points.size () - 1);
+			surface->name = reader.has_string (record.name) ? std::string (reader.get_string (record.name)) : std::string ();
+			surface->patches_x = record.patches_x;
+			surface->patches_y = record.patches_y;
+			surface->u_wrapped = (record.flags & binary_surface_u_wrapped) != 0;
+			surface->v_wrapped = (record.flags & binary_surface_v_wrapped) != 0;
 
-				patch_topology[patch_index] = point_index;
-				patch_index++;
+			surface->point_ids.reserve (record.num_patches * 16);
+			surface->topology.reserve (record.num_patches * 16);
 
-				id_map.insert ({ id, point_index });
-			}
+			for (uint32_t p = 0; p < record.num_patches; ++p) {
+				const auto & patch = reader.get_patch (record.first_patch + p);
 
-			if (patch_index != 16) {
-				throw std::runtime_error ("incorrect number of control points for c2 surface patch: " + patch_index);
+				if (!reader.has_string (patch.type) || reader.get_string (patch.type) != patch_type) {
+					throw std::runtime_error ("invalid patch type for surface");
+				}
+
+				for (const auto id : patch.points) {
+					surface->point_ids.push_back (id);
+					surface->topology.push_back (static_cast<GLuint> (surface->point_ids.size () - 1));
+				}
 			}
 
-			topology.insert (topology.end (), patch_topology.begin (), patch_topology.end ());
+			m_add_object (record.id, (type == "bezierSurfaceC0") ? 
+				s_bezier_surface_builder (surface) : s_bspline_surface_builder (surface));
 		}
 
-		auto patch = std::make_shared<bspline_surface> (
-			scene,
-			store->get_bspline_surf_shader (),
-			store->get_bspline_surf_solid_shader (),
-			store->get_line_shader (),
-			patches_x, patches_y, control_points, topology, u_wrapped, v_wrapped);
+		std::sort (m_objects.begin (), m_objects.end (), [](const object_deque_item & a, const object_deque_item & b) {
+			return a.id < b.id;
+		});
+	}
+
+	// a regular load runs both halves right away
+	DESERIALIZER (point_object) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
+		const json & data, cache_id_object_t & cache) const {
+		return prepare (data) (scene, store, cache);
+	}
+
+	DESERIALIZER (torus_object) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
+		const json & data, cache_id_object_t & cache) const {
+		return prepare (data) (scene, store, cache);
+	}
+
+	DESERIALIZER (cube_object) (scene_controller_base & scene, std::shared_ptr<resource_store> store, 
+		const json & data, cache_id_object_t & cache) const {
+		return prepare (data) (scene, store, cache);
+	}
+
+	DESERIALIZER (bezier_curve_c0) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
+		const json & data, cache_id_object_t & cache) const {
+		return prepare (data) (scene, store, cache);
+	}
+
+	DESERIALIZER (bspline_curve) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
+		const json & data, cache_id_object_t & cache) const {
+		return prepare (data) (scene, store, cache);
+	}
 
-		patch->set_name (data["name"].get<std::string> ());
-		return patch;
+	DESERIALIZER (interpolating_curve) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
+		const json & data, cache_id_object_t & cache) const {
+		return prepare (data) (scene, store, cache);
+	}
+
+	DESERIALIZER (bezier_surface_c0) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
+		const json & data, cache_id_object_t & cache) const {
+		return prepare (data) (scene, store, cache);
+	}
+
+	DESERIALIZER (bspline_surface) (scene_controller_base & scene, std::shared_ptr<resource_store> store,
+		const json & data, cache_id_object_t & cache) const {
+		return prepare (data) (scene, store, cache);
 	}
 
 	//////////////////////////////////////////////////
@@ -2,6 +2,24 @@
 #include <cstring>
 
 namespace mini {
+	// in the order of shader_uniform_t
+	static const char * object_uniform_names[] = {
+		"u_world",
+		"u_color",
+		"u_line_width",
+		"u_resolution_u",
+		"u_resolution_v",
+		"u_vertical",
+		"u_domain_sampler",
+		"u_start_t",
+		"u_end_t",
+		"u_size",
+		"u_center"
+	};
+
+	static_assert (sizeof (object_uniform_names) / sizeof (object_uniform_names[0]) == static_cast<std::size_t> (shader_uniform_t::count),
+		"every object uniform needs a name");
+
 	const std::string & shader_error_t::get_log () const {
 		return m_log;
 	}
@@ -136,6 +154,72 @@ namespace mini {
 		return true;
 	}
 
+	bool shader_t::load_binary (GLenum format, const std::vector<uint8_t> & binary) {
+		if (m_is_ready || binary.empty ()) {
+			return false;
+		}
+
+		const GLuint program_object = glCreateProgram ();
+
+		if (program_object == 0) {
+			throw std::runtime_error ("failed to create shader program");
+		}
+
+		glProgramBinary (program_object, format, binary.data (), static_cast<GLsizei> (binary.size ()));
+
+		// binaries go stale after driver updates, that is not an error
+		GLint link_status = 0;
+		glGetProgramiv (program_object, GL_LINK_STATUS, &link_status);
+
+		if (link_status != GL_TRUE) {
+			glDeleteProgram (program_object);
+			return false;
+		}
+
+		m_program = program_object;
+		m_has_geometry = m_gs_source.size () > 0;
+		m_has_tesselation = m_tcs_source.size () > 0 && m_tes_source.size () > 0;
+		m_is_ready = true;
+
+		m_cache_locations ();
+		m_bind_blocks ();
+
+		return true;
+	}
+
+	bool shader_t::get_binary (GLenum & format, std::vector<uint8_t> & binary) const {
+		if (!m_is_ready) {
+			return false;
+		}
+
+		GLint length = 0;
+		glGetProgramiv (m_program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+		if (length <= 0) {
+			return false;
+		}
+
+		GLsizei written = 0;
+		binary.resize (static_cast<std::size_t> (length));
+		glGetProgramBinary (m_program, length, &written, &format, binary.data ());
+		binary.resize (static_cast<std::size_t> (written));
+
+		return written > 0;
+	}
+
+	std::string shader_t::get_combined_source () const {
+		std::string combined;
+		combined.reserve (m_vs_source.size () + m_ps_source.size () + m_gs_source.size () + m_tcs_source.size () + m_tes_source.size () + 5);
+
+		// stage separators keep moving code between stages from colliding
+		for (const auto * source : { &m_vs_source, &m_ps_source, &m_gs_source, &m_tcs_source, &m_tes_source }) {
+			combined += *source;
+			combined += '\0';
+		}
+
+		return combined;
+	}
+
 	bool shader_t::is_ready () const {
 		return m_is_ready;
 	}
@@ -146,6 +230,7 @@ namespace mini {
 		m_has_tesselation = false;
 
 		m_program = m_ps = m_vs = m_gs = m_tcs = m_tes = 0;
+		m_object_locations.fill (-1);
 	}
 
 	shader_t::shader_t (const std::string & vs_source, const std::string & ps_source) {
@@ -154,6 +239,7 @@ namespace mini {
 		m_has_tesselation = false;
 
 		m_program = m_ps = m_vs = m_gs = m_tcs = m_tes = 0;
+		m_object_locations.fill (-1);
 
 		set_vertex_source (vs_source);
 		set_fragment_source (ps_source);
@@ -165,6 +251,7 @@ namespace mini {
 		m_has_tesselation = false;
 
 		m_program = m_ps = m_vs = m_gs = m_tcs = m_tes = 0;
+		m_object_locations.fill (-1);
 
 		m_vs_source = shader.m_vs_source;
 		m_ps_source = shader.m_ps_source;
@@ -234,87 +321,117 @@ namespace mini {
 		return m_program;
 	}
 
-	int shader_t::get_uniform_location (const std::string & name) {
+	int shader_t::get_uniform_location (const std::string & name) const {
 		if (!m_is_ready) {
 			throw std::runtime_error ("program is not linked: cannot get uniform");
 		}
 
-		const int location = glGetUniformLocation (m_program, name.c_str ());
-		return location;
+		auto iter = m_locations.find (name);
+		if (iter == m_locations.end ()) {
+			return -1;
+		}
+
+		return iter->second;
 	}
 
-	void shader_t::set_uniform_sampler (const std::string & name, const GLint value) {
-		const int location = get_uniform_location (name);
+	int shader_t::get_uniform_location (shader_uniform_t uniform) const {
+		if (!m_is_ready) {
+			throw std::runtime_error ("program is not linked: cannot get uniform");
+		}
+
+		return m_object_locations[static_cast<std::size_t> (uniform)];
+	}
 
+	void shader_t::set_uniform_sampler (GLint location, const GLint value) {
 		if (location >= 0) {
 			glUniform1i (location, value);
 		}
 	}
 
-	void shader_t::set_uniform_int (const std::string & name, const GLint value) {
-		const int location = get_uniform_location (name);
-
+	void shader_t::set_uniform_int (GLint location, const GLint value) {
 		if (location >= 0) {
 			glUniform1i (location, value);
 		}
 	}
 
-	void shader_t::set_uniform_uint (const std::string & name, const GLuint value) {
-		const int location = get_uniform_location (name);
-
+	void shader_t::set_uniform_uint (GLint location, const GLuint value) {
 		if (location >= 0) {
 			glUniform1ui (location, value);
 		}
 	}
 
-	void shader_t::set_uniform (const std::string & name, const float value) {
-		const int location = get_uniform_location (name);
-
+	void shader_t::set_uniform (GLint location, const float value) {
 		if (location >= 0) {
 			glUniform1f (location, value);
 		}
 	}
 
-	void shader_t::set_uniform (const std::string & name, const glm::vec2 & vector) {
-		const int location = get_uniform_location (name);
-
+	void shader_t::set_uniform (GLint location, const glm::vec2 & vector) {
 		if (location >= 0) {
 			glUniform2fv (location, 1, glm::value_ptr (vector));
 		}
 	}
 
-	void shader_t::set_uniform (const std::string & name, const glm::vec3 & vector) {
-		const int location = get_uniform_location (name);
-
+	void shader_t::set_uniform (GLint location, const glm::vec3 & vector) {
 		if (location >= 0) {
 			glUniform3fv (location, 1, glm::value_ptr (vector));
 		}
 	}
 
-	void shader_t::set_uniform (const std::string & name, const glm::vec4 & vector) {
-		const int location = get_uniform_location (name);
-
+	void shader_t::set_uniform (GLint location, const glm::vec4 & vector) {
 		if (location >= 0) {
 			glUniform4fv (location, 1, glm::value_ptr (vector));
 		}
 	}
 
-	void shader_t::set_uniform (const std::string & name, const glm::mat3x3 & matrix) {
-		const int location = get_uniform_location (name);
-
+	void shader_t::set_uniform (GLint location, const glm::mat3x3 & matrix) {
 		if (location >= 0) {
 			glUniformMatrix3fv (location, 1, GL_FALSE, glm::value_ptr (matrix));
 		}
 	}
 
-	void shader_t::set_uniform (const std::string & name, const glm::mat4x4 & matrix) {
-		const int location = get_uniform_location (name);
-
+	void shader_t::set_uniform (GLint location, const glm::mat4x4 & matrix) {
 		if (location >= 0) {
 			glUniformMatrix4fv (location, 1, GL_FALSE, glm::value_ptr (matrix));
 		}
 	}
 
+	void shader_t::set_uniform_sampler (const std::string & name, const GLint value) {
+		set_uniform_sampler (get_uniform_location (name), value);
+	}
+
+	void shader_t::set_uniform_int (const std::string & name, const GLint value) {
+		set_uniform_int (get_uniform_location (name), value);
+	}
+
+	void shader_t::set_uniform_uint (const std::string & name, const GLuint value) {
+		set_uniform_uint (get_uniform_location (name), value);
+	}
+
+	void shader_t::set_uniform (const std::string & name, const float value) {
+		set_uniform (get_uniform_location (name), value);
+	}
+
+	void shader_t::set_uniform (const std::string & name, const glm::vec2 & vector) {
+		set_uniform (get_uniform_location (name), vector);
+	}
+
+	void shader_t::set_uniform (const std::string & name, const glm::vec3 & vector) {
+		set_uniform (get_uniform_location (name), vector);
+	}
+
+	void shader_t::set_uniform (const std::string & name, const glm::vec4 & vector) {
+		set_uniform (get_uniform_location (name), vector);
+	}
+
+	void shader_t::set_uniform (const std::string & name, const glm::mat3x3 & matrix) {
+		set_uniform (get_uniform_location (name), matrix);
+	}
+
+	void shader_t::set_uniform (const std::string & name, const glm::mat4x4 & matrix) {
+		set_uniform (get_uniform_location (name), matrix);
+	}
+
 	bool shader_t::m_try_compile (GLenum shader_type, const std::string & source, GLuint * out_shader) {
 		const GLuint shader_object = glCreateShader (shader_type);
 
@@ -359,6 +476,8 @@ namespace mini {
 			throw std::runtime_error ("this shader was already linked and compiled");
 		}
 
+		// allows the program to be stored in the binary cache
+		glProgramParameteri (m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		glLinkProgram (m_program);
 
 		GLint linkStatus = 0;
@@ -381,6 +500,63 @@ namespace mini {
 		}
 
 		m_is_ready = true;
+
+		m_cache_locations ();
+		m_bind_blocks ();
+
 		return true;
 	}
+
+	void shader_t::m_cache_locations () {
+		GLint num_uniforms = 0, max_length = 0;
+
+		glGetProgramiv (m_program, GL_ACTIVE_UNIFORMS, &num_uniforms);
+		glGetProgramiv (m_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+		m_locations.clear ();
+		std::string name (static_cast<std::size_t> (max_length), '\0');
+
+		for (GLint index = 0; index < num_uniforms; ++index) {
+			GLsizei length = 0;
+			GLint size = 0;
+			GLenum type = 0;
+
+			glGetActiveUniform (m_program, static_cast<GLuint> (index), max_length, &length, &size, &type, &name[0]);
+
+			const std::string uniform_name = name.substr (0, static_cast<std::size_t> (length));
+			const GLint location = glGetUniformLocation (m_program, uniform_name.c_str ());
+
+			// block members have no location
+			if (location < 0) {
+				continue;
+			}
+
+			m_locations[uniform_name] = location;
+
+			// arrays are reported as name[0] but are usually set by their plain name
+			const auto bracket = uniform_name.find ('[');
+			if (bracket != std::string::npos) {
+				m_locations.emplace (uniform_name.substr (0, bracket), location);
+			}
+		}
+
+		for (std::size_t uniform = 0; uniform < m_object_locations.size (); ++uniform) {
+			auto iter = m_locations.find (object_uniform_names[uniform]);
+			m_object_locations[uniform] = (iter != m_locations.end ()) ? iter->second : -1;
+		}
+	}
+
+	void shader_t::m_bind_blocks () {
+		const GLuint camera_block = glGetUniformBlockIndex (m_program, camera_block_name);
+
+		if (camera_block != GL_INVALID_INDEX) {
+			glUniformBlockBinding (m_program, camera_block, camera_block_binding);
+		}
+
+		const GLuint pick_block = glGetUniformBlockIndex (m_program, pick_block_name);
+
+		if (pick_block != GL_INVALID_INDEX) {
+			glUniformBlockBinding (m_program, pick_block, pick_block_binding);
+		}
+	}
 }
\ No newline at end of file
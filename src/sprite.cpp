@@ -106,20 +106,21 @@ namespace mini {
 		m_shader->bind ();
 
 		// set uniforms
-		const auto & view_matrix = context.get_view_matrix ();
-		const auto & proj_matrix = context.get_projection_matrix ();
-
-		float screen_width = static_cast<float> (context.get_video_mode ().get_buffer_width ());
-		float screen_height = static_cast<float> (context.get_video_mode ().get_buffer_height ());
-
-		m_shader->set_uniform ("u_size", m_size);
-		m_shader->set_uniform ("u_color", m_color_tint);
-		m_shader->set_uniform ("u_world", world_matrix);
-		m_shader->set_uniform ("u_resolution", glm::vec2 (screen_width, screen_height));
+		m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::size), m_size);
+		m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::color), m_color_tint);
+		m_shader->set_uniform (m_shader->get_uniform_location (shader_uniform_t::world), world_matrix);
 
 		glDrawElements (GL_TRIANGLES, static_cast<GLsizei> (quad_indices.size ()), GL_UNSIGNED_INT, NULL);
 		glBindVertexArray (static_cast<GLuint>(NULL));
 		glEnable (GL_DEPTH_TEST);
 		glDisable (GL_BLEND);
 	}
+
+	render_key_t sprite::get_render_key () const {
+		return {
+			m_shader ? m_shader->get_program_handle () : 0,
+			m_vao,
+			m_texture ? m_texture->get_handle () : 0
+		};
+	}
 }
\ No newline at end of file
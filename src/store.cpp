@@ -2,51 +2,138 @@
 
 #include <fstream>
 #include <sstream>
+#include <iostream>
+#include <chrono>
 #include <ios>
 
 namespace mini {
-	std::shared_ptr<shader_t> resource_store::m_load_shader (const std::string & vs_file, const std::string & ps_file) const {
-		const std::string vs_source = m_read_file_content (vs_file);
-		const std::string ps_source = m_read_file_content (ps_file);
+	struct shader_manifest_entry_t {
+		const char * vs;
+		const char * ps;
+		const char * tcs;
+		const char * tes;
+		const char * gs;
+
+		// built when the store is created, everything else waits for first use
+		bool eager;
+	};
+
+	// stage files of every program, in the order of resource_store::shader_id_t
+	static const shader_manifest_entry_t s_shader_manifest[] = {
+		// basic
+		{ "shaders/vs_basic.glsl", "shaders/fs_basic.glsl", nullptr, nullptr, nullptr, false },
+
+		// mesh shader and selected mesh shader
+		{ "shaders/vs_meshgrid.glsl", "shaders/fs_meshgrid.glsl", nullptr, nullptr, nullptr, false },
+		{ "shaders/vs_meshgrid.glsl", "shaders/fs_meshgrid_s.glsl", nullptr, nullptr, nullptr, false },
 
-		auto shader = std::make_shared<shader_t> (vs_source, ps_source);
-		
-		try {
-			shader->compile ();
-		} catch (const shader_error_t & error) {
-			std::cerr << error.what() << " log: " << std::endl << error.get_log () << std::endl;
-			return nullptr;
+		// grid shaders for scene background
+		{ "shaders/vs_grid.glsl", "shaders/fs_grid_xz.glsl", nullptr, nullptr, nullptr, true },
+		{ "shaders/vs_grid.glsl", "shaders/fs_grid_xy.glsl", nullptr, nullptr, nullptr, true },
+
+		// shaders for billboards, the screen space one draws the cursor
+		{ "shaders/vs_billboard.glsl", "shaders/fs_billboard.glsl", nullptr, nullptr, nullptr, false },
+		{ "shaders/vs_billboard_s.glsl", "shaders/fs_billboard.glsl", nullptr, nullptr, nullptr, true },
+		{ "shaders/vs_points.glsl", "shaders/fs_points.glsl", nullptr, nullptr, nullptr, true },
+
+		// shaders used for gpu bezier
+		{ "shaders/vs_position.glsl", "shaders/fs_solidcolor.glsl", nullptr, nullptr, "shaders/gs_bezier.glsl", false },
+		{ "shaders/vs_position.glsl", "shaders/fs_solidcolor.glsl", nullptr, nullptr, "shaders/gs_bezier2.glsl", false },
+
+		// shader that draws nice polygon lines
+		{ "shaders/vs_basic.glsl", "shaders/fs_solidcolor.glsl", nullptr, nullptr, "shaders/gs_lines.glsl", false },
+
+		// surface teselation shaders
+		{ "shaders/vs_pass_uv.glsl", "shaders/fs_trimming_isolines.glsl", 
+			"shaders/tcs_bezier_isolines.glsl", "shaders/tes_bezier_isolines.glsl", "shaders/gs_isolines_uv.glsl", false },
+
+		{ "shaders/vs_pass_uv.glsl", "shaders/fs_trimming.glsl",
+			"shaders/tcs_bezier_quads.glsl", "shaders/tes_bezier_quads.glsl", nullptr, false },
+
+		{ "shaders/vs_pass_uv.glsl", "shaders/fs_trimming_isolines.glsl",
+			"shaders/tcs_bezier_isolines.glsl", "shaders/tes_bspline_isolines.glsl", "shaders/gs_isolines_uv.glsl", false },
+
+		{ "shaders/vs_pass_uv.glsl", "shaders/fs_trimming.glsl",
+			"shaders/tcs_bezier_quads.glsl", "shaders/tes_bspline_quads.glsl", nullptr, false },
+
+		{ "shaders/vs_pass.glsl", "shaders/fs_solidcolor.glsl",
+			"shaders/tcs_gregory_isolines.glsl", "shaders/tes_gregory_isolines.glsl", "shaders/gs_lines.glsl", false },
+
+		{ "shaders/vs_pass.glsl", "shaders/fs_solidcolor.glsl",
+			"shaders/tcs_gregory_quads.glsl", "shaders/tes_gregory_quads.glsl", nullptr, false },
+
+		// box select
+		{ "shaders/vs_sprite.glsl", "shaders/fs_boxselect.glsl", nullptr, nullptr, nullptr, false },
+
+		// gizmos
+		{ "shaders/vs_position.glsl", "shaders/fs_solidcolor.glsl", nullptr, nullptr, nullptr, false }
+	};
+
+	using store_clock = std::chrono::steady_clock;
+
+	static long long s_elapsed_ms (store_clock::time_point from, store_clock::time_point to) {
+		return std::chrono::duration_cast<std::chrono::milliseconds> (to - from).count ();
+	}
+
+	std::string resource_store::m_read_file_content (const std::string & path) const {
+		std::ifstream stream (path);
+
+		if (stream) {
+			std::stringstream ss;
+			ss << stream.rdbuf ();
+
+			return ss.str ();
 		}
 
-		return shader;
+		throw std::runtime_error ("failed to read file " + path);
 	}
 
-	std::shared_ptr<shader_t> resource_store::m_load_shader (const std::string & vs_file, const std::string & ps_file, const std::string & gs_file) const {
-		const std::string vs_source = m_read_file_content (vs_file);
-		const std::string ps_source = m_read_file_content (ps_file);
-		const std::string gs_source = m_read_file_content (gs_file);
+	resource_store::shader_sources_t resource_store::m_read_sources (shader_id_t id) const {
+		const auto & entry = s_shader_manifest[static_cast<std::size_t> (id)];
+		shader_sources_t sources;
 
-		auto shader = std::make_shared<shader_t> (vs_source, ps_source);
-		shader->set_geometry_source (gs_source);
+		sources.vs = m_read_file_content (entry.vs);
+		sources.ps = m_read_file_content (entry.ps);
 
-		try {
-			shader->compile ();
-		} catch (const shader_error_t & error) {
-			std::cerr << error.what () << " log: " << std::endl << error.get_log () << std::endl;
-			return nullptr;
+		if (entry.tcs && entry.tes) {
+			sources.tcs = m_read_file_content (entry.tcs);
+			sources.tes = m_read_file_content (entry.tes);
 		}
 
-		return shader;
+		if (entry.gs) {
+			sources.gs = m_read_file_content (entry.gs);
+		}
+
+		return sources;
 	}
 
-	std::shared_ptr<shader_t> resource_store::m_load_shader (const std::string & vs_file, const std::string & ps_file, const std::string & tcs_file, const std::string & tes_file) const {
-		const std::string vs_source = m_read_file_content (vs_file);
-		const std::string ps_source = m_read_file_content (ps_file);
-		const std::string tes_source = m_read_file_content (tes_file);
-		const std::string tcs_source = m_read_file_content (tcs_file);
+	std::shared_ptr<shader_t> resource_store::m_get_shader (shader_id_t id) const {
+		const auto index = static_cast<std::size_t> (id);
+
+		if (!m_shaders_built[index]) {
+			m_shaders[index] = m_build_shader (id, m_read_sources (id));
+			m_shaders_built[index] = true;
+		}
+
+		return m_shaders[index];
+	}
 
-		auto shader = std::make_shared<shader_t> (vs_source, ps_source);
-		shader->set_tesselation_source (tcs_source, tes_source);
+	std::shared_ptr<shader_t> resource_store::m_build_shader (shader_id_t id, const shader_sources_t & sources) const {
+		const auto & entry = s_shader_manifest[static_cast<std::size_t> (id)];
+		auto shader = std::make_shared<shader_t> (sources.vs, sources.ps);
+
+		if (entry.tcs && entry.tes) {
+			shader->set_tesselation_source (sources.tcs, sources.tes);
+		}
+
+		if (entry.gs) {
+			shader->set_geometry_source (sources.gs);
+		}
+
+		if (m_program_cache.load (*shader)) {
+			m_programs_cached++;
+			return shader;
+		}
 
 		try {
 			shader->compile ();
@@ -55,114 +142,174 @@ namespace mini {
 			return nullptr;
 		}
 
+		m_programs_compiled++;
+		m_program_cache.store (*shader);
+
 		return shader;
 	}
 
-	std::shared_ptr<shader_t> resource_store::m_load_shader (const std::string & vs_file, const std::string & ps_file, const std::string & tcs_file, const std::string & tes_file, const std::string & gs_file) const {
-		const std::string vs_source = m_read_file_content (vs_file);
-		const std::string ps_source = m_read_file_content (ps_file);
-		const std::string tes_source = m_read_file_content (tes_file);
-		const std::string tcs_source = m_read_file_content (tcs_file);
-		const std::string gs_source = m_read_file_content (gs_file);
+	void resource_store::begin_warm_up () {
+		if (m_warm_up_thread.joinable ()) {
+			return;
+		}
 
-		auto shader = std::make_shared<shader_t> (vs_source, ps_source);
+		std::vector<shader_id_t> ids;
 
-		shader->set_tesselation_source (tcs_source, tes_source);
-		shader->set_geometry_source (gs_source);
+		for (std::size_t index = 0; index < c_num_shaders; ++index) {
+			if (!m_shaders_built[index]) {
+				ids.push_back (static_cast<shader_id_t> (index));
+			}
+		}
 
-		try {
-			shader->compile ();
-		} catch (const shader_error_t & error) {
-			std::cerr << error.what () << " log: " << std::endl << error.get_log () << std::endl;
-			return nullptr;
+		if (ids.empty ()) {
+			return;
 		}
 
-		return shader;
+		m_warm_up_cancel = false;
+		m_warm_up_read = false;
+		m_warm_up_built = 0;
+		m_warm_up_thread = std::thread (&resource_store::m_warm_up_worker, this, std::move (ids));
 	}
 
-	std::string resource_store::m_read_file_content (const std::string & path) const {
-		std::ifstream stream (path);
+	void resource_store::warm_up (uint32_t max_programs) {
+		if (!m_warm_up_thread.joinable ()) {
+			return;
+		}
 
-		if (stream) {
-			std::stringstream ss;
-			ss << stream.rdbuf ();
+		for (uint32_t i = 0; i < max_programs; ++i) {
+			std::pair<shader_id_t, shader_sources_t> item;
 
-			return ss.str ();
+			{
+				std::lock_guard<std::mutex> lock (m_warm_up_mutex);
+
+				if (m_warm_up_queue.empty ()) {
+					break;
+				}
+
+				item = std::move (m_warm_up_queue.front ());
+				m_warm_up_queue.pop_front ();
+			}
+
+			// the program might have been requested since the worker read it
+			const auto index = static_cast<std::size_t> (item.first);
+
+			if (!m_shaders_built[index]) {
+				m_shaders[index] = m_build_shader (item.first, item.second);
+				m_shaders_built[index] = true;
+				m_warm_up_built++;
+			}
 		}
 
-		throw std::runtime_error ("failed to read file " + path);
+		bool done = false;
+
+		if (m_warm_up_read) {
+			std::lock_guard<std::mutex> lock (m_warm_up_mutex);
+			done = m_warm_up_queue.empty ();
+		}
+
+		if (done) {
+			m_warm_up_thread.join ();
+			std::cout << "warm up finished: " << m_warm_up_built << " programs built ("
+				<< m_programs_cached << " cached, " << m_programs_compiled << " compiled in total)" << std::endl;
+		}
+	}
+
+	void resource_store::m_warm_up_worker (std::vector<shader_id_t> ids) {
+		for (const auto id : ids) {
+			if (m_warm_up_cancel) {
+				break;
+			}
+
+			shader_sources_t sources;
+
+			// a missing file is reported when the program is actually requested
+			try {
+				sources = m_read_sources (id);
+			} catch (const std::runtime_error &) {
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock (m_warm_up_mutex);
+			m_warm_up_queue.emplace_back (id, std::move (sources));
+		}
+
+		m_warm_up_read = true;
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_basic_shader () const {
-		return m_basic_shader;
+		return m_get_shader (shader_id_t::basic);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_grid_xz_shader () const {
-		return m_grid_xz_shader;
+		return m_get_shader (shader_id_t::grid_xz);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_grid_xy_shader () const {
-		return m_grid_xy_shader;
+		return m_get_shader (shader_id_t::grid_xy);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_billboard_shader () const {
-		return m_billboard_shader;
+		return m_get_shader (shader_id_t::billboard);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_billboard_s_shader () const {
-		return m_billboard_shader_s;
+		return m_get_shader (shader_id_t::billboard_s);
+	}
+
+	std::shared_ptr<shader_t> resource_store::get_point_shader () const {
+		return m_get_shader (shader_id_t::point);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_mesh_shader () const {
-		return m_mesh_shader;
+		return m_get_shader (shader_id_t::mesh);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_alt_mesh_shader () const {
-		return m_alt_mesh_shader;
+		return m_get_shader (shader_id_t::alt_mesh);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_bezier_shader () const {
-		return m_bezier_shader;
+		return m_get_shader (shader_id_t::bezier);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_bezier_poly_shader () const {
-		return m_bezier_poly_shader;
+		return m_get_shader (shader_id_t::bezier_poly);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_line_shader () const {
-		return m_line_shader;
+		return m_get_shader (shader_id_t::line);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_bezier_surf_shader () const {
-		return m_bezier_surf_shader;
+		return m_get_shader (shader_id_t::bezier_surf);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_bezier_surf_solid_shader () const {
-		return m_bezier_surf_solid_shader;
+		return m_get_shader (shader_id_t::bezier_surf_solid);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_bspline_surf_shader () const {
-		return m_bspline_surf_shader;
+		return m_get_shader (shader_id_t::bspline_surf);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_bspline_surf_solid_shader () const {
-		return m_bspline_surf_solid_shader;
+		return m_get_shader (shader_id_t::bspline_surf_solid);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_gregory_surf_shader () const {
-		return m_gregory_surf_shader;
+		return m_get_shader (shader_id_t::gregory_surf);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_gregory_surf_solid_shader () const {
-		return m_gregory_surf_solid_shader;
+		return m_get_shader (shader_id_t::gregory_surf_solid);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_box_select_shader () const {
-		return m_box_select_shader;
+		return m_get_shader (shader_id_t::box_select);
 	}
 
 	std::shared_ptr<shader_t> resource_store::get_gizmo_shader () const {
-		return m_gizmo_shader;
+		return m_get_shader (shader_id_t::gizmo);
 	}
 
 	std::shared_ptr<texture_t> resource_store::get_cursor_texture () const {
@@ -173,55 +320,51 @@ namespace mini {
 		return m_point_texture;
 	}
 
-	resource_store::resource_store () {
-		m_basic_shader = m_load_shader ("shaders/vs_basic.glsl", "shaders/fs_basic.glsl");
-
-		// mesh shader and selected mesg shader
-		m_mesh_shader = m_load_shader ("shaders/vs_meshgrid.glsl", "shaders/fs_meshgrid.glsl");
-		m_alt_mesh_shader = m_load_shader ("shaders/vs_meshgrid.glsl", "shaders/fs_meshgrid_s.glsl");
-
-		// grid shaders for scene background
-		m_grid_xz_shader = m_load_shader ("shaders/vs_grid.glsl", "shaders/fs_grid_xz.glsl");
-		m_grid_xy_shader = m_load_shader ("shaders/vs_grid.glsl", "shaders/fs_grid_xy.glsl");
-
-		// shaders for billboards
-		m_billboard_shader = m_load_shader ("shaders/vs_billboard.glsl", "shaders/fs_billboard.glsl");
-		m_billboard_shader_s = m_load_shader ("shaders/vs_billboard_s.glsl", "shaders/fs_billboard.glsl");
+	resource_store::resource_store () : 
+		m_program_cache ("cache/programs") {
 
-		// shaders used for gpu bezier
-		m_bezier_shader = m_load_shader ("shaders/vs_position.glsl", "shaders/fs_solidcolor.glsl", "shaders/gs_bezier.glsl");
-		m_bezier_poly_shader = m_load_shader ("shaders/vs_position.glsl", "shaders/fs_solidcolor.glsl", "shaders/gs_bezier2.glsl");
+		static_assert (sizeof (s_shader_manifest) / sizeof (s_shader_manifest[0]) == c_num_shaders,
+			"shader manifest does not match shader_id_t");
 
-		// shader that draws nice polygon lines
-		m_line_shader = m_load_shader ("shaders/vs_basic.glsl", "shaders/fs_solidcolor.glsl", "shaders/gs_lines.glsl");
+		const auto start_time = store_clock::now ();
 
-		// surface teselation shaders
-		m_bezier_surf_shader = m_load_shader ("shaders/vs_pass_uv.glsl", "shaders/fs_trimming_isolines.glsl", 
-			"shaders/tcs_bezier_isolines.glsl", "shaders/tes_bezier_isolines.glsl", "shaders/gs_isolines_uv.glsl");
+		m_programs_cached = 0;
+		m_programs_compiled = 0;
+		m_shaders_built.fill (false);
 
-		m_bezier_surf_solid_shader = m_load_shader ("shaders/vs_pass_uv.glsl", "shaders/fs_trimming.glsl",
-			"shaders/tcs_bezier_quads.glsl", "shaders/tes_bezier_quads.glsl");
+		m_warm_up_cancel = false;
+		m_warm_up_read = false;
+		m_warm_up_built = 0;
 
-		m_bspline_surf_shader = m_load_shader ("shaders/vs_pass_uv.glsl", "shaders/fs_trimming_isolines.glsl",
-			"shaders/tcs_bezier_isolines.glsl", "shaders/tes_bspline_isolines.glsl", "shaders/gs_isolines_uv.glsl");
+		// only the programs needed by an empty scene are built up front
+		for (std::size_t index = 0; index < c_num_shaders; ++index) {
+			if (s_shader_manifest[index].eager) {
+				m_get_shader (static_cast<shader_id_t> (index));
+			}
+		}
 
-		m_bspline_surf_solid_shader = m_load_shader ("shaders/vs_pass_uv.glsl", "shaders/fs_trimming.glsl",
-			"shaders/tcs_bezier_quads.glsl", "shaders/tes_bspline_quads.glsl");
+		const auto shaders_time = store_clock::now ();
 
-		m_gregory_surf_shader = m_load_shader ("shaders/vs_pass.glsl", "shaders/fs_solidcolor.glsl",
-			"shaders/tcs_gregory_isolines.glsl", "shaders/tes_gregory_isolines.glsl", "shaders/gs_lines.glsl");
+		// textures
+		m_cursor_texture = texture_t::load_from_file ("assets/cursor.png");
+		m_point_texture = texture_t::load_from_file ("assets/point.png");
 
-		m_gregory_surf_solid_shader = m_load_shader ("shaders/vs_pass.glsl", "shaders/fs_solidcolor.glsl",
-			"shaders/tcs_gregory_quads.glsl", "shaders/tes_gregory_quads.glsl");
+		const auto end_time = store_clock::now ();
 
-		// box select
-		m_box_select_shader = m_load_shader ("shaders/vs_sprite.glsl", "shaders/fs_boxselect.glsl");
+		// startup report
+		std::cout << "resources loaded in " << s_elapsed_ms (start_time, end_time) << " ms: "
+			<< m_programs_cached + m_programs_compiled << " of " << c_num_shaders << " programs in " 
+			<< s_elapsed_ms (start_time, shaders_time) << " ms ("
+			<< m_programs_cached << " cached, " << m_programs_compiled << " compiled"
+			<< (m_program_cache.is_enabled () ? "" : ", binary cache unavailable") << "), "
+			<< "textures in " << s_elapsed_ms (shaders_time, end_time) << " ms" << std::endl;
+	}
 
-		// gizmos
-		m_gizmo_shader = m_load_shader ("shaders/vs_position.glsl", "shaders/fs_solidcolor.glsl");
+	resource_store::~resource_store () {
+		m_warm_up_cancel = true;
 
-		// textures
-		m_cursor_texture = texture_t::load_from_file ("assets/cursor.png");
-		m_point_texture = texture_t::load_from_file ("assets/point.png");
+		if (m_warm_up_thread.joinable ()) {
+			m_warm_up_thread.join ();
+		}
 	}
-}
\ No newline at end of file
+}
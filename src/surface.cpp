@@ -6,10 +6,18 @@ namespace mini {
 		return m_points;
 	}
 
+	const glm::vec3 * bicubic_surface::t_get_control_net () const {
+		return m_net.empty () ? nullptr : m_net.data ();
+	}
+
 	trimmable_surface_domain& bicubic_surface::get_domain() {
 		return m_domain;
 	}
 
+	const patch_bvh & bicubic_surface::get_patch_bvh () const {
+		return m_bvh;
+	}
+
 	bool bicubic_surface::is_showing_polygon () const {
 		return m_show_polygon;
 	}
@@ -162,6 +170,8 @@ namespace mini {
 		m_uv = uv;
 		m_indices = topology;
 		m_grid_indices = grid_topology;
+
+		m_rebuild_control_net ();
 	}
 
 	bicubic_surface::~bicubic_surface () {
@@ -221,9 +231,6 @@ namespace mini {
 			m_domain.bind(0);
 
 			if (m_use_solid) {
-				const auto & view_matrix = context.get_view_matrix ();
-				const auto & proj_matrix = context.get_projection_matrix ();
-
 				if (m_use_wireframe) {
 					glPolygonMode (GL_FRONT_AND_BACK, GL_LINE);
 				}
@@ -231,9 +238,9 @@ namespace mini {
 				m_bind_shader (context, *m_solid_shader.get (), world_matrix);
 
 				// first render pass - u,v
-				m_solid_shader->set_uniform_uint ("u_resolution_v", static_cast<GLuint> (m_res_v));
-				m_solid_shader->set_uniform_uint ("u_resolution_u", static_cast<GLuint> (m_res_u));
-				m_solid_shader->set_uniform_int ("u_domain_sampler", 0);
+				m_solid_shader->set_uniform_uint (m_solid_shader->get_uniform_location (shader_uniform_t::resolution_v), static_cast<GLuint> (m_res_v));
+				m_solid_shader->set_uniform_uint (m_solid_shader->get_uniform_location (shader_uniform_t::resolution_u), static_cast<GLuint> (m_res_u));
+				m_solid_shader->set_uniform_int (m_solid_shader->get_uniform_location (shader_uniform_t::domain_sampler), 0);
 
 				glPatchParameteri (GL_PATCH_VERTICES, 16);
 				glDrawElements (GL_PATCHES, m_indices.size (), GL_UNSIGNED_INT, 0);
@@ -243,19 +250,19 @@ namespace mini {
 				m_bind_shader (context, *m_shader.get (), world_matrix);
 
 				// first render pass - u,v
-				m_shader->set_uniform_int ("u_vertical", true);
-				m_shader->set_uniform_uint ("u_resolution_v", static_cast<GLuint> (m_res_v));
-				m_shader->set_uniform_uint ("u_resolution_u", static_cast<GLuint> (m_res_u));
-				m_shader->set_uniform_int("u_domain_sampler", 0);
+				m_shader->set_uniform_int (m_shader->get_uniform_location (shader_uniform_t::vertical), true);
+				m_shader->set_uniform_uint (m_shader->get_uniform_location (shader_uniform_t::resolution_v), static_cast<GLuint> (m_res_v));
+				m_shader->set_uniform_uint (m_shader->get_uniform_location (shader_uniform_t::resolution_u), static_cast<GLuint> (m_res_u));
+				m_shader->set_uniform_int(m_shader->get_uniform_location(shader_uniform_t::domain_sampler), 0);
 
 				glPatchParameteri (GL_PATCH_VERTICES, 16);
 				glDrawElements (GL_PATCHES, m_indices.size (), GL_UNSIGNED_INT, 0);
 
 				// second render pass = v,u
-				m_shader->set_uniform_int ("u_vertical", false);
-				m_shader->set_uniform_uint ("u_resolution_v", static_cast<GLuint> (m_res_u));
-				m_shader->set_uniform_uint ("u_resolution_u", static_cast<GLuint> (m_res_v));
-				m_shader->set_uniform_int("u_domain_sampler", 0);
+				m_shader->set_uniform_int (m_shader->get_uniform_location (shader_uniform_t::vertical), false);
+				m_shader->set_uniform_uint (m_shader->get_uniform_location (shader_uniform_t::resolution_v), static_cast<GLuint> (m_res_u));
+				m_shader->set_uniform_uint (m_shader->get_uniform_location (shader_uniform_t::resolution_u), static_cast<GLuint> (m_res_v));
+				m_shader->set_uniform_int(m_shader->get_uniform_location(shader_uniform_t::domain_sampler), 0);
 
 				glPatchParameteri (GL_PATCH_VERTICES, 16);
 				glDrawElements (GL_PATCHES, m_indices.size (), GL_UNSIGNED_INT, 0);
@@ -273,6 +280,15 @@ namespace mini {
 		}
 	}
 
+	render_key_t bicubic_surface::get_render_key () const {
+		if (!m_ready) {
+			return {};
+		}
+
+		const auto & shader = m_use_solid ? m_solid_shader : m_shader;
+		return { shader ? shader->get_program_handle () : 0, m_vao, m_domain.get_texture_handle () };
+	}
+
 	std::vector<uint64_t> bicubic_surface::serialize_points () {
 		std::vector<uint64_t> serialized;
 		serialized.reserve (m_points.size ());
@@ -326,7 +342,11 @@ namespace mini {
 		unsigned int base_idx = patch_idx * num_control_points;
 		unsigned int local_idx = (4 * y) + x;
 		
-		return m_points[m_indices[base_idx + local_idx]]->get_translation ();
+		if (m_net.empty ()) {
+			return m_points[m_indices[base_idx + local_idx]]->get_translation ();
+		}
+
+		return m_net[base_idx + local_idx];
 	}
 
 	constexpr GLuint a_position = 0;
@@ -335,26 +355,13 @@ namespace mini {
 	void bicubic_surface::m_bind_shader (app_context & context, shader_t & shader, const glm::mat4x4 & world_matrix) const {
 		shader.bind ();
 
-		const auto & view_matrix = context.get_view_matrix ();
-		const auto & proj_matrix = context.get_projection_matrix ();
-
-		const auto & video_mode = context.get_video_mode ();
-
-		glm::vec2 resolution = {
-			static_cast<float> (video_mode.get_buffer_width ()),
-			static_cast<float> (video_mode.get_buffer_height ())
-		};
-
-		shader.set_uniform ("u_world", world_matrix);
-		shader.set_uniform ("u_view", view_matrix);
-		shader.set_uniform ("u_projection", proj_matrix);
-		shader.set_uniform ("u_resolution", resolution);
-		shader.set_uniform ("u_line_width", 2.0f);
+		shader.set_uniform (shader.get_uniform_location (shader_uniform_t::world), world_matrix);
+		shader.set_uniform (shader.get_uniform_location (shader_uniform_t::line_width), 2.0f);
 		
 		if (!is_selected ()) {
-			shader.set_uniform ("u_color", m_color);
+			shader.set_uniform (shader.get_uniform_location (shader_uniform_t::color), m_color);
 		} else {
-			shader.set_uniform ("u_color", m_color * point_object::s_select_default);
+			shader.set_uniform (shader.get_uniform_location (shader_uniform_t::color), m_color * point_object::s_select_default);
 		}
 	}
 
@@ -381,6 +388,8 @@ namespace mini {
 			t_calc_uv_buffer(m_uv, m_indices);
 		}
 
+		m_rebuild_control_net ();
+
 		// put data into buffers
 		glGenVertexArrays (1, &m_vao);
 		glGenBuffers (1, &m_pos_buffer);
@@ -481,8 +490,86 @@ namespace mini {
 		m_ready = false;
 	}
 
+	void bicubic_surface::m_rebuild_control_net () {
+		m_net.clear ();
+		m_bvh.clear ();
+		m_point_slots.clear ();
+
+		if (m_indices.size () != get_num_patches () * num_control_points) {
+			return;
+		}
+
+		for (const auto & point : m_points) {
+			if (!point) {
+				return;
+			}
+		}
+
+		m_net.resize (m_indices.size ());
+
+		for (unsigned int slot = 0; slot < m_indices.size (); ++slot) {
+			const auto & point = m_points[m_indices[slot]];
+
+			m_net[slot] = point->get_translation ();
+			m_point_slots[point->get_id ()].push_back (slot);
+		}
+
+		std::vector<patch_bvh::leaf_t> leaves;
+		leaves.reserve (get_num_patches ());
+
+		const float du = 1.0f / static_cast<float> (m_patches_x);
+		const float dv = 1.0f / static_cast<float> (m_patches_y);
+
+		for (unsigned int patch = 0; patch < get_num_patches (); ++patch) {
+			unsigned int px = patch % m_patches_x;
+			unsigned int py = patch / m_patches_x;
+
+			patch_bvh::leaf_t leaf;
+			leaf.bounds = m_calc_patch_bounds (patch);
+			leaf.min_param = { px * du, py * dv };
+			leaf.max_param = { (px + 1) * du, (py + 1) * dv };
+			leaves.push_back (leaf);
+		}
+
+		m_bvh.build (leaves);
+	}
+
+	aabb_t bicubic_surface::m_calc_patch_bounds (unsigned int patch) const {
+		// the patch lies in the convex hull of its control points
+		// for both bezier and b-spline bases
+		const glm::vec3 * cp = m_net.data () + patch * num_control_points;
+
+		aabb_t bounds = { cp[0], cp[0] };
+		for (unsigned int i = 1; i < num_control_points; ++i) {
+			bounds.extend (cp[i]);
+		}
+
+		return bounds;
+	}
+
 	void bicubic_surface::m_moved_sighandler (signal_event_t sig, scene_obj_t & sender) {
 		m_queued_update = true;
+
+		auto iter = m_point_slots.find (sender.get_id ());
+		if (iter == m_point_slots.end ()) {
+			return;
+		}
+
+		const auto & position = sender.get_translation ();
+		for (auto slot : iter->second) {
+			m_net[slot] = position;
+		}
+
+		// slots are sorted, so the slots of one patch are adjacent
+		unsigned int last_patch = get_num_patches ();
+		for (auto slot : iter->second) {
+			unsigned int patch = slot / num_control_points;
+
+			if (patch != last_patch) {
+				m_bvh.refit (static_cast<int> (patch), m_calc_patch_bounds (patch));
+				last_patch = patch;
+			}
+		}
 	}
 
 	void bicubic_surface::m_setup_signals () {
@@ -506,6 +593,7 @@ namespace mini {
 		}
 
 		m_queued_update = true;
+		m_rebuild_control_net ();
 
 		t_ignore (signal_event_t::moved, *point);
 		t_listen (signal_event_t::moved, *merge);
@@ -526,12 +614,4 @@ namespace mini {
 			}
 		}
 	}
-
-	bool differentiable_surface_base::is_trimmable() const {
-		return false;
-	}
-
-	trimmable_surface_domain& differentiable_surface_base::get_trimmable_domain() {
-		throw std::runtime_error("this surface is not trimmable");
-	}
 }
\ No newline at end of file
@@ -31,6 +31,10 @@ namespace mini {
 		return m_format;
 	}
 
+	GLuint texture_t::get_handle () const {
+		return m_texture;
+	}
+
 	texture_t::texture_t (uint32_t width, uint32_t height, unsigned char * data) {
 		m_width = width;
 		m_height = height;
@@ -23,12 +23,23 @@ namespace mini {
 
 		m_requires_rebuild = false;
 		m_generate_geometry();
+
+		m_domain.set_wrapping(true, true);
+
+		m_bvh_matrix = glm::mat4x4(1.0f);
+		m_bvh_inner_radius = m_bvh_outer_radius = 0.0f;
 	}
 
 	torus_object::~torus_object() {
 		m_free_geometry();
 	}
 
+	void torus_object::integrate(float delta_time) {
+		if (!m_is_bvh_valid()) {
+			m_update_bvh();
+		}
+	}
+
 	void torus_object::render(app_context& context, const glm::mat4x4& world_matrix) const {
 		glBindVertexArray(m_vao);
 
@@ -36,19 +47,14 @@ namespace mini {
 		m_shader->bind();
 
 		if (!is_selected()) {
-			m_shader->set_uniform("u_color", glm::vec4{ 1.0f, 1.0f, 1.0f, 0.75f });
+			m_shader->set_uniform(m_shader->get_uniform_location(shader_uniform_t::color), glm::vec4{ 1.0f, 1.0f, 1.0f, 0.75f });
 		} else {
-			m_shader->set_uniform("u_color", glm::vec4{ 0.960f, 0.646f, 0.0192f, 0.4f });
+			m_shader->set_uniform(m_shader->get_uniform_location(shader_uniform_t::color), glm::vec4{ 0.960f, 0.646f, 0.0192f, 0.4f });
 		}
 
 		// set uniforms
-		const auto& view_matrix = context.get_view_matrix();
-		const auto& proj_matrix = context.get_projection_matrix();
-
-		m_shader->set_uniform_int("u_domain_sampler", 0);
-		m_shader->set_uniform("u_world", world_matrix);
-		m_shader->set_uniform("u_view", view_matrix);
-		m_shader->set_uniform("u_projection", proj_matrix);
+		m_shader->set_uniform_int(m_shader->get_uniform_location(shader_uniform_t::domain_sampler), 0);
+		m_shader->set_uniform(m_shader->get_uniform_location(shader_uniform_t::world), world_matrix);
 
 		if (m_is_wireframe) {
 			glDisable(GL_DEPTH_TEST);
@@ -59,6 +65,10 @@ namespace mini {
 		glEnable(GL_DEPTH_TEST);
 	}
 
+	render_key_t torus_object::get_render_key() const {
+		return { m_shader ? m_shader->get_program_handle() : 0, m_vao, m_domain.get_texture_handle() };
+	}
+
 	void torus_object::configure() {
 		scene_obj_t::configure();
 
@@ -282,6 +292,70 @@ namespace mini {
 
 	// differentiable surface interface
 	constexpr float DPI = 2.0f * glm::pi<float>();
+	constexpr int c_bvh_res = 16;
+
+	inline glm::vec3 torus_local_point(float A, float B, float u, float v) {
+		float x = cos(v) * (A + B * cos(u));
+		float y = sin(v) * (A + B * cos(u));
+		float z = B * sin(u);
+
+		return { x, y, z };
+	}
+
+	bool torus_object::m_is_bvh_valid() const {
+		return !m_bvh.empty() &&
+			m_bvh_inner_radius == m_inner_radius &&
+			m_bvh_outer_radius == m_outer_radius &&
+			m_bvh_matrix == get_matrix();
+	}
+
+	void torus_object::m_update_bvh() {
+		m_bvh_matrix = get_matrix();
+		m_bvh_inner_radius = m_inner_radius;
+		m_bvh_outer_radius = m_outer_radius;
+
+		float A = (m_outer_radius + m_inner_radius) / 2.0f;
+		float B = (m_outer_radius - m_inner_radius) / 2.0f;
+
+		const float step = 1.0f / static_cast<float>(c_bvh_res);
+		std::vector<patch_bvh::leaf_t> leaves;
+		leaves.reserve(c_bvh_res * c_bvh_res);
+
+		for (int j = 0; j < c_bvh_res; ++j) {
+			for (int i = 0; i < c_bvh_res; ++i) {
+				patch_bvh::leaf_t leaf;
+				leaf.min_param = { i * step, j * step };
+				leaf.max_param = { (i + 1) * step, (j + 1) * step };
+
+				// sample the cell and inflate the box to cover the arcs between samples
+				for (int k = 0; k < 9; ++k) {
+					float u = (leaf.min_param.x + 0.5f * (k % 3) * step) * DPI;
+					float v = (leaf.min_param.y + 0.5f * (k / 3) * step) * DPI;
+
+					auto local = torus_local_point(A, B, u, v);
+					glm::vec3 point = m_bvh_matrix * glm::vec4{ local.x, local.y, local.z, 1.0f };
+
+					if (k == 0) {
+						leaf.bounds = { point, point };
+					} else {
+						leaf.bounds.extend(point);
+					}
+				}
+
+				leaf.bounds.inflate(0.1f * glm::length(leaf.bounds.max - leaf.bounds.min));
+				leaves.push_back(leaf);
+			}
+		}
+
+		// layout of the leaves never changes, only refit after the first build
+		if (m_bvh.empty()) {
+			m_bvh.build(leaves);
+		} else {
+			for (int i = 0; i < static_cast<int>(leaves.size()); ++i) {
+				m_bvh.refit(i, leaves[i].bounds);
+			}
+		}
+	}
 
 	float torus_object::get_min_u() const {
 		return 0.0f;
@@ -331,9 +405,10 @@ namespace mini {
 		float A = (m_outer_radius + m_inner_radius) / 2.0f;
 		float B = (m_outer_radius - m_inner_radius) / 2.0f;
 
-		float grad_x = -B * sin(u) * cos(v);
-		float grad_y = -B * sin(u) * sin(v);
-		float grad_z = B * cos(u);
+		// parameters are scaled by 2pi, so are the derivatives
+		float grad_x = -DPI * B * sin(u) * cos(v);
+		float grad_y = -DPI * B * sin(u) * sin(v);
+		float grad_z = DPI * B * cos(u);
 
 		auto world_matrix = get_matrix();
 		auto world_grad = world_matrix * glm::vec4{ grad_x, grad_y, grad_z, 0.0f };
@@ -348,8 +423,8 @@ namespace mini {
 		float A = (m_outer_radius + m_inner_radius) / 2.0f;
 		float B = (m_outer_radius - m_inner_radius) / 2.0f;
 
-		float grad_x = -sin(v) * (A + B * cos(u));
-		float grad_y = cos(v) * (A + B * cos(u));
+		float grad_x = -DPI * sin(v) * (A + B * cos(u));
+		float grad_y = DPI * cos(v) * (A + B * cos(u));
 		float grad_z = 0.0f;
 
 		auto world_matrix = get_matrix();
@@ -373,4 +448,9 @@ namespace mini {
 	trimmable_surface_domain& torus_object::get_trimmable_domain() {
 		return m_domain;
 	}
+
+	const patch_bvh* torus_object::get_bvh() const {
+		// stale bounds would cull valid pairs, let the caller fall back instead
+		return m_is_bvh_valid() ? &m_bvh : nullptr;
+	}
 }
@@ -0,0 +1,442 @@
+#include <utility>
+#include <algorithm>
+
+#include "trimcurves.hpp"
+
+namespace mini {
+	constexpr float c_boundary_eps = 0.00001f;
+	constexpr float c_join_eps = 0.000001f;
+
+	inline bool on_boundary(const glm::vec2 & p) {
+		return
+			p.x <= c_boundary_eps || p.x >= 1.0f - c_boundary_eps ||
+			p.y <= c_boundary_eps || p.y >= 1.0f - c_boundary_eps;
+	}
+
+	inline bool same_point(const glm::vec2 & a, const glm::vec2 & b) {
+		return glm::distance(a, b) < c_join_eps;
+	}
+
+	// position along the domain boundary, counter clockwise from (0, 0)
+	inline float boundary_param(const glm::vec2 & p) {
+		const float dist[4] = { p.y, 1.0f - p.x, 1.0f - p.y, p.x };
+		const int edge = static_cast<int>(std::min_element(dist, dist + 4) - dist);
+
+		switch (edge) {
+			case 0: return p.x;
+			case 1: return 1.0f + p.y;
+			case 2: return 3.0f - p.x;
+			default: return 4.0f - p.y;
+		}
+	}
+
+	inline glm::vec2 boundary_corner(int corner) {
+		switch (corner % 4) {
+			case 0: return { 0.0f, 0.0f };
+			case 1: return { 1.0f, 0.0f };
+			case 2: return { 1.0f, 1.0f };
+			default: return { 0.0f, 1.0f };
+		}
+	}
+
+	inline int grid_cell(float t, int res) {
+		return glm::clamp(static_cast<int>(floorf(t * res)), 0, res - 1);
+	}
+
+	trim_curves::trim_curves() {
+		m_wrap_u = false;
+		m_wrap_v = false;
+		m_hidden = false;
+
+		m_rebuild();
+	}
+
+	void trim_curves::set_wrapping(bool wrap_u, bool wrap_v) {
+		m_wrap_u = wrap_u;
+		m_wrap_v = wrap_v;
+	}
+
+	void trim_curves::add_curve(const glm::vec2 & start, const std::vector<glm::vec2> & directions) {
+		const bool wrapped[2] = { m_wrap_u, m_wrap_v };
+
+		glm::vec2 current = glm::clamp(start, glm::vec2(0.0f), glm::vec2(1.0f));
+		std::vector<glm::vec2> piece = { current };
+
+		for (const auto & direction : directions) {
+			glm::vec2 remaining = direction;
+
+			// cut the step at every wrapped edge it crosses and continue
+			// on the opposite side of the domain
+			for (int cuts = 0; cuts < 4; ++cuts) {
+				const glm::vec2 next = current + remaining;
+
+				float t = 1.0f;
+				int axis = -1;
+				float side = 0.0f;
+
+				for (int a = 0; a < 2; ++a) {
+					if (!wrapped[a] || (next[a] >= 0.0f && next[a] <= 1.0f)) {
+						continue;
+					}
+
+					float edge = (next[a] > 1.0f) ? 1.0f : 0.0f;
+					float ta = (edge - current[a]) / remaining[a];
+
+					if (ta < t) {
+						t = ta;
+						axis = a;
+						side = edge;
+					}
+				}
+
+				if (axis < 0) {
+					current = glm::clamp(next, glm::vec2(0.0f), glm::vec2(1.0f));
+					piece.push_back(current);
+					break;
+				}
+
+				glm::vec2 hit = current + t * remaining;
+				hit[axis] = side;
+				hit = glm::clamp(hit, glm::vec2(0.0f), glm::vec2(1.0f));
+
+				piece.push_back(hit);
+				m_add_piece(piece);
+
+				current = hit;
+				current[axis] = 1.0f - side;
+				piece = { current };
+
+				remaining = (1.0f - t) * remaining;
+			}
+		}
+
+		m_add_piece(piece);
+		m_rebuild();
+	}
+
+	void trim_curves::clear() {
+		m_curves.clear();
+		m_toggles.clear();
+		m_hidden = false;
+
+		m_rebuild();
+	}
+
+	void trim_curves::flip() {
+		m_hidden = !m_hidden;
+	}
+
+	void trim_curves::toggle_region(const glm::vec2 & uv) {
+		const auto num_loops = static_cast<uint32_t>(m_loop_offsets.size() - 1);
+
+		// a region may consist of several signatures when it continues
+		// across a wrapped edge, join them by sampling along both edges
+		std::vector<signature_t> nodes;
+		std::vector<int> parents;
+
+		const auto find_node = [&nodes, &parents](const signature_t & signature) -> int {
+			for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
+				if (nodes[i] == signature) {
+					return i;
+				}
+			}
+
+			nodes.push_back(signature);
+			parents.push_back(static_cast<int>(parents.size()));
+			return static_cast<int>(nodes.size()) - 1;
+		};
+
+		const auto find_root = [&parents](int node) -> int {
+			while (parents[node] != node) {
+				node = parents[node] = parents[parents[node]];
+			}
+
+			return node;
+		};
+
+		signature_t signature, other;
+		m_signature(uv, signature);
+		int seed = find_node(signature);
+
+		constexpr int c_seam_samples = 256;
+		constexpr float c_seam_eps = 0.0001f;
+
+		for (int k = 0; k < c_seam_samples; ++k) {
+			float t = (k + 0.5f) / static_cast<float>(c_seam_samples);
+
+			if (m_wrap_u) {
+				m_signature({ c_seam_eps, t }, signature);
+				m_signature({ 1.0f - c_seam_eps, t }, other);
+				parents[find_root(find_node(signature))] = find_root(find_node(other));
+			}
+
+			if (m_wrap_v) {
+				m_signature({ t, c_seam_eps }, signature);
+				m_signature({ t, 1.0f - c_seam_eps }, other);
+				parents[find_root(find_node(signature))] = find_root(find_node(other));
+			}
+		}
+
+		const int root = find_root(seed);
+
+		for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
+			if (find_root(i) == root) {
+				m_toggles.push_back({ num_loops, nodes[i] });
+			}
+		}
+	}
+
+	bool trim_curves::empty() const {
+		return m_curves.empty();
+	}
+
+	bool trim_curves::is_visible(const glm::vec2 & uv) const {
+		signature_t signature;
+		m_signature(uv, signature);
+
+		return !m_is_hidden(signature);
+	}
+
+	std::size_t trim_curves::get_num_curves() const {
+		return m_curves.size();
+	}
+
+	const std::vector<glm::vec2> & trim_curves::get_curve(std::size_t index) const {
+		return m_curves[index];
+	}
+
+	void trim_curves::rasterize(trim_mask & mask, uint8_t visible, uint8_t hidden) const {
+		const uint32_t width = mask.get_width();
+		const uint32_t height = mask.get_height();
+
+		std::vector<std::pair<float, uint32_t>> crossings;
+		signature_t signature;
+
+		for (uint32_t ty = 0; ty < height; ++ty) {
+			const float y = (ty + 0.5f) / static_cast<float>(height);
+			const int row = grid_cell(y, c_grid_res);
+
+			// all crossings of the row, each counted in the cell it falls into
+			crossings.clear();
+			signature.assign((m_loop_offsets.size() + 62) / 64, 0);
+
+			for (int col = 0; col < c_grid_res; ++col) {
+				const float x0 = static_cast<float>(col) / c_grid_res;
+				const float x1 = (col + 1 == c_grid_res) ? 2.0f : static_cast<float>(col + 1) / c_grid_res;
+
+				for (auto segment : m_cells[row * c_grid_res + col]) {
+					const auto loop = m_segment_loops[segment];
+					const auto next = (segment + 1 == m_loop_offsets[loop + 1]) ? m_loop_offsets[loop] : segment + 1;
+
+					const auto & a = m_loop_points[segment];
+					const auto & b = m_loop_points[next];
+
+					if ((a.y > y) == (b.y > y)) {
+						continue;
+					}
+
+					const float x = a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+					if (x >= x0 && x < x1) {
+						crossings.push_back({ x, loop });
+						signature[loop / 64] ^= (1ULL << (loop % 64));
+					}
+				}
+			}
+
+			std::sort(crossings.begin(), crossings.end());
+
+			// sweep to the right, crossings left of the texel stop counting
+			auto crossing = crossings.begin();
+			bool changed = true;
+			uint8_t value = visible;
+
+			for (uint32_t tx = 0; tx < width; ++tx) {
+				const float x = (tx + 0.5f) / static_cast<float>(width);
+
+				for (; crossing != crossings.end() && crossing->first <= x; ++crossing) {
+					signature[crossing->second / 64] ^= (1ULL << (crossing->second % 64));
+					changed = true;
+				}
+
+				if (changed) {
+					value = m_is_hidden(signature) ? hidden : visible;
+					changed = false;
+				}
+
+				mask.set(tx, ty, value);
+			}
+		}
+	}
+
+	void trim_curves::m_add_piece(std::vector<glm::vec2> & piece) {
+		if (piece.size() < 2) {
+			return;
+		}
+
+		// join with curves that end at the same interior point, this connects
+		// the forward and backward halves traced from a common start
+		for (bool joined = true; joined; ) {
+			joined = false;
+
+			if (same_point(piece.front(), piece.back())) {
+				break;
+			}
+
+			for (auto iter = m_curves.begin(); iter != m_curves.end(); ++iter) {
+				auto & curve = *iter;
+
+				if (same_point(curve.front(), curve.back())) {
+					continue;
+				}
+
+				std::vector<glm::vec2> merged;
+
+				if (!on_boundary(piece.front()) && same_point(piece.front(), curve.front())) {
+					merged.assign(curve.rbegin(), curve.rend());
+					merged.insert(merged.end(), piece.begin() + 1, piece.end());
+				} else if (!on_boundary(piece.front()) && same_point(piece.front(), curve.back())) {
+					merged = curve;
+					merged.insert(merged.end(), piece.begin() + 1, piece.end());
+				} else if (!on_boundary(piece.back()) && same_point(piece.back(), curve.front())) {
+					merged = piece;
+					merged.insert(merged.end(), curve.begin() + 1, curve.end());
+				} else if (!on_boundary(piece.back()) && same_point(piece.back(), curve.back())) {
+					merged = piece;
+					merged.insert(merged.end(), curve.rbegin() + 1, curve.rend());
+				} else {
+					continue;
+				}
+
+				m_curves.erase(iter);
+				piece = std::move(merged);
+				joined = true;
+				break;
+			}
+		}
+
+		m_curves.push_back(piece);
+	}
+
+	void trim_curves::m_rebuild() {
+		m_loop_points.clear();
+		m_loop_offsets.assign(1, 0);
+		m_segment_loops.clear();
+
+		m_cells.clear();
+		m_cells.resize(c_grid_res * c_grid_res);
+
+		for (const auto & curve : m_curves) {
+			m_close_loop(curve);
+		}
+
+		// bucket segments into every cell their bounds overlap
+		for (uint32_t loop = 0; loop + 1 < m_loop_offsets.size(); ++loop) {
+			const auto begin = m_loop_offsets[loop];
+			const auto end = m_loop_offsets[loop + 1];
+
+			for (auto segment = begin; segment < end; ++segment) {
+				const auto next = (segment + 1 == end) ? begin : segment + 1;
+
+				const auto & a = m_loop_points[segment];
+				const auto & b = m_loop_points[next];
+
+				const int x0 = grid_cell(std::min(a.x, b.x) - c_join_eps, c_grid_res);
+				const int x1 = grid_cell(std::max(a.x, b.x) + c_join_eps, c_grid_res);
+				const int y0 = grid_cell(std::min(a.y, b.y) - c_join_eps, c_grid_res);
+				const int y1 = grid_cell(std::max(a.y, b.y) + c_join_eps, c_grid_res);
+
+				for (int y = y0; y <= y1; ++y) {
+					for (int x = x0; x <= x1; ++x) {
+						m_cells[y * c_grid_res + x].push_back(segment);
+					}
+				}
+			}
+		}
+	}
+
+	void trim_curves::m_close_loop(const std::vector<glm::vec2> & curve) {
+		std::vector<glm::vec2> loop = curve;
+
+		if (same_point(loop.front(), loop.back())) {
+			loop.pop_back();
+		} else if (on_boundary(loop.front()) && on_boundary(loop.back())) {
+			// walk counter clockwise along the boundary back to the start,
+			// any closure along the boundary splits the interior the same way
+			float from = boundary_param(loop.back());
+			float to = boundary_param(loop.front());
+
+			if (to < from) {
+				to = to + 4.0f;
+			}
+
+			for (int corner = static_cast<int>(floorf(from)) + 1; corner < to; ++corner) {
+				loop.push_back(boundary_corner(corner));
+			}
+		}
+
+		// curves that stop inside the domain are implicitly closed
+		// with a straight segment between their ends
+		if (loop.size() < 2) {
+			return;
+		}
+
+		m_loop_points.insert(m_loop_points.end(), loop.begin(), loop.end());
+		m_loop_offsets.push_back(static_cast<uint32_t>(m_loop_points.size()));
+		m_segment_loops.resize(m_loop_points.size(), static_cast<uint32_t>(m_loop_offsets.size() - 2));
+	}
+
+	void trim_curves::m_signature(const glm::vec2 & uv, signature_t & signature) const {
+		signature.assign((m_loop_offsets.size() + 62) / 64, 0);
+
+		// parity of crossings of the ray going from uv towards u = 1,
+		// only the cells of one row are visited
+		const float y = uv.y;
+		const int row = grid_cell(y, c_grid_res);
+
+		for (int col = grid_cell(uv.x, c_grid_res); col < c_grid_res; ++col) {
+			const float x0 = static_cast<float>(col) / c_grid_res;
+			const float x1 = (col + 1 == c_grid_res) ? 2.0f : static_cast<float>(col + 1) / c_grid_res;
+
+			for (auto segment : m_cells[row * c_grid_res + col]) {
+				const auto loop = m_segment_loops[segment];
+				const auto next = (segment + 1 == m_loop_offsets[loop + 1]) ? m_loop_offsets[loop] : segment + 1;
+
+				const auto & a = m_loop_points[segment];
+				const auto & b = m_loop_points[next];
+
+				if ((a.y > y) == (b.y > y)) {
+					continue;
+				}
+
+				const float x = a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+				if (x > uv.x && x >= x0 && x < x1) {
+					signature[loop / 64] ^= (1ULL << (loop % 64));
+				}
+			}
+		}
+	}
+
+	bool trim_curves::m_is_hidden(const signature_t & signature) const {
+		bool hidden = m_hidden;
+
+		// toggles only know the loops that existed when they were made,
+		// regions split by later curves inherit the state of the whole
+		for (const auto & toggle : m_toggles) {
+			const uint32_t full = toggle.num_loops / 64;
+			const uint32_t rest = toggle.num_loops % 64;
+
+			bool match = std::equal(toggle.signature.begin(), toggle.signature.begin() + full, signature.begin());
+
+			if (match && rest) {
+				const uint64_t mask = (1ULL << rest) - 1;
+				match = (toggle.signature[full] & mask) == (signature[full] & mask);
+			}
+
+			if (match) {
+				hidden = !hidden;
+			}
+		}
+
+		return hidden;
+	}
+}
\ No newline at end of file
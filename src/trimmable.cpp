@@ -12,11 +12,18 @@ namespace mini {
 		float min_u,
 		float min_v,
 		float max_u,
-		float max_v) {
+		float max_v) :
+		m_domain(domain_width, domain_height, VISIBLE) {
 
 		m_domain_width = domain_width;
 		m_domain_height = domain_height;
 
+		m_wrap_u = false;
+		m_wrap_v = false;
+
+		m_vector_mode = false;
+		m_raster_outdated = false;
+
 		m_texture = 0;
 		m_init_texture();
 	}
@@ -26,46 +33,119 @@ namespace mini {
 	}
 
 	void trimmable_surface_domain::trim_curve(const std::vector<glm::vec2>& curve_points) {
+		if (curve_points.empty()) {
+			return;
+		}
+
+		std::vector<glm::vec2> directions;
+		directions.reserve(curve_points.size());
+
 		for (int i = 0; i < curve_points.size() - 1; ++i) {
-			const auto& p1 = curve_points[i + 0];
-			const auto& p2 = curve_points[i + 1];
+			directions.push_back(curve_points[i + 1] - curve_points[i]);
+		}
 
-			uint32_t x0 = static_cast<uint32_t>(p1.x * m_domain_width);
-			uint32_t y0 = static_cast<uint32_t>(p1.y * m_domain_height);
-			uint32_t x1 = static_cast<uint32_t>(p2.x * m_domain_width);
-			uint32_t y1 = static_cast<uint32_t>(p2.y * m_domain_height);
+		m_curves.add_curve(curve_points.front(), directions);
+
+		if (m_vector_mode) {
+			m_raster_outdated = true;
+			return;
+		}
 
-			m_draw_line(x0, y0, x1, y1, CURVE);
+		for (int i = 0; i < curve_points.size() - 1; ++i) {
+			m_draw_uv_line(curve_points[i + 0], curve_points[i + 1], CURVE);
 		}
 	}
 
 	void trimmable_surface_domain::trim_directions(const glm::vec2& start, const std::vector<glm::vec2>& directions) {
+		m_curves.add_curve(start, directions);
+
+		if (m_vector_mode) {
+			m_raster_outdated = true;
+			return;
+		}
+
 		auto p1 = start;
 		for (const auto& direction : directions) {
 			auto p2 = p1 + direction;
 
-			uint32_t x0 = static_cast<uint32_t>(p1.x * m_domain_width);
-			uint32_t y0 = static_cast<uint32_t>(p1.y * m_domain_height);
-			uint32_t x1 = static_cast<uint32_t>(p2.x * m_domain_width);
-			uint32_t y1 = static_cast<uint32_t>(p2.y * m_domain_height);
-
-			m_draw_line(x0, y0, x1, y1, CURVE);
+			m_draw_uv_line(p1, p2, CURVE);
 			p1 = p2;
 		}
 	}
 
 	void trimmable_surface_domain::update_texture() {
-		if (m_texture) {
-			glBindTexture(GL_TEXTURE_2D, m_texture);
-			glTexSubImage2D(
-				GL_TEXTURE_2D,
-				0, 0, 0, m_domain_width, m_domain_height,
-				GL_RGB,
-				GL_UNSIGNED_BYTE,
-				m_domain.data());
+		if (m_raster_outdated) {
+			m_rasterize_curves();
+		}
+
+		if (!m_texture || !m_domain.is_dirty()) {
+			return;
+		}
+
+		glBindTexture(GL_TEXTURE_2D, m_texture);
+
+		// tiles are uploaded straight from the tiled storage
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, trim_mask::tile_size);
+
+		for (uint32_t ty = 0; ty < m_domain.get_tiles_y(); ++ty) {
+			for (uint32_t tx = 0; tx < m_domain.get_tiles_x(); ++tx) {
+				if (!m_domain.is_tile_dirty(tx, ty)) {
+					continue;
+				}
+
+				uint32_t x = tx * trim_mask::tile_size;
+				uint32_t y = ty * trim_mask::tile_size;
+				uint32_t width = glm::min(trim_mask::tile_size, m_domain_width - x);
+				uint32_t height = glm::min(trim_mask::tile_size, m_domain_height - y);
+
+				glTexSubImage2D(
+					GL_TEXTURE_2D,
+					0, x, y, width, height,
+					GL_RED,
+					GL_UNSIGNED_BYTE,
+					m_domain.get_tile(tx, ty));
+			}
+		}
+
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		m_domain.clear_dirty();
+	}
+
+	void trimmable_surface_domain::set_wrapping(bool wrap_u, bool wrap_v) {
+		m_wrap_u = wrap_u;
+		m_wrap_v = wrap_v;
 
-			glBindTexture(GL_TEXTURE_2D, 0);
+		m_curves.set_wrapping(wrap_u, wrap_v);
+	}
+
+	bool trimmable_surface_domain::is_vector_mode() const {
+		return m_vector_mode;
+	}
+
+	void trimmable_surface_domain::set_vector_mode(bool vector_mode) {
+		// switching to vector mode regenerates the mask from the curves,
+		// regions filled in raster mode are not carried over
+		if (vector_mode && !m_vector_mode) {
+			m_raster_outdated = true;
 		}
+
+		m_vector_mode = vector_mode;
+	}
+
+	bool trimmable_surface_domain::is_visible(float u, float v) const {
+		if (m_vector_mode) {
+			return m_curves.is_visible({ u, v });
+		}
+
+		return m_domain.sample(u, v, m_wrap_u, m_wrap_v) != HIDDEN;
+	}
+
+	const trim_curves & trimmable_surface_domain::get_curves() const {
+		return m_curves;
 	}
 
 	void trimmable_surface_domain::bind(uint32_t slot) const {
@@ -75,6 +155,10 @@ namespace mini {
 		}
 	}
 
+	GLuint trimmable_surface_domain::get_texture_handle() const {
+		return m_texture;
+	}
+
 	void trimmable_surface_domain::configure() {
 		if (ImGui::CollapsingHeader("Surface Trimming")) {
 			auto min = ImGui::GetWindowContentRegionMin();
@@ -95,25 +179,37 @@ namespace mini {
 				int32_t pixel_pos_x = pos_x * m_domain_width;
 				int32_t pixel_pos_y = pos_y * m_domain_height;
 
-				m_flood_fill(pixel_pos_x, pixel_pos_y);
+				if (m_vector_mode) {
+					m_curves.toggle_region({ pos_x, pos_y });
+					m_raster_outdated = true;
+				} else {
+					m_flood_fill(pixel_pos_x, pixel_pos_y);
+				}
 
 				update_texture();
 			}
 
+			bool vector_mode = m_vector_mode;
+			gui::prefix_label("Vector Trimming: ", 250.0f);
+			if (ImGui::Checkbox("##trim_vector_mode", &vector_mode)) {
+				set_vector_mode(vector_mode);
+				update_texture();
+			}
+
 			if (ImGui::Button("Flip Domain", ImVec2(ImGui::GetWindowWidth() * 0.95f, 24.0f))) {
-				for (auto& el : m_domain) {
-					if (el == VISIBLE) {
-						el = HIDDEN;
-					} else if (el == HIDDEN) {
-						el = VISIBLE;
-					}
+				if (m_vector_mode) {
+					m_curves.flip();
+					m_raster_outdated = true;
+				} else {
+					m_domain.swap_values(VISIBLE, HIDDEN);
 				}
 
 				update_texture();
 			}
 
 			if (ImGui::Button("Reset Domain", ImVec2(ImGui::GetWindowWidth() * 0.95f, 24.0f))) {
-				std::fill(m_domain.begin(), m_domain.end(), VISIBLE);
+				m_curves.clear();
+				m_domain.fill(VISIBLE);
 				update_texture();
 			}
 
@@ -124,30 +220,12 @@ namespace mini {
 	uint8_t trimmable_surface_domain::at(int32_t x, int32_t y) const {
 		auto ry = y % m_domain_height;
 		auto rx = x % m_domain_width;
-		auto base = 3 * (ry * m_domain_width + rx);
 
-		return m_domain[base];
+		return m_domain.get(rx, ry);
 	}
 
-	void trimmable_surface_domain::m_draw_line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint8_t color) {
-		int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
-		int dy = abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
-		int err = (dx > dy ? dx : -dy) / 2, e2;
-
-		for (;;) {
-			auto ry = y0 % m_domain_height;
-			auto rx = x0 % m_domain_width;
-			auto base = 3 * (ry * m_domain_width + rx);
-
-			m_domain[base + 0] = color;
-			m_domain[base + 1] = color;
-			m_domain[base + 2] = color;
-
-			if (x0 == x1 && y0 == y1) break;
-			e2 = err;
-			if (e2 > -dx) { err -= dy; x0 += sx; }
-			if (e2 < dy) { err += dx; y0 += sy; }
-		}
+	void trimmable_surface_domain::m_draw_uv_line(const glm::vec2 & a, const glm::vec2 & b, uint8_t color) {
+		m_domain.draw_uv_line(a.x, a.y, b.x, b.y, color, m_wrap_u, m_wrap_v);
 	}
 
 	void trimmable_surface_domain::m_flood_fill(int32_t x, int32_t y) {
@@ -157,50 +235,24 @@ namespace mini {
 		}
 
 		auto inv = (color == VISIBLE) ? HIDDEN : VISIBLE;
-	
-		std::vector<bool> visited;
-		visited.resize(m_domain_width * m_domain_height);
-		std::fill(visited.begin(), visited.end(), false);
-
-		std::vector<std::pair<int32_t, int32_t>> stack;
-		stack.reserve(m_domain_width * m_domain_height);
-
-		stack.push_back({x, y});
-
-		while (!stack.empty()) {
-			auto curr = stack.back();
-			stack.pop_back();
-
-			auto x = curr.first;
-			auto y = curr.second;
-
-			auto base = 3 * (y * m_domain_width + x);
-			m_domain[base + 0] = inv;
-			m_domain[base + 1] = inv;
-			m_domain[base + 2] = inv;
-
-			if (x >= 1 && at(x - 1, y) == color) {
-				stack.push_back({ x - 1, y });
-			}
+		m_domain.flood_fill(x % m_domain_width, y % m_domain_height, inv, m_wrap_u, m_wrap_v);
+	}
 
-			if (y >= 1 && at(x, y - 1) == color) {
-				stack.push_back({ x, y - 1 });
-			}
+	void trimmable_surface_domain::m_rasterize_curves() {
+		m_curves.rasterize(m_domain, VISIBLE, HIDDEN);
 
-			if (x < m_domain_width - 1 && at(x + 1, y) == color) {
-				stack.push_back({ x + 1, y });
-			}
+		for (std::size_t i = 0; i < m_curves.get_num_curves(); ++i) {
+			const auto & curve = m_curves.get_curve(i);
 
-			if (y < m_domain_height - 1 && at(x, y + 1) == color) {
-				stack.push_back({ x, y + 1 });
+			for (std::size_t j = 0; j + 1 < curve.size(); ++j) {
+				m_draw_uv_line(curve[j], curve[j + 1], CURVE);
 			}
 		}
+
+		m_raster_outdated = false;
 	}
 
 	void trimmable_surface_domain::m_init_texture() {
-		m_domain.resize(m_domain_width * m_domain_height * 3);
-		std::fill(m_domain.begin(), m_domain.end(), VISIBLE);
-
 		if (m_texture) {
 			m_free_texture();
 		}
@@ -213,8 +265,16 @@ namespace mini {
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_domain_width, m_domain_height, 0, GL_RGB, GL_UNSIGNED_BYTE, m_domain.data());
+		// single channel storage, the swizzle keeps the preview gray
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
+
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, m_domain_width, m_domain_height, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
 		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// contents are uploaded tile by tile
+		m_domain.mark_all_dirty();
+		update_texture();
 	}
 
 	void trimmable_surface_domain::m_free_texture() {
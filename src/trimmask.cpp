@@ -0,0 +1,247 @@
+#include <cmath>
+#include <utility>
+#include <algorithm>
+
+#include "trimmask.hpp"
+
+namespace mini {
+	static uint32_t wrap_texel(int32_t texel, uint32_t size) {
+		const int32_t count = static_cast<int32_t>(size);
+		const int32_t wrapped = texel % count;
+
+		return static_cast<uint32_t>(wrapped < 0 ? wrapped + count : wrapped);
+	}
+
+	trim_mask::trim_mask(uint32_t width, uint32_t height, uint8_t value) {
+		m_width = width;
+		m_height = height;
+
+		m_tiles_x = (width + tile_size - 1) >> tile_shift;
+		m_tiles_y = (height + tile_size - 1) >> tile_shift;
+
+		m_data.resize(static_cast<std::size_t>(m_tiles_x) * m_tiles_y * tile_area, value);
+		m_dirty.resize(m_tiles_x * m_tiles_y, 1);
+		m_any_dirty = true;
+	}
+
+	uint32_t trim_mask::get_width() const {
+		return m_width;
+	}
+
+	uint32_t trim_mask::get_height() const {
+		return m_height;
+	}
+
+	uint32_t trim_mask::get_tiles_x() const {
+		return m_tiles_x;
+	}
+
+	uint32_t trim_mask::get_tiles_y() const {
+		return m_tiles_y;
+	}
+
+	uint8_t trim_mask::get(uint32_t x, uint32_t y) const {
+		return m_data[m_offset(x, y)];
+	}
+
+	void trim_mask::set(uint32_t x, uint32_t y, uint8_t value) {
+		auto & texel = m_data[m_offset(x, y)];
+
+		if (texel != value) {
+			texel = value;
+			m_mark_dirty(x, y);
+		}
+	}
+
+	void trim_mask::fill(uint8_t value) {
+		std::fill(m_data.begin(), m_data.end(), value);
+		mark_all_dirty();
+	}
+
+	void trim_mask::swap_values(uint8_t a, uint8_t b) {
+		for (auto & texel : m_data) {
+			if (texel == a) {
+				texel = b;
+			} else if (texel == b) {
+				texel = a;
+			}
+		}
+
+		mark_all_dirty();
+	}
+
+	std::size_t trim_mask::flood_fill(uint32_t x, uint32_t y, uint8_t value, bool wrap_x, bool wrap_y) {
+		const uint8_t target = get(x, y);
+		if (target == value) {
+			return 0;
+		}
+
+		// the stack holds one seed per run of target texels found next to
+		// a filled span, so it grows with the region outline, not its area
+		std::vector<std::pair<uint32_t, uint32_t>> stack;
+		stack.reserve(256);
+		stack.push_back({ x, y });
+
+		std::size_t filled = 0;
+
+		while (!stack.empty()) {
+			auto seed = stack.back();
+			stack.pop_back();
+
+			uint32_t sy = seed.second;
+			if (get(seed.first, sy) != target) {
+				continue;
+			}
+
+			// walk left to the start of the span
+			uint32_t sx = seed.first;
+			for (uint32_t steps = 1; steps < m_width; ++steps) {
+				if (sx == 0 && !wrap_x) {
+					break;
+				}
+
+				uint32_t prev = (sx == 0) ? m_width - 1 : sx - 1;
+				if (get(prev, sy) != target) {
+					break;
+				}
+
+				sx = prev;
+			}
+
+			// rows above and below, missing when the edge does not wrap
+			const bool has_up = sy > 0 || wrap_y;
+			const bool has_down = sy + 1 < m_height || wrap_y;
+			const uint32_t up = (sy == 0) ? m_height - 1 : sy - 1;
+			const uint32_t down = (sy + 1 == m_height) ? 0 : sy + 1;
+
+			bool up_run = false, down_run = false;
+
+			// fill to the right, seeding every new run in the neighbouring rows
+			for (uint32_t length = 0, cx = sx; length < m_width; ++length) {
+				if (get(cx, sy) != target) {
+					break;
+				}
+
+				set(cx, sy, value);
+				++filled;
+
+				if (has_up) {
+					bool inside = get(cx, up) == target;
+					if (inside && !up_run) {
+						stack.push_back({ cx, up });
+					}
+
+					up_run = inside;
+				}
+
+				if (has_down) {
+					bool inside = get(cx, down) == target;
+					if (inside && !down_run) {
+						stack.push_back({ cx, down });
+					}
+
+					down_run = inside;
+				}
+
+				if (++cx == m_width) {
+					if (!wrap_x) {
+						break;
+					}
+
+					cx = 0;
+				}
+			}
+		}
+
+		return filled;
+	}
+
+	uint8_t trim_mask::sample(float u, float v, bool wrap_x, bool wrap_y) const {
+		const uint32_t x = wrap_texel(m_to_texel(u, m_width, wrap_x), m_width);
+		const uint32_t y = wrap_texel(m_to_texel(v, m_height, wrap_y), m_height);
+
+		return get(x, y);
+	}
+
+	void trim_mask::draw_uv_line(float u0, float v0, float u1, float v1, uint8_t value, bool wrap_x, bool wrap_y) {
+		if (wrap_x) {
+			u1 -= std::round(u1 - u0);
+		}
+
+		if (wrap_y) {
+			v1 -= std::round(v1 - v0);
+		}
+
+		m_draw_line(
+			m_to_texel(u0, m_width, wrap_x),
+			m_to_texel(v0, m_height, wrap_y),
+			m_to_texel(u1, m_width, wrap_x),
+			m_to_texel(v1, m_height, wrap_y),
+			value);
+	}
+
+	const uint8_t * trim_mask::get_tile(uint32_t tx, uint32_t ty) const {
+		return m_data.data() + static_cast<std::size_t>(ty * m_tiles_x + tx) * tile_area;
+	}
+
+	bool trim_mask::is_dirty() const {
+		return m_any_dirty;
+	}
+
+	bool trim_mask::is_tile_dirty(uint32_t tx, uint32_t ty) const {
+		return m_dirty[ty * m_tiles_x + tx] != 0;
+	}
+
+	void trim_mask::mark_all_dirty() {
+		std::fill(m_dirty.begin(), m_dirty.end(), 1);
+		m_any_dirty = true;
+	}
+
+	void trim_mask::clear_dirty() {
+		std::fill(m_dirty.begin(), m_dirty.end(), 0);
+		m_any_dirty = false;
+	}
+
+	std::size_t trim_mask::m_offset(uint32_t x, uint32_t y) const {
+		const uint32_t tile = (y >> tile_shift) * m_tiles_x + (x >> tile_shift);
+		const uint32_t local = ((y & (tile_size - 1)) << tile_shift) + (x & (tile_size - 1));
+
+		return static_cast<std::size_t>(tile) * tile_area + local;
+	}
+
+	void trim_mask::m_mark_dirty(uint32_t x, uint32_t y) {
+		m_dirty[(y >> tile_shift) * m_tiles_x + (x >> tile_shift)] = 1;
+		m_any_dirty = true;
+	}
+
+	int32_t trim_mask::m_to_texel(float t, uint32_t size, bool wrap) const {
+		const auto texel = static_cast<int32_t>(std::floor(t * static_cast<float>(size)));
+		return wrap ? texel : std::clamp(texel, 0, static_cast<int32_t>(size) - 1);
+	}
+
+	void trim_mask::m_draw_line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint8_t value) {
+		const int32_t dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+		const int32_t dy = std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+		int32_t err = (dx > dy ? dx : -dy) / 2;
+
+		for (;;) {
+			set(wrap_texel(x0, m_width), wrap_texel(y0, m_height), value);
+
+			if (x0 == x1 && y0 == y1) {
+				break;
+			}
+
+			const int32_t e2 = err;
+
+			if (e2 > -dx) {
+				err -= dy;
+				x0 += sx;
+			}
+
+			if (e2 < dy) {
+				err += dx;
+				y0 += sy;
+			}
+		}
+	}
+}
@@ -2,6 +2,7 @@
 #include <iostream>
 
 #include "window.hpp"
+#include "profiler.hpp"
 
 // use imgui library
 #include <imgui.h>
@@ -140,17 +141,35 @@ namespace mini {
 
 			m_last_frame = now;
 
+			auto & profiler = frame_profiler::get_instance ();
+			profiler.begin_frame ();
+
 			ImGui_ImplOpenGL3_NewFrame ();
 			ImGui_ImplGlfw_NewFrame ();
 			ImGui::NewFrame ();
 
-			t_integrate (elapsed);
-			t_render ();
+			{
+				profile_scope scope ("t_integrate");
+				t_integrate (elapsed);
+			}
+
+			{
+				profile_scope scope ("t_render", true);
+				t_render ();
+			}
+
+			{
+				profile_scope scope ("imgui", true);
+				ImGui::Render ();
+				ImGui_ImplOpenGL3_RenderDrawData (ImGui::GetDrawData ());
+			}
 
-			ImGui::Render ();
-			ImGui_ImplOpenGL3_RenderDrawData (ImGui::GetDrawData ());
+			{
+				profile_scope scope ("swap");
+				glfwSwapBuffers (m_window.get ());
+			}
 
-			glfwSwapBuffers (m_window.get ());
+			profiler.end_frame ();
 		}
 	}
 